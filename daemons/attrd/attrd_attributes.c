@@ -9,9 +9,13 @@
 
 #include <crm_internal.h>
 
+#include <ctype.h>
 #include <errno.h>
+#include <inttypes.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <glib.h>
 
 #include <crm/common/logging.h>
@@ -20,6 +24,60 @@
 
 #include "pacemaker-attrd.h"
 
+/* Names of failure-related attributes (fail counts and last failure times),
+ * indexed by resource ID. Each value is a table used as a set of attribute
+ * names, which belong to the attributes themselves. Attributes are never
+ * removed from the attributes table, so nothing is ever removed from this.
+ */
+static GHashTable *failure_attrs = NULL;
+
+/*!
+ * \internal
+ * \brief Add an attribute to the failure attribute index if appropriate
+ *
+ * \param[in] name  Attribute name (must remain valid as long as the index)
+ */
+static void
+index_failure_attribute(const char *name)
+{
+    const char *rsc = NULL;
+    const char *end = NULL;
+    char *rsc_id = NULL;
+    GHashTable *names = NULL;
+
+    // Failure attribute names look like PREFIX-RSC#OP_INTERVAL
+    if (g_str_has_prefix(name, PCMK__FAIL_COUNT_PREFIX "-")) {
+        rsc = name + sizeof(PCMK__FAIL_COUNT_PREFIX "-") - 1;
+
+    } else if (g_str_has_prefix(name, PCMK__LAST_FAILURE_PREFIX "-")) {
+        rsc = name + sizeof(PCMK__LAST_FAILURE_PREFIX "-") - 1;
+
+    } else {
+        return;
+    }
+
+    end = strchr(rsc, '#');
+    if ((end == NULL) || (end == rsc)) {
+        return;
+    }
+
+    if (failure_attrs == NULL) {
+        failure_attrs = pcmk__strkey_table(free,
+                                           (GDestroyNotify)
+                                           g_hash_table_destroy);
+    }
+
+    rsc_id = g_strndup(rsc, end - rsc);
+    names = g_hash_table_lookup(failure_attrs, rsc_id);
+    if (names == NULL) {
+        names = pcmk__strkey_table(NULL, NULL);
+        g_hash_table_insert(failure_attrs, pcmk__str_copy(rsc_id), names);
+    }
+    g_free(rsc_id);
+
+    g_hash_table_add(names, (gpointer) name);
+}
+
 static attribute_t *
 attrd_create_attribute(xmlNode *xml)
 {
@@ -75,6 +133,7 @@ attrd_create_attribute(xmlNode *xml)
                 pcmk__s(a->user, "default"));
 
     g_hash_table_replace(attributes, a->id, a);
+    index_failure_attribute(a->id);
     return a;
 }
 
@@ -163,16 +222,124 @@ attrd_add_value_xml(xmlNode *parent, const attribute_t *a,
     return xml;
 }
 
+// 64-bit FNV-1a parameters
+#define FNV_OFFSET_BASIS    UINT64_C(14695981039346656037)
+#define FNV_PRIME           UINT64_C(1099511628211)
+
+/*!
+ * \internal
+ * \brief Add a string to a case-insensitive FNV-1a hash
+ *
+ * \param[in] hash  Hash so far
+ * \param[in] s     String to add (including its terminator), or \c NULL
+ *
+ * \return Updated hash
+ */
+static uint64_t
+hash_string(uint64_t hash, const char *s)
+{
+    if (s == NULL) {
+        // Distinct from any string, including an empty one
+        return (hash ^ UINT64_C(0xff)) * FNV_PRIME;
+    }
+
+    do {
+        hash ^= (uint64_t) tolower((unsigned char) *s);
+        hash *= FNV_PRIME;
+    } while (*s++ != '\0');
+
+    return hash;
+}
+
+/*!
+ * \internal
+ * \brief Add an integer to an FNV-1a hash
+ *
+ * \param[in] hash   Hash so far
+ * \param[in] value  Integer to add
+ *
+ * \return Updated hash
+ */
+static uint64_t
+hash_int(uint64_t hash, long long value)
+{
+    for (int i = 0; i < 8; i++) {
+        hash ^= (uint64_t) value & UINT64_C(0xff);
+        hash *= FNV_PRIME;
+        value >>= 8;
+    }
+    return hash;
+}
+
+/*!
+ * \internal
+ * \brief Calculate a digest of an attribute for sync summaries
+ *
+ * The digest covers everything a full sync would send for the attribute: its
+ * set type, set ID, user, dampening, and private flag, and for each set value,
+ * the node name and XML ID, the value, and whether the node is remote. It does
+ * not depend on the order of values in the table, and it compares node names
+ * and values case-insensitively, as updates do.
+ *
+ * \param[in] a  Attribute to digest
+ *
+ * \return Newly allocated digest, or \c NULL if \p a has no values set
+ * \note The caller is responsible for freeing the result using \c free().
+ */
+char *
+attrd_attribute_digest(const attribute_t *a)
+{
+    GHashTableIter iter;
+    attribute_value_t *v = NULL;
+    uint64_t settings = FNV_OFFSET_BASIS;
+    uint64_t sum = 0;
+    bool any = false;
+
+    g_hash_table_iter_init(&iter, a->values);
+    while (g_hash_table_iter_next(&iter, NULL, (void **) &v)) {
+        uint64_t hash = FNV_OFFSET_BASIS;
+
+        if (v->current == NULL) {
+            continue;
+        }
+
+        hash = hash_string(hash, v->nodename);
+        hash = hash_string(hash, attrd_get_node_xml_id(v->nodename));
+        hash = hash_string(hash, v->current);
+        hash = hash_int(hash, pcmk__is_set(v->flags, attrd_value_remote));
+        sum += hash;
+        any = true;
+    }
+
+    if (!any) {
+        return NULL;
+    }
+
+    // Dampening is synced in seconds, so compare it that way
+    settings = hash_string(settings, a->set_type);
+    settings = hash_string(settings, a->set_id);
+    settings = hash_string(settings, a->user);
+    settings = hash_int(settings, pcmk__timeout_ms2s(a->timeout_ms));
+    settings = hash_int(settings,
+                        pcmk__is_set(a->flags, attrd_attr_is_private));
+
+    return pcmk__assert_asprintf("%016" PRIx64 "%016" PRIx64, settings, sum);
+}
+
 void
-attrd_clear_value_seen(void)
+attrd_clear_value_seen(GHashTable *names)
 {
     GHashTableIter aIter;
     GHashTableIter vIter;
+    const char *name = NULL;
     attribute_t *a;
     attribute_value_t *v = NULL;
 
     g_hash_table_iter_init(&aIter, attributes);
-    while (g_hash_table_iter_next(&aIter, NULL, (void **) &a)) {
+    while (g_hash_table_iter_next(&aIter, (gpointer *) &name, (void **) &a)) {
+        if ((names != NULL) && !g_hash_table_contains(names, name)) {
+            continue;
+        }
         g_hash_table_iter_init(&vIter, a->values);
         while (g_hash_table_iter_next(&vIter, NULL, (void **) &v)) {
             attrd_clear_value_flags(v, attrd_value_from_peer);
@@ -281,3 +448,47 @@ attrd_nvpair_id(const attribute_t *attr, const char *node_state_id)
     pcmk__xml_sanitize_id(nvpair_id);
     return nvpair_id;
 }
+
+/*!
+ * \internal
+ * \brief Get the names of failure-related attributes for a resource
+ *
+ * \param[in] rsc  ID of resource whose fail count and last failure attributes
+ *                 should be listed (or \c NULL for all resources)
+ *
+ * \return List of attribute names
+ * \note The caller should free the result with \c g_list_free() but not free
+ *       the names, which belong to the attributes.
+ */
+GList *
+attrd_failure_attributes(const char *rsc)
+{
+    GList *result = NULL;
+    GHashTable *names = NULL;
+    GHashTableIter iter;
+
+    if (failure_attrs == NULL) {
+        return NULL;
+    }
+
+    if (rsc != NULL) {
+        names = g_hash_table_lookup(failure_attrs, rsc);
+        return (names == NULL)? NULL : g_hash_table_get_keys(names);
+    }
+
+    g_hash_table_iter_init(&iter, failure_attrs);
+    while (g_hash_table_iter_next(&iter, NULL, (gpointer *) &names)) {
+        result = g_list_concat(g_hash_table_get_keys(names), result);
+    }
+    return result;
+}
+
+/*!
+ * \internal
+ * \brief Free the failure attribute index
+ */
+void
+attrd_free_failure_index(void)
+{
+    g_clear_pointer(&failure_attrs, g_hash_table_destroy);
+}
@@ -22,9 +22,28 @@
 
 #include "pacemaker-attrd.h"
 
+// Maximum values in a CIB transaction (unless one attribute has more)
+#define ATTRD_BATCH_MAX_UPDATES 500
+
+/* Attribute writes that become due in the same main loop iteration are
+ * gathered into one CIB transaction, so that the CIB manager and controller
+ * see a single change rather than one per attribute.
+ */
+typedef struct {
+    char *user;         // ACL user to commit the transaction as
+    int updates;        // Number of values added to the transaction
+    GHashTable *values; // Key: attribute name, value: table of values written
+} attrd_batch_t;
+
 static int last_cib_op_done = 0;
 
+// CIB transaction being built, if any
+static attrd_batch_t *batch = NULL;
+static crm_trigger_t *batch_trigger = NULL;
+
 static void write_attribute(attribute_t *a, bool ignore_delay);
+static gboolean batch_trigger_cb(void *user_data);
+static void batch_free(void *data);
 
 static void
 attrd_cib_destroy_cb(void *user_data)
@@ -159,6 +178,10 @@ attrd_cib_disconnect(void)
                                        attrd_cib_updated_cb);
     cib__clean_up_connection(&the_cib);
     mainloop_destroy_trigger(attrd_config_read);
+
+    // Any uncommitted transaction was discarded with the connection
+    g_clear_pointer(&batch_trigger, mainloop_destroy_trigger);
+    g_clear_pointer(&batch, batch_free);
 }
 
 static void
@@ -232,6 +255,10 @@ attrd_cib_init(void)
 
     // Always read the CIB at start-up
     mainloop_set_trigger(attrd_config_read);
+
+    // Commit attribute writes once everything currently due has been gathered
+    batch_trigger = mainloop_add_trigger(G_PRIORITY_DEFAULT_IDLE,
+                                         batch_trigger_cb, NULL);
 }
 
 static gboolean
@@ -243,15 +270,23 @@ attribute_timer_cb(void *data)
     return FALSE;
 }
 
+/*!
+ * \internal
+ * \brief Process the result of writing an attribute to the CIB
+ *
+ * \param[in] name     Name of attribute that was written
+ * \param[in] call_id  CIB call ID of write
+ * \param[in] rc       Legacy return code of write
+ * \param[in] batched  Whether other attributes were written in same request
+ */
 static void
-attrd_cib_callback(xmlNode *msg, int call_id, int rc, xmlNode *output, void *user_data)
+attribute_written(const char *name, int call_id, int rc, bool batched)
 {
     int level = LOG_ERR;
     GHashTableIter iter;
     const char *peer = NULL;
     attribute_value_t *v = NULL;
 
-    char *name = user_data;
     attribute_t *a = g_hash_table_lookup(attributes, name);
 
     if(a == NULL) {
@@ -260,14 +295,12 @@ attrd_cib_callback(xmlNode *msg, int call_id, int rc, xmlNode *output, void *use
     }
 
     a->update = 0;
-    if (rc == pcmk_ok && call_id < 0) {
-        rc = call_id;
-    }
 
     switch (rc) {
         case pcmk_ok:
             level = LOG_INFO;
             last_cib_op_done = call_id;
+            attrd_clear_attr_flags(a, attrd_attr_write_alone);
             if (a->timer && !a->timeout_ms) {
                 // Remove temporary dampening for failed writes
                 g_clear_pointer(&a->timer, mainloop_timer_del);
@@ -283,6 +316,13 @@ attrd_cib_callback(xmlNode *msg, int call_id, int rc, xmlNode *output, void *use
             break;
     }
 
+    if ((rc != pcmk_ok) && batched) {
+        /* A single bad attribute fails the whole transaction, so retry each
+         * attribute in its own transaction, as if we never batched them
+         */
+        attrd_set_attr_flags(a, attrd_attr_write_alone);
+    }
+
     do_crm_log(level, "CIB update %d result for %s: %s " QB_XS " rc=%d",
                call_id, a->id, pcmk_strerror(rc), rc);
 
@@ -335,6 +375,24 @@ attrd_cib_callback(xmlNode *msg, int call_id, int rc, xmlNode *output, void *use
     }
 }
 
+static void
+attrd_cib_callback(xmlNode *msg, int call_id, int rc, xmlNode *output, void *user_data)
+{
+    attrd_batch_t *written = user_data;
+    bool batched = (g_hash_table_size(written->values) > 1);
+    GHashTableIter iter;
+    const char *name = NULL;
+
+    if (rc == pcmk_ok && call_id < 0) {
+        rc = call_id;
+    }
+
+    g_hash_table_iter_init(&iter, written->values);
+    while (g_hash_table_iter_next(&iter, (void **) &name, NULL)) {
+        attribute_written(name, call_id, rc, batched);
+    }
+}
+
 /*!
  * \internal
  * \brief Add a set-attribute update request to the current CIB transaction
@@ -439,7 +497,7 @@ add_attr_update(const attribute_t *attr, const char *value, const char *node_id)
 }
 
 static void
-send_alert_attributes_value(attribute_t *a, GHashTable *t)
+send_alert_attributes_value(const char *name, GHashTable *t)
 {
     int rc = 0;
     attribute_value_t *at = NULL;
@@ -452,7 +510,7 @@ send_alert_attributes_value(attribute_t *a, GHashTable *t)
         const char *failed_s = NULL;
 
         rc = attrd_send_attribute_alert(at->nodename, node_xml_id,
-                                        a->id, at->current);
+                                        name, at->current);
 
         switch (rc) {
             case pcmk_ok:
@@ -473,7 +531,7 @@ send_alert_attributes_value(attribute_t *a, GHashTable *t)
         }
 
         pcmk__trace("Sent alerts for %s[%s]=%s with node XML ID %s (%s, rc=%d)",
-                    a->id, at->nodename, at->current,
+                    name, at->nodename, at->current,
                     pcmk__s(node_xml_id, "<unknown>"), failed_s, rc);
     }
 }
@@ -495,6 +553,124 @@ attrd_add_timer(const char *id, int timeout_ms, attribute_t *attr)
    return mainloop_timer_add(id, timeout_ms, FALSE, attribute_timer_cb, attr);
 }
 
+static void
+batch_free(void *data)
+{
+    attrd_batch_t *b = data;
+
+    if (b != NULL) {
+        g_hash_table_destroy(b->values);
+        free(b->user);
+        free(b);
+    }
+}
+
+/*!
+ * \internal
+ * \brief Commit the CIB transaction being built, if any
+ */
+static void
+batch_commit(void)
+{
+    attrd_batch_t *b = batch;
+    GHashTableIter iter;
+    const char *name = NULL;
+    GHashTable *values = NULL;
+    int call_id = 0;
+
+    if (b == NULL) {
+        return;
+    }
+    batch = NULL;
+
+    if (b->updates == 0) {
+        the_cib->cmds->end_transaction(the_cib, false, cib_none);
+        batch_free(b);
+        return;
+    }
+
+    the_cib->cmds->set_user(the_cib, b->user);
+    call_id = the_cib->cmds->end_transaction(the_cib, true, cib_none);
+    the_cib->cmds->set_user(the_cib, NULL);
+
+    pcmk__info("Sent CIB request %d with %d change%s for %u attribute%s",
+               call_id, b->updates, pcmk__plural_s(b->updates),
+               g_hash_table_size(b->values),
+               pcmk__plural_s(g_hash_table_size(b->values)));
+
+    g_hash_table_iter_init(&iter, b->values);
+    while (g_hash_table_iter_next(&iter, (void **) &name, NULL)) {
+        attribute_t *a = g_hash_table_lookup(attributes, name);
+
+        if (a != NULL) {
+            a->update = call_id;
+        }
+    }
+
+    if (the_cib->cmds->register_callback_full(the_cib, call_id,
+                                              CIB_OP_TIMEOUT_S, FALSE, b,
+                                              "attrd_cib_callback",
+                                              attrd_cib_callback,
+                                              batch_free)) {
+        // Transmit alerts for the attributes
+        g_hash_table_iter_init(&iter, b->values);
+        while (g_hash_table_iter_next(&iter, (void **) &name,
+                                      (void **) &values)) {
+            send_alert_attributes_value(name, values);
+        }
+    }
+}
+
+static gboolean
+batch_trigger_cb(void *user_data)
+{
+    batch_commit();
+    return TRUE;
+}
+
+/*!
+ * \internal
+ * \brief Ensure a CIB transaction is being built that can take an attribute
+ *
+ * An attribute's values are always written in the same transaction, so an
+ * attribute with more values than the limit gets a transaction of its own.
+ *
+ * \param[in] a  Attribute to be written
+ *
+ * \return Standard Pacemaker return code
+ */
+static int
+batch_start(const attribute_t *a)
+{
+    int rc = pcmk_ok;
+
+    // At most this many values will be added (fewer if some nodes are unknown)
+    unsigned int updates = g_hash_table_size(a->values);
+
+    // A transaction is committed as a single user, and is bounded in size
+    if ((batch != NULL)
+        && (!pcmk__str_eq(batch->user, a->user, pcmk__str_none)
+            || ((batch->updates > 0)
+                && ((batch->updates + updates) > ATTRD_BATCH_MAX_UPDATES)))) {
+        batch_commit();
+    }
+
+    if (batch != NULL) {
+        return pcmk_rc_ok;
+    }
+
+    rc = the_cib->cmds->init_transaction(the_cib);
+    if (rc != pcmk_ok) {
+        return pcmk_legacy2rc(rc);
+    }
+
+    batch = pcmk__assert_alloc(1, sizeof(attrd_batch_t));
+    batch->user = pcmk__str_copy(a->user);
+    batch->values = pcmk__strkey_table(free,
+                                       (GDestroyNotify) g_hash_table_destroy);
+    return pcmk_rc_ok;
+}
+
 /*!
  * \internal
  * \brief Write an attribute's values to the CIB if appropriate
@@ -510,8 +686,9 @@ write_attribute(attribute_t *a, bool ignore_delay)
     attribute_value_t *v = NULL;
     GHashTableIter iter;
     GHashTable *alert_attribute_value = NULL;
-    int rc = pcmk_ok;
+    int rc = pcmk_rc_ok;
     bool should_write = true;
+    bool alone = false;
 
     if (a == NULL) {
         return;
@@ -525,7 +702,13 @@ write_attribute(attribute_t *a, bool ignore_delay)
     /* If this attribute will be written to the CIB ... */
     if (should_write) {
         /* Defer the write if now's not a good time */
-        if (a->update && (a->update < last_cib_op_done)) {
+        if ((batch != NULL) && g_hash_table_contains(batch->values, a->id)) {
+            pcmk__info("Write out of '%s' delayed: update not yet sent",
+                       a->id);
+            attrd_set_attr_flags(a, attrd_attr_changed);
+            goto done;
+
+        } else if (a->update && (a->update < last_cib_op_done)) {
             pcmk__info("Write out of '%s' continuing: update %d considered "
                        "lost",
                        a->id, a->update);
@@ -546,16 +729,21 @@ write_attribute(attribute_t *a, bool ignore_delay)
             }
         }
 
-        // Initiate a transaction for all the peer value updates
+        // Add the peer value updates to a transaction (alone if retrying)
         CRM_CHECK(the_cib != NULL, goto done);
-        the_cib->cmds->set_user(the_cib, a->user);
-        rc = the_cib->cmds->init_transaction(the_cib);
-        if (rc != pcmk_ok) {
+        alone = pcmk__is_set(a->flags, attrd_attr_write_alone);
+        if (alone) {
+            batch_commit();
+        }
+        rc = batch_start(a);
+        if (rc != pcmk_rc_ok) {
             pcmk__err("Failed to write %s (set %s): Could not initiate "
-                      "CIB transaction",
-                      a->id, pcmk__s(a->set_id, "unspecified"));
+                      "CIB transaction: %s",
+                      a->id, pcmk__s(a->set_id, "unspecified"),
+                      pcmk_rc_str(rc));
             goto done;
         }
+        the_cib->cmds->set_user(the_cib, a->user);
     }
 
     /* The changed and force-write flags apply only to the next write,
@@ -649,31 +837,29 @@ write_attribute(attribute_t *a, bool ignore_delay)
                    a->id, pcmk__s(a->set_id, "unspecified"));
     }
     if (cib_updates > 0) {
-        char *id = pcmk__str_copy(a->id);
-
-        // Commit transaction
-        a->update = the_cib->cmds->end_transaction(the_cib, true, cib_none);
+        pcmk__debug("Added %d change%s for %s (set %s) to CIB transaction",
+                    cib_updates, pcmk__plural_s(cib_updates), a->id,
+                    pcmk__s(a->set_id, "unspecified"));
+
+        // The batch now owns the values to send alerts for
+        batch->updates += cib_updates;
+        g_hash_table_insert(batch->values, pcmk__str_copy(a->id),
+                            alert_attribute_value);
+        alert_attribute_value = NULL;
+    }
 
-        pcmk__info("Sent CIB request %d with %d change%s for %s (set %s)",
-                   a->update, cib_updates, pcmk__plural_s(cib_updates),
-                   a->id, pcmk__s(a->set_id, "unspecified"));
+    if (should_write) {
+        // Restore the default user for requests outside the transaction
+        the_cib->cmds->set_user(the_cib, NULL);
 
-        if (the_cib->cmds->register_callback_full(the_cib, a->update,
-                                                  CIB_OP_TIMEOUT_S, FALSE, id,
-                                                  "attrd_cib_callback",
-                                                  attrd_cib_callback, free)) {
-            // Transmit alert of the attribute
-            send_alert_attributes_value(a, alert_attribute_value);
+        if (alone) {
+            batch_commit();
+        } else {
+            mainloop_set_trigger(batch_trigger);
         }
     }
 
 done:
-    // Discard transaction (if any)
-    if (the_cib != NULL) {
-        the_cib->cmds->end_transaction(the_cib, false, cib_none);
-        the_cib->cmds->set_user(the_cib, NULL);
-    }
-
     g_clear_pointer(&alert_attribute_value, g_hash_table_destroy);
 }
 
@@ -51,12 +51,23 @@ static GHashTable *removed_peers = NULL;
 
 /*!
  * \internal
- * \brief Free the removed nodes table
+ * \brief Attributes requested from the writer after a sync summary
+ *
+ * This table is to be used as a set. It contains the names of attributes whose
+ * digest in the writer's last \c PCMK__ATTRD_CMD_SYNC_SUMMARY differed from
+ * ours, and whose values we have requested but not yet received.
+ */
+static GHashTable *requested_attrs = NULL;
+
+/*!
+ * \internal
+ * \brief Free the removed nodes and requested attributes tables
  */
 void
 attrd_free_removed_peers(void)
 {
     g_clear_pointer(&removed_peers, g_hash_table_destroy);
+    g_clear_pointer(&requested_attrs, g_hash_table_destroy);
 }
 
 static xmlNode *
@@ -450,17 +461,27 @@ attrd_peer_update_one(const pcmk__node_status_t *peer, xmlNode *xml,
     }
 }
 
+/*!
+ * \internal
+ * \brief Broadcast local values that a peer's sync response didn't include
+ *
+ * \param[in] names  If not \c NULL, check only attributes in this set
+ */
 static void
-broadcast_unseen_local_values(void)
+broadcast_unseen_local_values(GHashTable *names)
 {
     GHashTableIter aIter;
     GHashTableIter vIter;
+    const char *name = NULL;
     attribute_t *a = NULL;
     attribute_value_t *v = NULL;
     xmlNode *sync = NULL;
 
     g_hash_table_iter_init(&aIter, attributes);
-    while (g_hash_table_iter_next(&aIter, NULL, (void **) &a)) {
+    while (g_hash_table_iter_next(&aIter, (gpointer *) &name, (void **) &a)) {
+        if ((names != NULL) && !g_hash_table_contains(names, name)) {
+            continue;
+        }
 
         g_hash_table_iter_init(&vIter, a->values);
         while (g_hash_table_iter_next(&vIter, NULL, (void **) &v)) {
@@ -542,9 +563,8 @@ attrd_peer_clear_failure(pcmk__request_t *request)
     const char *op = pcmk__xe_get(xml, PCMK__XA_ATTR_CLEAR_OPERATION);
     const char *interval_spec = pcmk__xe_get(xml, PCMK__XA_ATTR_CLEAR_INTERVAL);
     unsigned int interval_ms = 0;
-    char *attr = NULL;
-    GHashTableIter iter;
-    regex_t regex;
+    const regex_t *regex = NULL;
+    GList *names = NULL;
 
     pcmk__node_status_t *peer =
         pcmk__get_node(0, request->peer, NULL,
@@ -552,7 +572,8 @@ attrd_peer_clear_failure(pcmk__request_t *request)
 
     pcmk_parse_interval_spec(interval_spec, &interval_ms);
 
-    if (attrd_failure_regex(&regex, rsc, op, interval_ms) != pcmk_ok) {
+    regex = attrd_failure_regex(rsc, op, interval_ms);
+    if (regex == NULL) {
         pcmk__info("Ignoring invalid request to clear failures for %s",
                    pcmk__s(rsc, "all resources"));
         return;
@@ -563,16 +584,19 @@ attrd_peer_clear_failure(pcmk__request_t *request)
     /* Make sure value is not set, so we delete */
     pcmk__xe_remove_attr(xml, PCMK__XA_ATTR_VALUE);
 
-    g_hash_table_iter_init(&iter, attributes);
-    while (g_hash_table_iter_next(&iter, (void **) &attr, NULL)) {
-        if (regexec(&regex, attr, 0, NULL, 0) == 0) {
+    // Only failure attributes for the resource can match
+    names = attrd_failure_attributes(rsc);
+    for (const GList *iter = names; iter != NULL; iter = iter->next) {
+        const char *attr = iter->data;
+
+        if (regexec(regex, attr, 0, NULL, 0) == 0) {
             pcmk__trace("Matched %s when clearing %s", attr,
                         pcmk__s(rsc, "all resources"));
             pcmk__xe_set(xml, PCMK__XA_ATTR_NAME, attr);
             attrd_peer_update(peer, xml, host, false);
         }
     }
-    regfree(&regex);
+    g_list_free(names);
 }
 
 /*!
@@ -587,14 +611,28 @@ void
 attrd_peer_sync_response(const pcmk__node_status_t *peer, bool peer_won,
                          xmlNode *xml)
 {
+    GHashTable *names = NULL;
+
     pcmk__info("Processing " PCMK__ATTRD_CMD_SYNC_RESPONSE " from %s",
                peer->name);
 
+    if (pcmk__str_eq(pcmk__xe_get(xml, PCMK__XA_ATTR_SYNC),
+                     PCMK__VALUE_PARTIAL, pcmk__str_none)) {
+        /* The response has values only for the attributes we requested after
+         * a sync summary, so limit the "seen" checks below to those
+         */
+        names = requested_attrs;
+        requested_attrs = NULL;
+        if (names == NULL) {
+            names = pcmk__strkey_table(free, NULL);
+        }
+    }
+
     if (peer_won) {
         /* Initialize the "seen" flag for all attributes to cleared, so we can
          * detect attributes that local node has but the writer doesn't.
          */
-        attrd_clear_value_seen();
+        attrd_clear_value_seen(names);
     }
 
     // Process each attribute update in the sync response
@@ -609,8 +647,201 @@ attrd_peer_sync_response(const pcmk__node_status_t *peer, bool peer_won,
         /* If any attributes are still not marked as seen, the writer doesn't
          * know about them, so send all peers an update with them.
          */
-        broadcast_unseen_local_values();
+        broadcast_unseen_local_values(names);
+    }
+
+    if (names != NULL) {
+        g_hash_table_destroy(names);
+    }
+}
+
+/*!
+ * \internal
+ * \brief Broadcast a digest of each attribute's values
+ *
+ * Peers answer with a \c PCMK__ATTRD_CMD_SYNC_REQUEST for any attributes whose
+ * values differ from theirs.
+ */
+static void
+broadcast_sync_summary(void)
+{
+    GHashTableIter iter;
+    attribute_t *a = NULL;
+    xmlNode *sync = pcmk__xe_create(NULL, __func__);
+
+    pcmk__xe_set(sync, PCMK_XA_TASK, PCMK__ATTRD_CMD_SYNC_SUMMARY);
+
+    g_hash_table_iter_init(&iter, attributes);
+    while (g_hash_table_iter_next(&iter, NULL, (void **) &a)) {
+        char *digest = attrd_attribute_digest(a);
+
+        if (digest != NULL) {
+            xmlNode *child = pcmk__xe_create(sync, PCMK_XE_OP);
+
+            pcmk__xe_set(child, PCMK__XA_ATTR_NAME, a->id);
+            pcmk__xe_set(child, PCMK__XA_ATTR_DIGEST, digest);
+            free(digest);
+        }
     }
+
+    pcmk__debug("Broadcasting attribute digests");
+    attrd_send_message(NULL, sync, false);
+    pcmk__xml_free(sync);
+}
+
+/*!
+ * \internal
+ * \brief Request a peer's values for any attributes whose digests differ
+ *
+ * \param[in] peer      Peer that sent sync summary
+ * \param[in] peer_won  Whether peer is the attribute writer
+ * \param[in] xml       Request XML
+ */
+void
+attrd_peer_sync_summary(pcmk__node_status_t *peer, bool peer_won,
+                        const xmlNode *xml)
+{
+    GHashTable *digests = NULL;
+    GHashTableIter iter;
+    const char *name = NULL;
+    const char *digest = NULL;
+    attribute_t *a = NULL;
+    xmlNode *request = NULL;
+
+    if (!peer_won) {
+        pcmk__debug("Ignoring " PCMK__ATTRD_CMD_SYNC_SUMMARY " from %s "
+                    "because it is not the writer", peer->name);
+        return;
+    }
+
+    // Index the writer's digests by attribute name
+    digests = pcmk__strkey_table(NULL, NULL);
+    for (const xmlNode *child = pcmk__xe_first_child(xml, PCMK_XE_OP, NULL,
+                                                     NULL);
+         child != NULL; child = pcmk__xe_next(child, PCMK_XE_OP)) {
+
+        name = pcmk__xe_get(child, PCMK__XA_ATTR_NAME);
+        if (name != NULL) {
+            g_hash_table_insert(digests, (gpointer) name,
+                                (gpointer) pcmk__xe_get(child,
+                                                        PCMK__XA_ATTR_DIGEST));
+        }
+    }
+
+    request = pcmk__xe_create(NULL, __func__);
+    pcmk__xe_set(request, PCMK_XA_TASK, PCMK__ATTRD_CMD_SYNC_REQUEST);
+
+    // Check attributes known to the writer
+    g_hash_table_iter_init(&iter, digests);
+    while (g_hash_table_iter_next(&iter, (gpointer *) &name,
+                                  (gpointer *) &digest)) {
+        char *local = NULL;
+
+        a = g_hash_table_lookup(attributes, name);
+        if (a != NULL) {
+            local = attrd_attribute_digest(a);
+        }
+
+        if (!pcmk__str_eq(digest, local, pcmk__str_none)) {
+            pcmk__xe_set(pcmk__xe_create(request, PCMK_XE_OP),
+                         PCMK__XA_ATTR_NAME, name);
+        }
+        free(local);
+    }
+
+    // Check attributes with values that the writer doesn't know about
+    g_hash_table_iter_init(&iter, attributes);
+    while (g_hash_table_iter_next(&iter, (gpointer *) &name, (void **) &a)) {
+        char *local = NULL;
+
+        if (g_hash_table_contains(digests, name)) {
+            continue;
+        }
+
+        local = attrd_attribute_digest(a);
+        if (local != NULL) {
+            pcmk__xe_set(pcmk__xe_create(request, PCMK_XE_OP),
+                         PCMK__XA_ATTR_NAME, name);
+            free(local);
+        }
+    }
+    g_hash_table_destroy(digests);
+
+    if (pcmk__xe_first_child(request, PCMK_XE_OP, NULL, NULL) == NULL) {
+        pcmk__debug("All attributes are in sync with writer %s", peer->name);
+        pcmk__xml_free(request);
+        return;
+    }
+
+    // Remember what we asked for, so we know what the response covers
+    if (requested_attrs == NULL) {
+        requested_attrs = pcmk__strkey_table(free, NULL);
+    }
+    for (const xmlNode *child = pcmk__xe_first_child(request, PCMK_XE_OP,
+                                                     NULL, NULL);
+         child != NULL; child = pcmk__xe_next(child, PCMK_XE_OP)) {
+
+        name = pcmk__xe_get(child, PCMK__XA_ATTR_NAME);
+        pcmk__trace("Requesting %s values from writer %s", name, peer->name);
+        g_hash_table_add(requested_attrs, pcmk__str_copy(name));
+    }
+
+    pcmk__debug("Requesting %u attributes from writer %s",
+                g_hash_table_size(requested_attrs), peer->name);
+    attrd_send_message(peer, request, false);
+    pcmk__xml_free(request);
+}
+
+/*!
+ * \internal
+ * \brief Send a peer all values of the attributes it requested
+ *
+ * \param[in] peer  Peer that sent sync request
+ * \param[in] xml   Request XML
+ */
+void
+attrd_peer_sync_request(pcmk__node_status_t *peer, const xmlNode *xml)
+{
+    xmlNode *sync = NULL;
+
+    if (!attrd_election_won()) {
+        pcmk__debug("Ignoring " PCMK__ATTRD_CMD_SYNC_REQUEST " from %s "
+                    "because we are not the writer", peer->name);
+        return;
+    }
+
+    sync = pcmk__xe_create(NULL, __func__);
+    pcmk__xe_set(sync, PCMK_XA_TASK, PCMK__ATTRD_CMD_SYNC_RESPONSE);
+    pcmk__xe_set(sync, PCMK__XA_ATTR_SYNC, PCMK__VALUE_PARTIAL);
+
+    for (const xmlNode *child = pcmk__xe_first_child(xml, PCMK_XE_OP, NULL,
+                                                     NULL);
+         child != NULL; child = pcmk__xe_next(child, PCMK_XE_OP)) {
+
+        const char *name = pcmk__xe_get(child, PCMK__XA_ATTR_NAME);
+        attribute_t *a = NULL;
+        attribute_value_t *v = NULL;
+        GHashTableIter iter;
+
+        if (name == NULL) {
+            continue;
+        }
+        a = g_hash_table_lookup(attributes, name);
+        if (a == NULL) {
+            continue;
+        }
+
+        g_hash_table_iter_init(&iter, a->values);
+        while (g_hash_table_iter_next(&iter, NULL, (void **) &v)) {
+            pcmk__debug("Syncing %s[%s]='%s' to %s", a->id, v->nodename,
+                        readable_value(v), readable_peer(peer));
+            attrd_add_value_xml(sync, a, v, false);
+        }
+    }
+
+    pcmk__debug("Syncing requested values to %s", readable_peer(peer));
+    attrd_send_message(peer, sync, false);
+    pcmk__xml_free(sync);
 }
 
 /*!
@@ -702,6 +933,9 @@ attrd_peer_remove(const char *host, bool uncache, const char *source)
  * \brief Send all known attributes and values to a peer
  *
  * \param[in] peer  Peer to send sync to (if NULL, broadcast to all peers)
+ *
+ * \note When broadcasting to peers that all support it, this sends only a
+ *       summary of attribute digests, and peers request what they need.
  */
 void
 attrd_peer_sync(pcmk__node_status_t *peer)
@@ -711,8 +945,20 @@ attrd_peer_sync(pcmk__node_status_t *peer)
 
     attribute_t *a = NULL;
     attribute_value_t *v = NULL;
-    xmlNode *sync = pcmk__xe_create(NULL, __func__);
+    xmlNode *sync = NULL;
+
+    /* Peers that are already members mostly have the same values as we do, so
+     * if they all understand summaries, broadcast digests and let each peer
+     * request only what differs. A new peer gets everything, since its values
+     * were removed when it left, and its protocol version isn't known yet.
+     */
+    if ((peer == NULL)
+        && ATTRD_SUPPORTS_SYNC_SUMMARY(minimum_protocol_version)) {
+        broadcast_sync_summary();
+        return;
+    }
 
+    sync = pcmk__xe_create(NULL, __func__);
     pcmk__xe_set(sync, PCMK_XA_TASK, PCMK__ATTRD_CMD_SYNC_RESPONSE);
 
     g_hash_table_iter_init(&aIter, attributes);
@@ -241,24 +241,37 @@ handle_missing_host(xmlNode *xml)
 }
 
 /* Convert a single IPC message with a regex into one with multiple children, one
- * for each regex match.
+ * for each regex match. If failures is true, the regex can match only failure
+ * attributes of the resource specified in the message (or of all resources).
  */
 static int
-expand_regexes(xmlNode *xml, const char *attr, const char *value, const char *regex)
+expand_regexes(xmlNode *xml, const char *attr, const char *value,
+               const char *regex, bool failures)
 {
     if (attr == NULL && regex) {
         bool matched = false;
-        GHashTableIter aIter;
-        regex_t r_patt;
+        const regex_t *r_patt = NULL;
+        GList *names = NULL;
 
         pcmk__debug("Setting %s to %s", regex, value);
-        if (regcomp(&r_patt, regex, REG_EXTENDED|REG_NOSUB)) {
+        r_patt = attrd_compile_regex(regex);
+        if (r_patt == NULL) {
             return EINVAL;
         }
 
-        g_hash_table_iter_init(&aIter, attributes);
-        while (g_hash_table_iter_next(&aIter, (void **) &attr, NULL)) {
-            int status = regexec(&r_patt, attr, 0, NULL, 0);
+        if (failures) {
+            const char *rsc = pcmk__xe_get(xml, PCMK__XA_ATTR_RESOURCE);
+
+            names = attrd_failure_attributes(rsc);
+        } else {
+            names = g_hash_table_get_keys(attributes);
+        }
+
+        for (const GList *iter = names; iter != NULL; iter = iter->next) {
+            int status = 0;
+
+            attr = iter->data;
+            status = regexec(r_patt, attr, 0, NULL, 0);
 
             if (status == 0) {
                 xmlNode *child = pcmk__xe_create(xml, PCMK_XE_OP);
@@ -275,7 +288,7 @@ expand_regexes(xmlNode *xml, const char *attr, const char *value, const char *re
             }
         }
 
-        regfree(&r_patt);
+        g_list_free(names);
 
         /* Return a code if we never matched anything.  This should not be treated
          * as an error.  It indicates there was a regex, and it was a valid regex,
@@ -303,7 +316,9 @@ handle_regexes(pcmk__request_t *request)
     const char *value = pcmk__xe_get(xml, PCMK__XA_ATTR_VALUE);
     const char *regex = pcmk__xe_get(xml, PCMK__XA_ATTR_REGEX);
 
-    rc = expand_regexes(xml, attr, value, regex);
+    rc = expand_regexes(xml, attr, value, regex,
+                        pcmk__str_eq(request->op, PCMK__ATTRD_CMD_CLEAR_FAILURE,
+                                     pcmk__str_none));
 
     if (rc == EINVAL) {
         pcmk__format_result(&request->result, CRM_EX_ERROR, PCMK_EXEC_ERROR,
@@ -368,9 +383,10 @@ send_update_msg_to_cluster(pcmk__request_t *request, xmlNode *xml)
          * waiting on any sync point at all.  For the local sync point, the
          * response ACK is sent in attrd_peer_update.  For clients not
          * waiting on any sync point, the response ACK is sent in
-         * handle_update_request immediately before this function was called.
+         * handle_update_request immediately before this function was called,
+         * so the broadcast may be held briefly and merged with later ones.
          */
-        attrd_send_message(NULL, xml, false); /* ends up at attrd_peer_message() */
+        attrd_send_update(xml); /* ends up at attrd_peer_message() */
     }
 }
 
@@ -23,6 +23,21 @@ int minimum_protocol_version = -1;
 
 static GHashTable *attrd_handlers = NULL;
 
+/* How long to hold client update broadcasts after sending one, so that later
+ * updates of the same value can replace them rather than each being broadcast.
+ * Held updates are applied locally right away.
+ */
+#define ATTRD_MERGE_WINDOW_MS 200
+
+// Client updates waiting to be broadcast, in order (as XML copies)
+static GQueue *pending_updates = NULL;
+
+// Links in pending_updates, indexed by attribute name and host
+static GHashTable *pending_index = NULL;
+
+// Running while updates are being held
+static mainloop_timer_t *merge_timer = NULL;
+
 static bool
 is_sync_point_attr(const xmlAttr *attr, void *data)
 {
@@ -195,6 +210,46 @@ handle_sync_response_request(pcmk__request_t *request)
     return NULL;
 }
 
+static xmlNode *
+handle_sync_summary_request(pcmk__request_t *request)
+{
+    pcmk__node_status_t *peer = NULL;
+    bool peer_won = false;
+
+    if (request->ipc_client != NULL) {
+        return handle_unknown_request(request);
+    }
+
+    peer = pcmk__get_node(0, request->peer, NULL,
+                          pcmk__node_search_cluster_member);
+    peer_won = attrd_check_for_new_writer(peer, request->xml);
+
+    if (!pcmk__str_eq(peer->name, attrd_cluster->priv->node_name,
+                      pcmk__str_casei)) {
+        attrd_peer_sync_summary(peer, peer_won, request->xml);
+    }
+
+    pcmk__set_result(&request->result, CRM_EX_OK, PCMK_EXEC_DONE, NULL);
+    return NULL;
+}
+
+static xmlNode *
+handle_sync_request_request(pcmk__request_t *request)
+{
+    pcmk__node_status_t *peer = NULL;
+
+    if (request->ipc_client != NULL) {
+        return handle_unknown_request(request);
+    }
+
+    peer = pcmk__get_node(0, request->peer, NULL,
+                          pcmk__node_search_cluster_member);
+    attrd_peer_sync_request(peer, request->xml);
+
+    pcmk__set_result(&request->result, CRM_EX_OK, PCMK_EXEC_DONE, NULL);
+    return NULL;
+}
+
 static xmlNode *
 handle_update_request(pcmk__request_t *request)
 {
@@ -248,6 +303,8 @@ attrd_register_handlers(void)
         { PCMK__ATTRD_CMD_QUERY, handle_query_request },
         { PCMK__ATTRD_CMD_REFRESH, handle_refresh_request },
         { PCMK__ATTRD_CMD_SYNC_RESPONSE, handle_sync_response_request },
+        { PCMK__ATTRD_CMD_SYNC_SUMMARY, handle_sync_summary_request },
+        { PCMK__ATTRD_CMD_SYNC_REQUEST, handle_sync_request_request },
         { PCMK__ATTRD_CMD_UPDATE, handle_update_request },
         { PCMK__ATTRD_CMD_UPDATE_DELAY, handle_update_request },
         { PCMK__ATTRD_CMD_UPDATE_BOTH, handle_update_request },
@@ -349,8 +406,8 @@ attrd_send_protocol(const pcmk__node_status_t *peer)
     pcmk__xml_free(attrd_op);
 }
 
-gboolean
-attrd_send_message(const pcmk__node_status_t *node, xmlNode *data, bool confirm)
+static gboolean
+send_message(const pcmk__node_status_t *node, xmlNode *data, bool confirm)
 {
     const char *op = pcmk__xe_get(data, PCMK_XA_TASK);
 
@@ -368,3 +425,222 @@ attrd_send_message(const pcmk__node_status_t *node, xmlNode *data, bool confirm)
     attrd_xml_add_writer(data);
     return pcmk__cluster_send_message(node, pcmk_ipc_attrd, data);
 }
+
+/*!
+ * \internal
+ * \brief Send a message to one peer or all peers
+ *
+ * \param[in]     node     Peer to send message to (or \c NULL for all peers)
+ * \param[in,out] data     Message to send
+ * \param[in]     confirm  Whether to request confirmation from recipients
+ *
+ * \return \c TRUE if message was sent, otherwise \c FALSE
+ * \note Before any broadcast, any held client updates are broadcast first, so
+ *       peers see all broadcasts in the order they were requested.
+ */
+gboolean
+attrd_send_message(const pcmk__node_status_t *node, xmlNode *data, bool confirm)
+{
+    if (node == NULL) {
+        attrd_flush_updates();
+    }
+    return send_message(node, data, confirm);
+}
+
+static char *
+pending_key(const char *attr, const char *host)
+{
+    return pcmk__assert_asprintf("%s\n%s", attr, pcmk__s(host, ""));
+}
+
+/*!
+ * \internal
+ * \brief Check whether a client update may be held and merged with others
+ *
+ * \param[in] xml  Update XML
+ *
+ * \return \c true if \p xml sets a single value with no sync point,
+ *         otherwise \c false
+ */
+static bool
+update_is_mergeable(xmlNode *xml)
+{
+    return pcmk__str_eq(pcmk__xe_get(xml, PCMK_XA_TASK),
+                        PCMK__ATTRD_CMD_UPDATE, pcmk__str_none)
+           && (pcmk__xe_first_child(xml, NULL, NULL, NULL) == NULL)
+           && (pcmk__xe_get(xml, PCMK__XA_ATTR_NAME) != NULL)
+           && (pcmk__xe_get(xml, PCMK__XA_ATTR_REGEX) == NULL)
+           && !attrd_request_has_sync_point(xml);
+}
+
+/*!
+ * \internal
+ * \brief Check whether a client update may replace a held update's value
+ *
+ * \param[in] pending  Held update XML
+ * \param[in] xml      New update XML for the same attribute and host
+ *
+ * \return \c true if everything but the values is the same, otherwise
+ *         \c false
+ */
+static bool
+update_can_replace(const xmlNode *pending, const xmlNode *xml)
+{
+    static const char *const attrs[] = {
+        PCMK__XA_ATTR_DAMPENING,
+        PCMK__XA_ATTR_HOST_ID,
+        PCMK__XA_ATTR_IS_PRIVATE,
+        PCMK__XA_ATTR_IS_REMOTE,
+        PCMK__XA_ATTR_SECTION,
+        PCMK__XA_ATTR_SET,
+        PCMK__XA_ATTR_SET_TYPE,
+        PCMK__XA_ATTR_USER,
+    };
+
+    for (int i = 0; i < PCMK__NELEM(attrs); i++) {
+        if (!pcmk__str_eq(pcmk__xe_get(pending, attrs[i]),
+                          pcmk__xe_get(xml, attrs[i]), pcmk__str_none)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+ * \internal
+ * \brief Broadcast all held client updates, in order
+ */
+void
+attrd_flush_updates(void)
+{
+    xmlNode *xml = NULL;
+
+    if (pending_updates == NULL) {
+        return;
+    }
+
+    g_hash_table_remove_all(pending_index);
+    while ((xml = g_queue_pop_head(pending_updates)) != NULL) {
+        send_message(NULL, xml, false); // ends up at attrd_peer_message()
+        pcmk__xml_free(xml);
+    }
+}
+
+static gboolean
+merge_timer_cb(gpointer data)
+{
+    if (g_queue_is_empty(pending_updates)) {
+        // Nothing arrived during the window, so stop holding updates
+        return FALSE;
+    }
+
+    pcmk__trace("Broadcasting %u held attribute updates",
+                g_queue_get_length(pending_updates));
+    attrd_flush_updates();
+    return TRUE;
+}
+
+/*!
+ * \internal
+ * \brief Apply a held client update to the local attribute values
+ *
+ * \param[in] xml  Update XML
+ *
+ * \note When the update's broadcast is later delivered back to us, the value
+ *       will be unchanged, so it will not be written or logged again.
+ */
+static void
+apply_held_update(const xmlNode *xml)
+{
+    // attrd_peer_update() may modify the XML, and the held copy must not change
+    xmlNode *copy = pcmk__xml_copy(NULL, xml);
+    pcmk__node_status_t *local = NULL;
+
+    local = pcmk__get_node(0, attrd_cluster->priv->node_name, NULL,
+                           pcmk__node_search_cluster_member);
+    attrd_peer_update(local, copy, pcmk__xe_get(copy, PCMK__XA_ATTR_HOST),
+                      false);
+    pcmk__xml_free(copy);
+}
+
+/*!
+ * \internal
+ * \brief Broadcast a client update, possibly merged with later ones
+ *
+ * An update is broadcast immediately unless another was broadcast within the
+ * last \c ATTRD_MERGE_WINDOW_MS. Otherwise, it is applied locally right away,
+ * but its broadcast is held until the window ends, and a later update of the
+ * same value replaces it, so that a rapidly changing value is broadcast at
+ * most once per window.
+ *
+ * \param[in,out] xml  Update XML
+ */
+void
+attrd_send_update(xmlNode *xml)
+{
+    const char *attr = pcmk__xe_get(xml, PCMK__XA_ATTR_NAME);
+    const char *host = pcmk__xe_get(xml, PCMK__XA_ATTR_HOST);
+    char *key = NULL;
+    GList *link = NULL;
+
+    if (!update_is_mergeable(xml)) {
+        attrd_send_message(NULL, xml, false);
+        return;
+    }
+
+    if (merge_timer == NULL) {
+        pending_updates = g_queue_new();
+        pending_index = pcmk__strkey_table(free, NULL);
+        merge_timer = mainloop_timer_add("attrd-merge", ATTRD_MERGE_WINDOW_MS,
+                                         TRUE, merge_timer_cb, NULL);
+    }
+
+    if (!mainloop_timer_running(merge_timer)) {
+        send_message(NULL, xml, false); // ends up at attrd_peer_message()
+        mainloop_timer_start(merge_timer);
+        return;
+    }
+
+    key = pending_key(attr, host);
+    link = g_hash_table_lookup(pending_index, key);
+
+    if ((link != NULL) && update_can_replace(link->data, xml)) {
+        const char *value = pcmk__xe_get(xml, PCMK__XA_ATTR_VALUE);
+
+        pcmk__trace("Replacing held update of %s[%s] with %s", attr,
+                    pcmk__s(host, "local node"), pcmk__s(value, "(unset)"));
+        if (value == NULL) {
+            pcmk__xe_remove_attr(link->data, PCMK__XA_ATTR_VALUE);
+        } else {
+            pcmk__xe_set(link->data, PCMK__XA_ATTR_VALUE, value);
+        }
+        apply_held_update(link->data);
+        free(key);
+        return;
+    }
+
+    if (link != NULL) {
+        // Keep the held update, and make sure peers apply it first
+        attrd_flush_updates();
+    }
+
+    g_queue_push_tail(pending_updates, pcmk__xml_copy(NULL, xml));
+    link = g_queue_peek_tail_link(pending_updates);
+    g_hash_table_insert(pending_index, key, link);
+    apply_held_update(link->data);
+}
+
+/*!
+ * \internal
+ * \brief Discard any held client updates and stop holding updates
+ */
+void
+attrd_free_pending_updates(void)
+{
+    g_clear_pointer(&merge_timer, mainloop_timer_del);
+    g_clear_pointer(&pending_index, g_hash_table_destroy);
+    if (pending_updates != NULL) {
+        g_queue_free_full(pending_updates, (GDestroyNotify) pcmk__xml_free);
+        pending_updates = NULL;
+    }
+}
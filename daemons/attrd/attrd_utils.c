@@ -68,6 +68,10 @@ attrd_shutdown(int nsig)
     attrd_free_waitlist();
     attrd_free_confirmations();
 
+    // Clients were already told that held updates succeeded
+    attrd_flush_updates();
+    attrd_free_pending_updates();
+
     g_clear_pointer(&peer_protocol_vers, g_hash_table_destroy);
 
     if ((mloop == NULL) || !g_main_loop_is_running(mloop)) {
@@ -153,25 +157,89 @@ attrd_expand_value(const char *value, const char *old_value)
     return QB_MIN(score + increment, PCMK_SCORE_INFINITY);
 }
 
+// Maximum number of compiled regular expressions to keep
+#define ATTRD_REGEX_CACHE_MAX 256
+
+// Compiled regular expressions, indexed by pattern
+static GHashTable *regex_cache = NULL;
+
+static void
+free_regex(void *data)
+{
+    regfree((regex_t *) data);
+    free(data);
+}
+
+/*!
+ * \internal
+ * \brief Get a compiled regular expression, compiling it if not cached
+ *
+ * \param[in] pattern  Extended regular expression to compile
+ *
+ * \return Compiled regular expression, or \c NULL if \p pattern is invalid
+ * \note The result belongs to the cache and is valid only until the next call
+ *       to this function or \c attrd_free_regex_cache().
+ */
+const regex_t *
+attrd_compile_regex(const char *pattern)
+{
+    regex_t *regex = NULL;
+
+    CRM_CHECK(pattern != NULL, return NULL);
+
+    if (regex_cache == NULL) {
+        regex_cache = pcmk__strkey_table(free, free_regex);
+
+    } else {
+        regex = g_hash_table_lookup(regex_cache, pattern);
+        if (regex != NULL) {
+            return regex;
+        }
+    }
+
+    regex = pcmk__assert_alloc(1, sizeof(regex_t));
+    if (regcomp(regex, pattern, REG_EXTENDED|REG_NOSUB) != 0) {
+        free(regex);
+        return NULL;
+    }
+
+    if (g_hash_table_size(regex_cache) >= ATTRD_REGEX_CACHE_MAX) {
+        pcmk__trace("Discarding %u cached regular expressions",
+                    g_hash_table_size(regex_cache));
+        g_hash_table_remove_all(regex_cache);
+    }
+    g_hash_table_insert(regex_cache, pcmk__str_copy(pattern), regex);
+    return regex;
+}
+
 /*!
  * \internal
- * \brief Create regular expression matching failure-related attributes
+ * \brief Free all cached regular expressions
+ */
+void
+attrd_free_regex_cache(void)
+{
+    g_clear_pointer(&regex_cache, g_hash_table_destroy);
+}
+
+/*!
+ * \internal
+ * \brief Get regular expression matching failure-related attributes
  *
- * \param[out] regex  Where to store created regular expression
- * \param[in]  rsc    Name of resource to clear (or NULL for all)
- * \param[in]  op     Operation to clear if rsc is specified (or NULL for all)
- * \param[in]  interval_ms  Interval of operation to clear if op is specified
+ * \param[in] rsc          Name of resource to clear (or NULL for all)
+ * \param[in] op           Operation to clear if rsc is specified (or NULL for
+ *                         all)
+ * \param[in] interval_ms  Interval of operation to clear if op is specified
  *
- * \return pcmk_ok on success, -EINVAL if arguments are invalid
+ * \return Compiled regular expression, or \c NULL if arguments are invalid
  *
- * \note The caller is responsible for freeing the result with regfree().
+ * \note The result is cached, as for \c attrd_compile_regex().
  */
-int
-attrd_failure_regex(regex_t *regex, const char *rsc, const char *op,
-                    unsigned int interval_ms)
+const regex_t *
+attrd_failure_regex(const char *rsc, const char *op, unsigned int interval_ms)
 {
     char *pattern = NULL;
-    int rc;
+    const regex_t *regex = NULL;
 
     /* Create a pattern that matches desired attributes */
 
@@ -186,10 +254,10 @@ attrd_failure_regex(regex_t *regex, const char *rsc, const char *op,
 
     /* Compile pattern into regular expression */
     pcmk__trace("Clearing attributes matching %s", pattern);
-    rc = regcomp(regex, pattern, REG_EXTENDED|REG_NOSUB);
+    regex = attrd_compile_regex(pattern);
     free(pattern);
 
-    return (rc == 0)? pcmk_ok : -EINVAL;
+    return regex;
 }
 
 void
@@ -216,7 +216,9 @@ main(int argc, char **argv)
         attrd_free_waitlist();
         attrd_cluster_disconnect();
         attrd_unregister_handlers();
+        attrd_free_failure_index();
         g_hash_table_destroy(attributes);
+        attrd_free_regex_cache();
     }
 
     attrd_cleanup_xml_ids();
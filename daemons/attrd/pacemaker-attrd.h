@@ -47,11 +47,14 @@
  *     5       2.1.5    Peers can request confirmation of a sent message
  *     6       2.1.7    PCMK__ATTRD_CMD_PEER_REMOVE supports PCMK__XA_REAP
  *     7       3.0.0    "flush" support dropped
+ *     8       3.1.0    Added PCMK__ATTRD_CMD_SYNC_SUMMARY and
+ *                      PCMK__ATTRD_CMD_SYNC_REQUEST
  */
-#define ATTRD_PROTOCOL_VERSION "7"
+#define ATTRD_PROTOCOL_VERSION "8"
 
 #define ATTRD_SUPPORTS_MULTI_MESSAGE(x) ((x) >= 4)
 #define ATTRD_SUPPORTS_CONFIRMATION(x)  ((x) >= 5)
+#define ATTRD_SUPPORTS_SYNC_SUMMARY(x)  ((x) >= 8)
 
 #define attrd_send_ack(client, id, flags)                               \
     pcmk__ipc_send_ack((client), (id), (flags), ATTRD_PROTOCOL_VERSION, \
@@ -89,8 +92,10 @@ int attrd_expand_value(const char *value, const char *old_value);
  */
 #define ATTRD_RE_CLEAR_OP ATTRD_RE_CLEAR_ALL "%s#%s_%u$"
 
-int attrd_failure_regex(regex_t *regex, const char *rsc, const char *op,
-                        unsigned int interval_ms);
+const regex_t *attrd_compile_regex(const char *pattern);
+void attrd_free_regex_cache(void);
+const regex_t *attrd_failure_regex(const char *rsc, const char *op,
+                                   unsigned int interval_ms);
 
 extern cib_t *the_cib;
 extern crm_exit_t attrd_exit_status;
@@ -130,6 +135,9 @@ enum attrd_attr_flags {
 
     // Ignore any configured delay for next write of this attribute
     attrd_attr_force_write  = (UINT32_C(1) << 3),
+
+    // Last write failed as part of a batch, so write this attribute alone
+    attrd_attr_write_alone  = (UINT32_C(1) << 4),
 };
 
 typedef struct {
@@ -204,6 +212,9 @@ void attrd_peer_remove(const char *host, bool uncache, const char *source);
 void attrd_peer_clear_failure(pcmk__request_t *request);
 void attrd_peer_sync_response(const pcmk__node_status_t *peer, bool peer_won,
                               xmlNode *xml);
+void attrd_peer_sync_summary(pcmk__node_status_t *peer, bool peer_won,
+                             const xmlNode *xml);
+void attrd_peer_sync_request(pcmk__node_status_t *peer, const xmlNode *xml);
 
 void attrd_send_protocol(const pcmk__node_status_t *peer);
 void attrd_client_peer_remove(pcmk__request_t *request);
@@ -213,10 +224,16 @@ void attrd_client_refresh(pcmk__request_t *request);
 xmlNode *attrd_client_query(pcmk__request_t *request);
 gboolean attrd_send_message(const pcmk__node_status_t *node, xmlNode *data,
                             bool confirm);
+void attrd_send_update(xmlNode *xml);
+void attrd_flush_updates(void);
+void attrd_free_pending_updates(void);
 
 xmlNode *attrd_add_value_xml(xmlNode *parent, const attribute_t *a,
                              const attribute_value_t *v, bool force_write);
-void attrd_clear_value_seen(void);
+void attrd_clear_value_seen(GHashTable *names);
+char *attrd_attribute_digest(const attribute_t *a);
+GList *attrd_failure_attributes(const char *rsc);
+void attrd_free_failure_index(void);
 void attrd_free_attribute(void *data);
 void attrd_free_attribute_value(void *data);
 attribute_t *attrd_populate_attribute(xmlNode *xml, const char *attr);
@@ -0,0 +1,266 @@
+/*
+ * Copyright 2026 the Pacemaker project contributors
+ *
+ * The version control history for this file may have further details.
+ *
+ * This source code is licensed under the GNU General Public License version 2
+ * or later (GPLv2+) WITHOUT ANY WARRANTY.
+ */
+
+#include <crm_internal.h>
+
+#include <crm/common/unittest_internal.h>
+
+// Build the code under test into this test directly
+#include "attrd_attributes.c"
+#include "attrd_nodes.c"
+
+/* Stand-ins for the parts of the attribute manager that the code under test
+ * uses
+ */
+
+GHashTable *attributes = NULL;
+
+mainloop_timer_t *
+attrd_add_timer(const char *id, int timeout_ms, attribute_t *attr)
+{
+    return NULL;
+}
+
+void
+attrd_write_or_elect_attribute(attribute_t *a)
+{
+}
+
+void
+attrd_free_attribute_value(void *data)
+{
+    attribute_value_t *v = data;
+
+    free(v->nodename);
+    free(v->current);
+    free(v);
+}
+
+static attribute_t *
+new_attribute(void)
+{
+    attribute_t *a = pcmk__assert_alloc(1, sizeof(attribute_t));
+
+    a->id = pcmk__str_copy("attr");
+    a->set_type = pcmk__str_copy(PCMK_XE_INSTANCE_ATTRIBUTES);
+    a->values = pcmk__strikey_table(NULL, attrd_free_attribute_value);
+    return a;
+}
+
+static void
+free_attribute(attribute_t *a)
+{
+    g_hash_table_destroy(a->values);
+    free(a->id);
+    free(a->set_type);
+    free(a->set_id);
+    free(a->user);
+    free(a);
+}
+
+static void
+set_value(attribute_t *a, const char *node, const char *value, uint32_t flags)
+{
+    attribute_value_t *v = pcmk__assert_alloc(1, sizeof(attribute_value_t));
+
+    v->nodename = pcmk__str_copy(node);
+    v->current = pcmk__str_copy(value);
+    v->flags = flags;
+    g_hash_table_replace(a->values, v->nodename, v);
+}
+
+// An attribute with two values, as both the writer and a peer might have it
+static attribute_t *
+new_example(void)
+{
+    attribute_t *a = new_attribute();
+
+    a->set_id = pcmk__str_copy("status-set");
+    a->user = pcmk__str_copy("hacluster");
+    a->timeout_ms = 5000;
+    set_value(a, "node1", "1", attrd_value_none);
+    set_value(a, "node2", "2", attrd_value_none);
+    return a;
+}
+
+static void
+assert_digests_equal(const attribute_t *a1, const attribute_t *a2, bool equal)
+{
+    char *digest1 = attrd_attribute_digest(a1);
+    char *digest2 = attrd_attribute_digest(a2);
+
+    assert_non_null(digest1);
+    assert_non_null(digest2);
+    if (equal) {
+        assert_string_equal(digest1, digest2);
+    } else {
+        assert_string_not_equal(digest1, digest2);
+    }
+    free(digest1);
+    free(digest2);
+}
+
+static int
+teardown_test(void **state)
+{
+    attrd_cleanup_xml_ids();
+    return 0;
+}
+
+static void
+no_values(void **state)
+{
+    attribute_t *a = new_attribute();
+
+    assert_null(attrd_attribute_digest(a));
+
+    set_value(a, "node1", NULL, attrd_value_none);
+    assert_null(attrd_attribute_digest(a));
+
+    free_attribute(a);
+}
+
+static void
+same_values(void **state)
+{
+    attribute_t *a1 = new_example();
+    attribute_t *a2 = new_attribute();
+
+    a2->set_id = pcmk__str_copy("status-set");
+    a2->user = pcmk__str_copy("hacluster");
+    a2->timeout_ms = 5000;
+
+    // Order and case don't matter, and unset values are ignored
+    set_value(a2, "NODE2", "2", attrd_value_none);
+    set_value(a2, "node3", NULL, attrd_value_none);
+    set_value(a2, "Node1", "1", attrd_value_none);
+
+    assert_digests_equal(a1, a2, true);
+
+    free_attribute(a1);
+    free_attribute(a2);
+}
+
+static void
+values_differ(void **state)
+{
+    attribute_t *a1 = new_example();
+    attribute_t *a2 = new_example();
+
+    set_value(a2, "node2", "3", attrd_value_none);
+    assert_digests_equal(a1, a2, false);
+
+    set_value(a2, "node2", "2", attrd_value_none);
+    set_value(a2, "node3", "2", attrd_value_none);
+    assert_digests_equal(a1, a2, false);
+
+    g_hash_table_remove(a2->values, "node3");
+    g_hash_table_remove(a2->values, "node2");
+    assert_digests_equal(a1, a2, false);
+
+    // Values swapped between nodes
+    set_value(a2, "node1", "2", attrd_value_none);
+    set_value(a2, "node2", "1", attrd_value_none);
+    assert_digests_equal(a1, a2, false);
+
+    free_attribute(a1);
+    free_attribute(a2);
+}
+
+static void
+settings_differ(void **state)
+{
+    attribute_t *a1 = new_example();
+    attribute_t *a2 = new_example();
+
+    pcmk__str_update(&a2->set_type, PCMK_XE_UTILIZATION);
+    assert_digests_equal(a1, a2, false);
+    pcmk__str_update(&a2->set_type, PCMK_XE_INSTANCE_ATTRIBUTES);
+    assert_digests_equal(a1, a2, true);
+
+    pcmk__str_update(&a2->set_id, "other-set");
+    assert_digests_equal(a1, a2, false);
+    pcmk__str_update(&a2->set_id, NULL);
+    assert_digests_equal(a1, a2, false);
+    pcmk__str_update(&a2->set_id, "status-set");
+
+    pcmk__str_update(&a2->user, "root");
+    assert_digests_equal(a1, a2, false);
+    pcmk__str_update(&a2->user, "hacluster");
+
+    a2->timeout_ms = 10000;
+    assert_digests_equal(a1, a2, false);
+    a2->timeout_ms = 0;
+    assert_digests_equal(a1, a2, false);
+    a2->timeout_ms = 5000;
+
+    attrd_set_attr_flags(a2, attrd_attr_is_private);
+    assert_digests_equal(a1, a2, false);
+    attrd_clear_attr_flags(a2, attrd_attr_is_private);
+
+    assert_digests_equal(a1, a2, true);
+
+    free_attribute(a1);
+    free_attribute(a2);
+}
+
+static void
+remote_flag_differs(void **state)
+{
+    attribute_t *a1 = new_example();
+    attribute_t *a2 = new_example();
+
+    set_value(a2, "node2", "2", attrd_value_remote);
+    assert_digests_equal(a1, a2, false);
+
+    // Other value flags are local bookkeeping and aren't synced
+    set_value(a2, "node2", "2", attrd_value_from_peer);
+    assert_digests_equal(a1, a2, true);
+
+    free_attribute(a1);
+    free_attribute(a2);
+}
+
+static void
+node_xml_id_differs(void **state)
+{
+    attribute_t *a = new_example();
+    char *digest1 = NULL;
+    char *digest2 = NULL;
+
+    digest1 = attrd_attribute_digest(a);
+    attrd_set_node_xml_id("node1", "1");
+    digest2 = attrd_attribute_digest(a);
+    assert_string_not_equal(digest1, digest2);
+    free(digest2);
+
+    attrd_set_node_xml_id("node1", "101");
+    digest2 = attrd_attribute_digest(a);
+    assert_string_not_equal(digest1, digest2);
+    free(digest2);
+
+    attrd_forget_node_xml_id("node1");
+    digest2 = attrd_attribute_digest(a);
+    assert_string_equal(digest1, digest2);
+    free(digest2);
+
+    free(digest1);
+    free_attribute(a);
+}
+
+#define digest_test(fn) \
+    cmocka_unit_test_teardown(fn, teardown_test)
+
+PCMK__UNIT_TEST(NULL, NULL,
+                digest_test(no_values),
+                digest_test(same_values),
+                digest_test(values_differ),
+                digest_test(settings_differ),
+                digest_test(remote_flag_differs),
+                digest_test(node_xml_id_differs))
@@ -0,0 +1,300 @@
+/*
+ * Copyright 2026 the Pacemaker project contributors
+ *
+ * The version control history for this file may have further details.
+ *
+ * This source code is licensed under the GNU General Public License version 2
+ * or later (GPLv2+) WITHOUT ANY WARRANTY.
+ */
+
+#include <crm_internal.h>
+
+#include <crm/common/unittest_internal.h>
+
+// The code under test uses static state, so build it into this test directly
+#include "attrd_messages.c"
+
+/* Stand-ins for the parts of the attribute manager that the code under test
+ * uses. Broadcasts and local updates are recorded as "<name>=<value> ".
+ */
+
+#define LOCAL_NODE "node1"
+
+static pcmk__cluster_private_t fake_priv = {
+    .node_name = (char *) LOCAL_NODE,
+};
+static pcmk_cluster_t fake_cluster = { .priv = &fake_priv, };
+pcmk_cluster_t *attrd_cluster = &fake_cluster;
+
+static pcmk__node_status_t local_node = {
+    .name = (char *) LOCAL_NODE,
+};
+
+static GString *broadcasts = NULL;  // Messages sent to all peers
+static GString *applied = NULL;     // Updates applied locally
+
+static void
+record(GString *buffer, const xmlNode *xml)
+{
+    const char *name = pcmk__xe_get(xml, PCMK__XA_ATTR_NAME);
+
+    if (name == NULL) {
+        name = pcmk__xe_get(xml, PCMK_XA_TASK);
+    }
+    g_string_append_printf(buffer, "%s=%s ", name,
+                           pcmk__s(pcmk__xe_get(xml, PCMK__XA_ATTR_VALUE),
+                                   ""));
+}
+
+bool
+pcmk__cluster_send_message(const pcmk__node_status_t *node,
+                           enum pcmk_ipc_server service, const xmlNode *data)
+{
+    assert_null(node);
+    record(broadcasts, data);
+    return true;
+}
+
+pcmk__node_status_t *
+pcmk__get_node(unsigned int id, const char *uname, const char *xml_id,
+               uint32_t flags)
+{
+    assert_string_equal(uname, LOCAL_NODE);
+    return &local_node;
+}
+
+void
+attrd_peer_update(const pcmk__node_status_t *peer, xmlNode *xml,
+                  const char *host, bool filter)
+{
+    assert_ptr_equal(peer, &local_node);
+    assert_string_equal(host, LOCAL_NODE);
+    record(applied, xml);
+
+    // The real function may modify the XML
+    pcmk__xe_remove_attr(xml, PCMK__XA_ATTR_VALUE);
+}
+
+bool
+attrd_request_has_sync_point(xmlNode *xml)
+{
+    return pcmk__xe_get(xml, PCMK__XA_ATTR_SYNC_POINT) != NULL;
+}
+
+void
+attrd_xml_add_writer(xmlNode *xml)
+{
+}
+
+// Request handlers that the tests don't reach
+
+bool
+attrd_check_for_new_writer(const pcmk__node_status_t *peer, const xmlNode *xml)
+{
+    return false;
+}
+
+void
+attrd_add_client_to_waitlist(pcmk__request_t *request)
+{
+}
+
+void
+attrd_client_clear_failure(pcmk__request_t *request)
+{
+}
+
+void
+attrd_client_peer_remove(pcmk__request_t *request)
+{
+}
+
+void
+attrd_client_refresh(pcmk__request_t *request)
+{
+}
+
+void
+attrd_client_update(pcmk__request_t *request)
+{
+}
+
+xmlNode *
+attrd_client_query(pcmk__request_t *request)
+{
+    return NULL;
+}
+
+void
+attrd_handle_confirmation(int callid, const char *host)
+{
+}
+
+void
+attrd_peer_clear_failure(pcmk__request_t *request)
+{
+}
+
+void
+attrd_peer_remove(const char *host, bool uncache, const char *source)
+{
+}
+
+void
+attrd_peer_sync_response(const pcmk__node_status_t *peer, bool peer_won,
+                         xmlNode *xml)
+{
+}
+
+void
+attrd_peer_sync_summary(pcmk__node_status_t *peer, bool peer_won,
+                        const xmlNode *xml)
+{
+}
+
+void
+attrd_peer_sync_request(pcmk__node_status_t *peer, const xmlNode *xml)
+{
+}
+
+static int
+setup_test(void **state)
+{
+    broadcasts = g_string_new(NULL);
+    applied = g_string_new(NULL);
+    return 0;
+}
+
+static int
+teardown_test(void **state)
+{
+    attrd_free_pending_updates();
+    g_string_free(broadcasts, TRUE);
+    g_string_free(applied, TRUE);
+    return 0;
+}
+
+static void
+send_update(const char *name, const char *value, const char *dampening,
+            bool sync_point)
+{
+    xmlNode *xml = pcmk__xe_create(NULL, __func__);
+
+    pcmk__xe_set(xml, PCMK_XA_TASK, PCMK__ATTRD_CMD_UPDATE);
+    pcmk__xe_set(xml, PCMK__XA_ATTR_NAME, name);
+    pcmk__xe_set(xml, PCMK__XA_ATTR_VALUE, value);
+    pcmk__xe_set(xml, PCMK__XA_ATTR_HOST, LOCAL_NODE);
+    pcmk__xe_set(xml, PCMK__XA_ATTR_DAMPENING, dampening);
+    if (sync_point) {
+        pcmk__xe_set(xml, PCMK__XA_ATTR_SYNC_POINT, PCMK__VALUE_LOCAL);
+    }
+
+    attrd_send_update(xml);
+    pcmk__xml_free(xml);
+}
+
+// Act as if the merge window ended
+static void
+end_window(void)
+{
+    merge_timer_cb(NULL);
+}
+
+static void
+first_update_not_held(void **state)
+{
+    send_update("x", "1", NULL, false);
+
+    // It's applied locally when the broadcast is delivered back to us
+    assert_string_equal(broadcasts->str, "x=1 ");
+    assert_string_equal(applied->str, "");
+}
+
+static void
+held_update_applied_locally(void **state)
+{
+    send_update("x", "1", NULL, false);
+    send_update("x", "2", NULL, false);
+
+    assert_string_equal(broadcasts->str, "x=1 ");
+    assert_string_equal(applied->str, "x=2 ");
+
+    end_window();
+    assert_string_equal(broadcasts->str, "x=1 x=2 ");
+}
+
+static void
+later_update_replaces_held(void **state)
+{
+    send_update("x", "1", NULL, false);
+    send_update("x", "2", NULL, false);
+    send_update("y", "1", NULL, false);
+    send_update("x", "3", NULL, false);
+    send_update("x", NULL, NULL, false);
+    send_update("x", "4", NULL, false);
+
+    assert_string_equal(broadcasts->str, "x=1 ");
+    assert_string_equal(applied->str, "x=2 y=1 x=3 x= x=4 ");
+
+    // Each value is broadcast once, in the order it was first held
+    end_window();
+    assert_string_equal(broadcasts->str, "x=1 x=4 y=1 ");
+
+    // Nothing is left to broadcast
+    end_window();
+    assert_string_equal(broadcasts->str, "x=1 x=4 y=1 ");
+}
+
+static void
+incompatible_update_not_merged(void **state)
+{
+    send_update("x", "1", NULL, false);
+    send_update("x", "2", NULL, false);
+
+    // A different delay can't be merged, so peers get both in order
+    send_update("x", "3", "5s", false);
+    assert_string_equal(broadcasts->str, "x=1 x=2 ");
+    assert_string_equal(applied->str, "x=2 x=3 ");
+
+    end_window();
+    assert_string_equal(broadcasts->str, "x=1 x=2 x=3 ");
+}
+
+static void
+sync_point_not_held(void **state)
+{
+    send_update("x", "1", NULL, false);
+    send_update("y", "1", NULL, false);
+
+    // The client waits for this, so it is sent (after held updates) right away
+    send_update("x", "2", NULL, true);
+    assert_string_equal(broadcasts->str, "x=1 y=1 x=2 ");
+    assert_string_equal(applied->str, "y=1 ");
+}
+
+static void
+other_broadcast_flushes_held(void **state)
+{
+    xmlNode *xml = pcmk__xe_create(NULL, __func__);
+
+    send_update("x", "1", NULL, false);
+    send_update("x", "2", NULL, false);
+
+    pcmk__xe_set(xml, PCMK_XA_TASK, PCMK__ATTRD_CMD_PEER_REMOVE);
+    attrd_send_message(NULL, xml, false);
+    pcmk__xml_free(xml);
+
+    assert_string_equal(broadcasts->str,
+                        "x=1 x=2 " PCMK__ATTRD_CMD_PEER_REMOVE "= ");
+}
+
+#define update_test(fn) \
+    cmocka_unit_test_setup_teardown(fn, setup_test, teardown_test)
+
+PCMK__UNIT_TEST(pcmk__xml_test_setup_group, pcmk__xml_test_teardown_group,
+                update_test(first_update_not_held),
+                update_test(held_update_applied_locally),
+                update_test(later_update_replaces_held),
+                update_test(incompatible_update_not_merged),
+                update_test(sync_point_not_held),
+                update_test(other_broadcast_flushes_held))
@@ -116,6 +116,7 @@ based_callbacks_cleanup(void)
 {
     g_clear_pointer(&digest_timer, mainloop_timer_del);
     g_clear_pointer(&ping_digest, free);
+    based_query_cache_clear();
 }
 
 /*!
@@ -162,9 +163,21 @@ create_cib_reply(const xmlNode *request, int rc, xmlNode *call_data)
     return reply;
 }
 
+/*!
+ * \internal
+ * \brief Send a request result to the local client that sent the request
+ *
+ * \param[in] xml         Reply (or request, if not processed) to send
+ * \param[in] snapshot    If not \c NULL, serialized CIB to send as the reply's
+ *                        call data (\p xml must have none, and the client
+ *                        must be an IPC client)
+ * \param[in] client_id   ID of client to notify
+ * \param[in] sync_reply  Whether the request was synchronous
+ * \param[in] from_peer   Whether the request was delegated from a peer
+ */
 static void
-do_local_notify(const xmlNode *xml, const char *client_id, bool sync_reply,
-                bool from_peer)
+do_local_notify(const xmlNode *xml, const GString *snapshot,
+                const char *client_id, bool sync_reply, bool from_peer)
 {
     int call_id = 0;
     int rc = pcmk_rc_ok;
@@ -206,7 +219,15 @@ do_local_notify(const xmlNode *xml, const char *client_id, bool sync_reply,
 
     switch (PCMK__CLIENT_TYPE(client)) {
         case pcmk__client_ipc:
-            rc = pcmk__ipc_send_xml(client, call_id, xml, flags);
+            if (snapshot != NULL) {
+                GString *text = based_query_reply_text(xml, snapshot);
+
+                rc = pcmk__ipc_send_string(client, call_id, text, flags);
+                g_string_free(text, TRUE);
+
+            } else {
+                rc = pcmk__ipc_send_xml(client, call_id, xml, flags);
+            }
             break;
         case pcmk__client_tls:
         case pcmk__client_tcp:
@@ -564,6 +585,7 @@ based_perform_op_rw(xmlNode *request, const cib__operation_t *operation,
 
     if (cib_diff != NULL) {
         ping_modified_since = true;
+        based_query_cache_clear();
     }
 
     mainloop_timer_start(digest_timer);
@@ -694,6 +716,7 @@ based_process_request(xmlNode *request, bool privileged,
     cib__op_fn_t op_function = NULL;
 
     xmlNode *output = NULL;
+    const GString *snapshot = NULL;
     time_t start_time = 0;
 
     rc = pcmk__xe_get_flags(request, PCMK__XA_CIB_CALLOPT, &call_options,
@@ -793,8 +816,16 @@ based_process_request(xmlNode *request, bool privileged,
 
     start_time = time(NULL);
 
-    if (!privileged
-        && pcmk__is_set(operation->flags, cib__op_attr_privileged)) {
+    if (local_notify && based_query_cacheable(request, operation, client)) {
+        snapshot = based_query_snapshot();
+    }
+
+    if (snapshot != NULL) {
+        // The reply's call data will be filled in from the snapshot
+        rc = pcmk_rc_ok;
+
+    } else if (!privileged
+               && pcmk__is_set(operation->flags, cib__op_attr_privileged)) {
 
         rc = EACCES;
 
@@ -823,7 +854,7 @@ done:
     }
 
     if (local_notify && (client_id != NULL)) {
-        do_local_notify((process? reply : request), client_id,
+        do_local_notify((process? reply : request), snapshot, client_id,
                         pcmk__is_set(call_options, cib_sync_call),
                         (client == NULL));
     }
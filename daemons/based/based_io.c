@@ -23,7 +23,7 @@
 #include <unistd.h>                 // _exit, fork
 
 #include <glib.h>                   // g_*, G_*
-#include <libxml/tree.h>            // xmlNode
+#include <libxml/tree.h>            // xmlNode, xmlUnlinkNode
 #include <qb/qbdefs.h>              // QB_FALSE, QB_TRUE
 #include <qb/qblog.h>               // qb_log_*
 
@@ -91,6 +91,7 @@ write_cib_async(void *user_data)
 {
     int rc = pcmk_rc_ok;
     pid_t pid = 0;
+    xmlNode *status = NULL;
     int blackbox_state = qb_log_ctl(QB_LOG_BLACKBOX, QB_LOG_CONF_STATE_GET, 0);
 
     /* Disable blackbox logging before the fork to avoid two processes writing
@@ -125,6 +126,18 @@ write_cib_async(void *user_data)
         return -1;
     }
 
+    /* The status section is not written to disk, and the writer would free it.
+     * In a large cluster, it can be most of the CIB, and freeing it would touch
+     * (and thus force the kernel to copy) every page it occupies, even though
+     * this child never needs it. Detach it instead, leaving an empty status
+     * section for the writer to discard.
+     */
+    status = pcmk__xe_first_child(based_cib, PCMK_XE_STATUS, NULL, NULL);
+    if (status != NULL) {
+        xmlUnlinkNode(status);
+        pcmk__xe_create(based_cib, PCMK_XE_STATUS);
+    }
+
     /* Write the CIB. Note that this modifies based_cib, but this child is about
      * to exit. The parent's copy of based_cib won't be affected.
      */
@@ -630,6 +643,7 @@ based_activate_cib(xmlNode *new_cib, bool to_disk, const char *op)
 
     pcmk__xml_free(based_cib);
     based_cib = new_cib;
+    based_query_cache_clear();
 
     if (to_disk && writes_enabled && (cib_status == pcmk_rc_ok)) {
         pcmk__debug("Triggering CIB write for %s op", op);
@@ -13,15 +13,13 @@
 #include <inttypes.h>               // PRIx64
 #include <stdbool.h>
 #include <stddef.h>                 // NULL
-#include <stdint.h>                 // int32_t, uint16_t, UINT64_C
-#include <sys/types.h>              // ssize_t
+#include <stdint.h>                 // uint16_t, UINT64_C
 
 #include <glib.h>                   // g_*, etc.
 #include <libxml/tree.h>            // xmlNode
 #include <qb/qblog.h>               // QB_XS
 
 #include <crm/common/internal.h>    // pcmk__client_t, etc.
-#include <crm/common/ipc.h>         // pcmk_free_ipc_event
 #include <crm/common/logging.h>     // CRM_LOG_ASSERT
 #include <crm/common/results.h>     // pcmk_rc_*
 
@@ -29,8 +27,9 @@
 
 struct cib_notification_s {
     const xmlNode *msg;
-    struct iovec *iov;
-    int32_t iov_size;
+    pcmk__ipc_event_t *event;       // IPC event shared by all IPC clients
+    pcmk__remote_msg_t *remote_msg; // Encoded message for all remote clients
+    bool remote_failed;             // Whether encoding remote_msg failed
 };
 
 /*!
@@ -131,13 +130,13 @@ cib_notify_send_one(void *key, void *value, void *user_data)
 
     switch (PCMK__CLIENT_TYPE(client)) {
         case pcmk__client_ipc:
-            rc = pcmk__ipc_send_iov(client, update->iov,
-                                    crm_ipc_server_event);
+            // All clients' queues share the same event without copying it
+            rc = pcmk__ipc_send_shared_event(client, update->event);
 
             /* EAGAIN isn't an error for server events.  Sending did fail
-             * with EAGAIN, but the iov was added to the send queue and we
-             * will attempt to send it again the next time pcmk__ipc_send_iov
-             * is called, or when crm_ipcs_flush_events_cb happens.
+             * with EAGAIN, but the event was added to the send queue and we
+             * will attempt to send it again the next time the queue is
+             * flushed.
              */
             if ((rc != EAGAIN) && (rc != pcmk_rc_ok)) {
                 pcmk__warn("Could not notify client %s: %s " QB_XS " id=%s",
@@ -148,9 +147,23 @@ cib_notify_send_one(void *key, void *value, void *user_data)
 
         case pcmk__client_tls:
         case pcmk__client_tcp:
+            // Serialize and compress only once, for the first remote client
+            if ((update->remote_msg == NULL) && !update->remote_failed) {
+                rc = pcmk__remote_prepare_xml(update->msg,
+                                              &(update->remote_msg));
+                if (rc != pcmk_rc_ok) {
+                    pcmk__warn("Could not encode notification for remote "
+                               "clients: %s", pcmk_rc_str(rc));
+                    update->remote_failed = true;
+                }
+            }
+            if (update->remote_msg == NULL) {
+                break;
+            }
+
             pcmk__debug("Sent %s notification to client %s (id %s)", type,
                         pcmk__client_name(client), client->id);
-            pcmk__remote_send_xml(client->remote, update->msg);
+            pcmk__remote_send_prepared(client->remote, update->remote_msg);
             break;
 
         default:
@@ -164,9 +177,8 @@ static void
 cib_notify_send(const xmlNode *xml)
 {
     struct iovec *iov;
-    struct cib_notification_s update;
+    struct cib_notification_s update = { .msg = xml, };
     GString *iov_buffer = NULL;
-    ssize_t bytes = 0;
     int rc = pcmk_rc_ok;
     uint16_t index = 0;
 
@@ -174,7 +186,7 @@ cib_notify_send(const xmlNode *xml)
     pcmk__xml_string(xml, 0, iov_buffer, 0);
 
     do {
-        rc = pcmk__ipc_prepare_iov(0, iov_buffer, index, &iov, &bytes);
+        rc = pcmk__ipc_prepare_iov(0, iov_buffer, index, &iov, NULL);
 
         if ((rc != pcmk_rc_ok) && (rc != pcmk_rc_ipc_more)) {
             pcmk__notice("Could not notify clients: %s " QB_XS " rc=%d",
@@ -182,11 +194,9 @@ cib_notify_send(const xmlNode *xml)
             break;
         }
 
-        update.msg = xml;
-        update.iov = iov;
-        update.iov_size = bytes;
+        update.event = pcmk__ipc_new_shared_event(iov);
         pcmk__foreach_ipc_client(cib_notify_send_one, &update);
-        pcmk_free_ipc_event(iov);
+        pcmk__ipc_unref_event(update.event);
 
         if (rc == pcmk_rc_ok) {
             break;
@@ -195,6 +205,7 @@ cib_notify_send(const xmlNode *xml)
         index++;
     } while (true);
 
+    pcmk__remote_free_prepared(update.remote_msg);
     g_string_free(iov_buffer, TRUE);
 }
 
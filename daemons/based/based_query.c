@@ -0,0 +1,185 @@
+/*
+ * Copyright 2026 the Pacemaker project contributors
+ *
+ * The version control history for this file may have further details.
+ *
+ * This source code is licensed under the GNU General Public License version 2
+ * or later (GPLv2+) WITHOUT ANY WARRANTY.
+ */
+
+#include <crm_internal.h>
+
+#include <stdbool.h>
+#include <stddef.h>                 // NULL
+#include <stdint.h>                 // uint32_t
+#include <stdlib.h>                 // free
+
+#include <glib.h>                   // GString, g_*
+#include <libxml/tree.h>            // xmlNode
+
+#include <crm/cib.h>                // cib_call_options values
+#include <crm/cib/internal.h>       // cib__*
+#include <crm/common/internal.h>    // pcmk__client_t, pcmk__xe_*, etc.
+#include <crm/common/logging.h>     // CRM_CHECK
+#include <crm/common/xml.h>         // PCMK_XA_*
+
+#include "pacemaker-based.h"
+
+/* Full-CIB queries are by far the most common requests from local clients
+ * (crm_mon, crm_resource, the controller, the fencer, etc.), and answering one
+ * means copying the entire live CIB into the reply and then serializing it.
+ * Instead, we keep the serialized CIB from the first such query and reuse it
+ * until the CIB changes.
+ *
+ * Only the unfiltered CIB is cached. A user subject to ACLs is answered the
+ * usual way, with the CIB filtered for that request. What such a user may see
+ * depends on their group membership and roles, which can change without any
+ * change to the CIB.
+ */
+static GString *snapshot = NULL;
+
+// CIB version ("<admin_epoch>.<epoch>.<num_updates>") of current snapshot
+static char *snapshot_version = NULL;
+
+/*!
+ * \internal
+ * \brief Discard the cached CIB query snapshot
+ *
+ * This must be called whenever the live CIB might have changed.
+ */
+void
+based_query_cache_clear(void)
+{
+    if (snapshot != NULL) {
+        g_string_free(snapshot, TRUE);
+        snapshot = NULL;
+    }
+    g_clear_pointer(&snapshot_version, free);
+}
+
+/*!
+ * \internal
+ * \brief Check whether a request can be answered from a CIB query snapshot
+ *
+ * Only queries of the entire CIB from local IPC clients qualify, and only if
+ * ACLs do not apply to the requesting user.
+ *
+ * \param[in] request    CIB request
+ * \param[in] operation  Operation info for \p request
+ * \param[in] client     Client that sent \p request (\c NULL for a peer)
+ *
+ * \return \c true if \p request can be answered from a snapshot, otherwise
+ *         \c false
+ */
+bool
+based_query_cacheable(const xmlNode *request,
+                      const cib__operation_t *operation,
+                      const pcmk__client_t *client)
+{
+    uint32_t call_options = cib_none;
+    const char *section = NULL;
+
+    if ((operation->type != cib__op_query) || (client == NULL)
+        || (PCMK__CLIENT_TYPE(client) != pcmk__client_ipc)) {
+        return false;
+    }
+
+    pcmk__xe_get_flags(request, PCMK__XA_CIB_CALLOPT, &call_options,
+                       cib_none);
+    if (pcmk__any_flags_set(call_options,
+                            cib_xpath|cib_no_children|cib_transaction
+                            |cib_discard_reply)) {
+        return false;
+    }
+
+    section = pcmk__xe_get(request, PCMK__XA_CIB_SECTION);
+    if ((section != NULL)
+        && !pcmk__str_eq(section, PCMK__XE_ALL, pcmk__str_casei)) {
+        return false;
+    }
+
+    return !cib__acl_enabled(based_cib,
+                             pcmk__xe_get(request, PCMK__XA_CIB_USER));
+}
+
+/*!
+ * \internal
+ * \brief Get the serialized live CIB
+ *
+ * \return Serialized CIB (owned by the cache and valid until the next call to
+ *         this function or to \c based_query_cache_clear()), or \c NULL if the
+ *         CIB is unavailable
+ *
+ * \note The result is not filtered for ACLs. Callers must check
+ *       \c based_query_cacheable() first.
+ */
+const GString *
+based_query_snapshot(void)
+{
+    char *version = NULL;
+
+    if (based_cib == NULL) {
+        return NULL;
+    }
+
+    /* Explicit invalidation should be enough, but comparing versions costs
+     * next to nothing and guards against any in-place change we don't hear of
+     */
+    version = pcmk__assert_asprintf("%s.%s.%s",
+                                    pcmk__xe_get(based_cib,
+                                                 PCMK_XA_ADMIN_EPOCH),
+                                    pcmk__xe_get(based_cib, PCMK_XA_EPOCH),
+                                    pcmk__xe_get(based_cib,
+                                                 PCMK_XA_NUM_UPDATES));
+    if (!pcmk__str_eq(version, snapshot_version, pcmk__str_none)) {
+        based_query_cache_clear();
+        snapshot_version = version;
+    } else {
+        free(version);
+    }
+
+    if (snapshot != NULL) {
+        pcmk__trace("Using cached CIB %s snapshot", snapshot_version);
+        return snapshot;
+    }
+
+    snapshot = g_string_sized_new(4096);
+    pcmk__xml_string(based_cib, 0, snapshot, 0);
+
+    pcmk__trace("Caching CIB %s snapshot (%zu bytes)", snapshot_version,
+                snapshot->len);
+    return snapshot;
+}
+
+/*!
+ * \internal
+ * \brief Serialize a query reply with a CIB snapshot as its call data
+ *
+ * The result is the same as serializing \p reply after adding the snapshotted
+ * CIB with \c cib__set_calldata(), without copying the CIB XML.
+ *
+ * \param[in] reply     Query reply without call data
+ * \param[in] snapshot  Snapshot from \c based_query_snapshot()
+ *
+ * \return Newly allocated buffer containing the serialized reply
+ *
+ * \note The caller is responsible for freeing the return value using
+ *       \c g_string_free().
+ */
+GString *
+based_query_reply_text(const xmlNode *reply, const GString *snapshot)
+{
+    GString *text = g_string_sized_new(snapshot->len + 1024);
+
+    pcmk__xml_string(reply, 0, text, 0);
+
+    // The reply has no children, so it was serialized as "<name .../>"
+    CRM_CHECK(g_str_has_suffix(text->str, "/>"), return text);
+    g_string_truncate(text, text->len - 2);
+
+    g_string_append(text, "><" PCMK__XE_CIB_CALLDATA ">");
+    g_string_append_len(text, snapshot->str, snapshot->len);
+    pcmk__g_strcat(text, "</" PCMK__XE_CIB_CALLDATA "></",
+                   (const char *) reply->name, ">", NULL);
+    return text;
+}
@@ -0,0 +1,28 @@
+/*
+ * Copyright 2026 the Pacemaker project contributors
+ *
+ * The version control history for this file may have further details.
+ *
+ * This source code is licensed under the GNU General Public License version 2
+ * or later (GPLv2+) WITHOUT ANY WARRANTY.
+ */
+
+#ifndef BASED_QUERY__H
+#define BASED_QUERY__H
+
+#include <stdbool.h>
+
+#include <glib.h>                       // GString
+#include <libxml/tree.h>                // xmlNode
+
+#include <crm/cib/internal.h>           // cib__operation_t
+#include <crm/common/internal.h>        // pcmk__client_t
+
+bool based_query_cacheable(const xmlNode *request,
+                           const cib__operation_t *operation,
+                           const pcmk__client_t *client);
+const GString *based_query_snapshot(void);
+GString *based_query_reply_text(const xmlNode *reply, const GString *snapshot);
+void based_query_cache_clear(void);
+
+#endif // BASED_QUERY__H
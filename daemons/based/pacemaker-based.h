@@ -23,6 +23,7 @@
 #include "based_messages.h"
 #include "based_operation.h"
 #include "based_notify.h"
+#include "based_query.h"
 #include "based_remote.h"
 #include "based_transaction.h"
 
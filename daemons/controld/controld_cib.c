@@ -18,9 +18,6 @@
 
 #include <pacemaker-controld.h>
 
-// Call ID of the most recent in-progress CIB resource update (or 0 if none)
-static int pending_rsc_update = 0;
-
 /*!
  * \internal
  * \brief Respond to a dropped CIB connection
@@ -104,6 +101,8 @@ controld_disconnect_cib_manager(void)
 
     pcmk__debug("Disconnecting from the CIB manager");
 
+    controld_stop_resource_history();
+
     controld_clear_fsa_input_flags(R_CIB_CONNECTED);
 
     cib_conn->cmds->del_notify_callback(cib_conn, PCMK__VALUE_CIB_DIFF_NOTIFY,
@@ -134,11 +133,15 @@ do_cib_control(long long action, enum crmd_fsa_cause cause,
     pcmk__assert(cib_conn != NULL);
 
     if (pcmk__is_set(action, A_CIB_STOP)) {
+        if (cib_conn->state != cib_disconnected) {
+            controld_flush_resource_history();
+        }
+
         if ((cib_conn->state != cib_disconnected)
-            && (pending_rsc_update != 0)) {
+            && (controld_pending_history_update() != 0)) {
 
             pcmk__info("Waiting for resource update %d to complete",
-                       pending_rsc_update);
+                       controld_pending_history_update());
             controld_fsa_stall(msg_data, action);
             return;
         }
@@ -333,6 +336,8 @@ controld_delete_node_history(const char *uname, bool unlocked_only, int options)
     controld_node_history_deletion_strings(uname, unlocked_only, &xpath, &desc);
     cib__set_call_options(options, "node state deletion",
                           cib_xpath|cib_multiple);
+    controld_flush_resource_history();
+    controld_supersede_resource_history(uname, NULL);
     cib_rc = cib->cmds->remove(cib, xpath, NULL, options);
     fsa_register_cib_callback(cib_rc, desc, cib_delete_callback);
     pcmk__info("Deleting %s (via CIB call %d) " QB_XS " xpath=%s", desc, cib_rc,
@@ -382,6 +387,8 @@ controld_delete_resource_history(const char *rsc_id, const char *node,
     // Ask CIB to delete the entry
     xpath = pcmk__assert_asprintf(XPATH_RESOURCE_HISTORY, node, rsc_id);
 
+    controld_flush_resource_history();
+    controld_supersede_resource_history(node, rsc_id);
     cib->cmds->set_user(cib, user_name);
     rc = cib->cmds->remove(cib, xpath, NULL, call_options|cib_xpath);
     cib->cmds->set_user(cib, NULL);
@@ -724,28 +731,6 @@ controld_record_pending_op(const char *node_name, const lrmd_rsc_info_t *rsc,
     return true;
 }
 
-static void
-cib_rsc_callback(xmlNode * msg, int call_id, int rc, xmlNode * output, void *user_data)
-{
-    if (rc == pcmk_ok) {
-        pcmk__trace("Resource history update completed (call=%d rc=%d)",
-                    call_id, rc);
-
-    } else if (call_id > 0) {
-        pcmk__warn("Resource history update %d failed: %s " QB_XS " rc=%d",
-                   call_id, pcmk_strerror(rc), rc);
-
-    } else {
-        pcmk__warn("Resource history update failed: %s " QB_XS " rc=%d",
-                   pcmk_strerror(rc), rc);
-    }
-
-    if (call_id == pending_rsc_update) {
-        pending_rsc_update = 0;
-        controld_trigger_fsa();
-    }
-}
-
 /* Only successful stops, and probes that found the resource inactive, get locks
  * recorded in the history. This ensures the resource stays locked to the node
  * until it is active there again after the node comes back up.
@@ -777,8 +762,7 @@ should_preserve_lock(const lrmd_event_data_t *op)
  *
  * \return Standard Pacemaker return code
  *
- * \note If \p callback is \p cib_rsc_callback(), the CIB update's call ID is
- *       stored in \p pending_rsc_update on success.
+ * \note Any queued resource history updates are sent first.
  */
 int
 controld_update_cib(const char *section, xmlNode *data, int options,
@@ -789,6 +773,8 @@ controld_update_cib(const char *section, xmlNode *data, int options,
 
     pcmk__assert(data != NULL);
 
+    controld_flush_resource_history();
+
     if (cib != NULL) {
         cib_rc = cib->cmds->modify(cib, section, data, options);
         if (cib_rc >= 0) {
@@ -804,13 +790,6 @@ controld_update_cib(const char *section, xmlNode *data, int options,
         }
 
     } else {
-        if ((cib_rc >= 0) && (callback == cib_rsc_callback)) {
-            /* Checking for a particular callback is a little hacky, but it
-             * didn't seem worth adding an output argument for cib_rc for just
-             * one use case.
-             */
-            pending_rsc_update = cib_rc;
-        }
         fsa_register_cib_callback(cib_rc, NULL, callback);
     }
 
@@ -826,8 +805,8 @@ controld_update_cib(const char *section, xmlNode *data, int options,
  * \param[in,out] op         Action to record
  * \param[in]     lock_time  If nonzero, when resource was locked to node
  *
- * \note On success, the CIB update's call ID will be stored in
- *       pending_rsc_update.
+ * \note The update is queued and sent later by
+ *       \c controld_flush_resource_history().
  */
 void
 controld_update_resource_history(const char *node_name,
@@ -836,7 +815,6 @@ controld_update_resource_history(const char *node_name,
 {
     xmlNode *update = NULL;
     xmlNode *xml = NULL;
-    int call_opt = crmd_cib_smart_opt();
     const char *node_id = NULL;
     const char *container = NULL;
 
@@ -903,8 +881,7 @@ controld_update_resource_history(const char *node_name,
      * fenced for running a resource it isn't.
      */
     pcmk__log_xml_trace(update, __func__);
-    controld_update_cib(PCMK_XE_STATUS, update, call_opt, cib_rsc_callback);
-    pcmk__xml_free(update);
+    controld_queue_resource_history(update, op, node_name);
 }
 
 /*!
@@ -917,9 +894,15 @@ void
 controld_delete_action_history(const lrmd_event_data_t *op)
 {
     xmlNode *xml_top = NULL;
+    const char *node_name = NULL;
 
     CRM_CHECK(op != NULL, return);
 
+    node_name = op->remote_nodename;
+    if (node_name == NULL) {
+        node_name = controld_globals.cluster->priv->node_name;
+    }
+
     xml_top = pcmk__xe_create(NULL, PCMK__XE_LRM_RSC_OP);
     pcmk__xe_set_int(xml_top, PCMK__XA_CALL_ID, op->call_id);
     pcmk__xe_set(xml_top, PCMK__XA_TRANSITION_KEY, op->user_data);
@@ -936,6 +919,8 @@ controld_delete_action_history(const lrmd_event_data_t *op)
                 " (call=%d)",
                 op->rsc_id, op->op_type, op->interval_ms, op->call_id);
 
+    controld_flush_resource_history();
+    controld_supersede_resource_history(node_name, op->rsc_id);
     controld_globals.cib_conn->cmds->remove(controld_globals.cib_conn,
                                             PCMK_XE_STATUS, xml_top, cib_none);
     pcmk__log_xml_trace(xml_top, "op:cancel");
@@ -992,6 +977,8 @@ controld_cib_delete_last_failure(const char *rsc_id, const char *node,
     }
     free(last_failure_key);
 
+    controld_flush_resource_history();
+    controld_supersede_resource_history(node, rsc_id);
     controld_globals.cib_conn->cmds->remove(controld_globals.cib_conn, xpath,
                                             NULL, cib_xpath);
     free(xpath);
@@ -1020,6 +1007,8 @@ controld_delete_action_history_by_key(const char *rsc_id, const char *node,
     } else {
         xpath = pcmk__assert_asprintf(XPATH_HISTORY_ID, node, rsc_id, key);
     }
+    controld_flush_resource_history();
+    controld_supersede_resource_history(node, rsc_id);
     controld_globals.cib_conn->cmds->remove(controld_globals.cib_conn, xpath,
                                             NULL, cib_xpath);
     free(xpath);
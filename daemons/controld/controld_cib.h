@@ -20,11 +20,17 @@
 #include <crm/cib/internal.h>   // cib__*
 #include "controld_globals.h"   // controld_globals.cib_conn
 
+void controld_flush_resource_history(void);
+void controld_supersede_resource_history(const char *node, const char *rsc_id);
+int controld_pending_history_update(void);
+void controld_stop_resource_history(void);
+
 static inline void
 fsa_cib_anon_update(const char *section, xmlNode *data) {
     if (controld_globals.cib_conn == NULL) {
         pcmk__err("No CIB connection available");
     } else {
+        controld_flush_resource_history();
         controld_globals.cib_conn->cmds->modify(controld_globals.cib_conn,
                                                 section, data, cib_can_create);
     }
@@ -35,6 +41,7 @@ fsa_cib_anon_update_discard_reply(const char *section, xmlNode *data) {
     if (controld_globals.cib_conn == NULL) {
         pcmk__err("No CIB connection available");
     } else {
+        controld_flush_resource_history();
         controld_globals.cib_conn->cmds->modify(controld_globals.cib_conn,
                                                 section, data,
                                                 cib_can_create
@@ -79,6 +86,8 @@ bool controld_record_pending_op(const char *node_name,
                                 const lrmd_rsc_info_t *rsc,
                                 lrmd_event_data_t *op);
 
+void controld_queue_resource_history(xmlNode *xml, const lrmd_event_data_t *op,
+                                     const char *node);
 void controld_update_resource_history(const char *node_name,
                                       const lrmd_rsc_info_t *rsc,
                                       lrmd_event_data_t *op, time_t lock_time);
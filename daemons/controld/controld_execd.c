@@ -1430,6 +1430,8 @@ controld_invoke_execd(fsa_data_t *msg_data)
     from_sys = pcmk__xe_get(input->msg, PCMK__XA_CRM_SYS_FROM);
     if (!pcmk__str_eq(from_sys, CRM_SYSTEM_TENGINE, pcmk__str_none)) {
         from_host = pcmk__xe_get(input->msg, PCMK__XA_SRC);
+    } else {
+        throttle_set_window(input->msg);
     }
 
     if (pcmk__str_eq(crm_op, PCMK_ACTION_LRM_DELETE, pcmk__str_none)) {
@@ -2022,6 +2024,9 @@ do_lrm_rsc_op(lrm_state_t *lrm_state, lrmd_rsc_info_t *rsc, xmlNode *msg,
         pending->user_data = pcmk__str_copy(op->user_data);
         pcmk__xe_get_time(msg, PCMK_OPT_SHUTDOWN_LOCK, &pending->lock_time);
         g_hash_table_replace(lrm_state->active_ops, call_id_s, pending);
+        if (op->interval_ms == 0) {
+            throttle_queue_changed(1);
+        }
 
         if ((op->interval_ms > 0)
             && (op->start_delay > START_DELAY_THRESHOLD)) {
@@ -2365,6 +2370,7 @@ process_lrm_event(lrm_state_t *lrm_state, lrmd_event_data_t *op,
             pcmk__trace("Op %s (call=%d, stop-id=%s, remaining=%u): Confirmed",
                         op_key, op->call_id, op_id,
                         g_hash_table_size(lrm_state->active_ops));
+            throttle_queue_changed(-1);
         }
     }
 
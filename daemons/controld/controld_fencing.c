@@ -245,6 +245,7 @@ update_node_state_after_fencing(const char *target, const char *target_xml_id)
         free(now_s);
     }
 
+    controld_flush_resource_history();
     rc = controld_globals.cib_conn->cmds->modify(controld_globals.cib_conn,
                                                  PCMK_XE_STATUS, node_state,
                                                  cib_can_create);
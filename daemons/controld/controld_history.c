@@ -0,0 +1,448 @@
+/*
+ * Copyright 2026 the Pacemaker project contributors
+ *
+ * The version control history for this file may have further details.
+ *
+ * This source code is licensed under the GNU General Public License version 2
+ * or later (GPLv2+) WITHOUT ANY WARRANTY.
+ */
+
+#include <crm_internal.h>
+
+#include <stdbool.h>
+#include <string.h>                 // strchr, strndup
+
+#include <glib.h>
+
+#include <crm/common/xml.h>
+#include <crm/crm.h>
+#include <crm/lrmd_internal.h>
+
+#include <pacemaker-controld.h>
+
+/* After a mass start or a large transition, the executor reports many results
+ * in quick succession. Rather than send a CIB modification for each one (each
+ * costing the CIB manager ACL checks, a patchset, digests, and a cluster
+ * broadcast), resource history updates are queued and sent together in a
+ * single CIB transaction once the burst of events has been dispatched, or
+ * sooner if the queue grows long.
+ *
+ * Any other CIB write by the controller flushes the queue first, so that
+ * updates reach the CIB in the order they were made.
+ *
+ * The CIB manager applies a transaction atomically, so one bad update (for
+ * example, for a node whose state entry is gone) fails the whole batch. When
+ * that happens, each update in the batch is resent on its own, as if it had
+ * never been batched. An update is not resent if a later update for the same
+ * resource on the same node has been queued, or if that resource's or node's
+ * history has been deleted since, because the resent update would then
+ * overwrite newer information.
+ */
+
+// Call ID of the most recent in-progress CIB resource update (or 0 if none)
+static int pending_rsc_update = 0;
+
+// Resource history update waiting to be sent to the CIB manager
+struct history_update {
+    xmlNode *xml;   // Update to the PCMK_XE_STATUS section
+    char *desc;     // Description of the action result being recorded
+    char *key;      // Node and resource that the update is for
+    guint seq;      // Sequence number of the update
+};
+
+// Resource history updates sent to the CIB manager in one call
+struct history_batch {
+    GQueue *updates;    // Updates in the batch (struct history_update *)
+    char *desc;         // Descriptions of the updates, for logging
+};
+
+// Queued resource history updates (struct history_update *)
+static GQueue *history_updates = NULL;
+
+// Flushes history_updates once higher-priority sources have been dispatched
+static crm_trigger_t *history_trigger = NULL;
+
+/* Sequence number of the most recent update to or deletion of the history of
+ * each resource on each node ("<node>\n<resource>"), and of the most recent
+ * deletion of each node's entire history ("<node>\n")
+ */
+static GHashTable *history_latest = NULL;
+
+// Most recently assigned sequence number
+static guint history_seq = 0;
+
+// Maximum number of resource history updates to send in one transaction
+#define MAX_HISTORY_BATCH 100
+
+static int send_history_updates(GQueue *updates);
+
+/*!
+ * \internal
+ * \brief Get the key used in \c history_latest
+ *
+ * \param[in] node    Node name
+ * \param[in] rsc_id  Resource ID (or \c NULL for the node's entire history)
+ *
+ * \return Newly allocated key
+ */
+static char *
+history_key(const char *node, const char *rsc_id)
+{
+    return pcmk__assert_asprintf("%s\n%s", node, pcmk__s(rsc_id, ""));
+}
+
+/*!
+ * \internal
+ * \brief Assign the next sequence number as the latest for a history key
+ *
+ * \param[in] key  Key to update (this function does not take ownership)
+ *
+ * \return Newly assigned sequence number
+ */
+static guint
+set_latest(const char *key)
+{
+    if (history_latest == NULL) {
+        history_latest = pcmk__strkey_table(free, NULL);
+    }
+    g_hash_table_insert(history_latest, pcmk__str_copy(key),
+                        GUINT_TO_POINTER(++history_seq));
+    return history_seq;
+}
+
+/*!
+ * \internal
+ * \brief Check whether a resource history update is the latest for its key
+ *
+ * \param[in] update  Resource history update
+ *
+ * \return \c true if nothing has superseded \p update, otherwise \c false
+ */
+static bool
+is_latest(const struct history_update *update)
+{
+    const char *node_end = strchr(update->key, '\n');
+    char *node_key = NULL;
+    guint node_seq = 0;
+
+    if (history_latest == NULL) {
+        return false;
+    }
+    if (GPOINTER_TO_UINT(g_hash_table_lookup(history_latest, update->key))
+        != update->seq) {
+        return false;
+    }
+
+    node_key = strndup(update->key, node_end - update->key + 1);
+    pcmk__mem_assert(node_key);
+    node_seq = GPOINTER_TO_UINT(g_hash_table_lookup(history_latest, node_key));
+    free(node_key);
+
+    return node_seq < update->seq;
+}
+
+static void
+free_history_update(gpointer data)
+{
+    struct history_update *update = data;
+
+    // Forget the update's key unless something newer was recorded for it
+    if ((history_latest != NULL)
+        && (GPOINTER_TO_UINT(g_hash_table_lookup(history_latest, update->key))
+            == update->seq)) {
+        g_hash_table_remove(history_latest, update->key);
+    }
+
+    pcmk__xml_free(update->xml);
+    free(update->desc);
+    free(update->key);
+    free(update);
+}
+
+static void
+free_history_batch(void *data)
+{
+    struct history_batch *batch = data;
+
+    if (batch->updates != NULL) {
+        g_queue_free_full(batch->updates, free_history_update);
+    }
+    free(batch->desc);
+    free(batch);
+}
+
+/*!
+ * \internal
+ * \brief Resend each update from a failed batch on its own
+ *
+ * \param[in,out] batch    Failed batch (its updates will be taken from it)
+ * \param[in]     pending  Whether \p batch was the pending update (if so, the
+ *                         last retry sent becomes the pending update)
+ */
+static void
+retry_history_updates(struct history_batch *batch, bool pending)
+{
+    GQueue *updates = batch->updates;
+    struct history_update *update = NULL;
+    int call_id = 0;
+
+    batch->updates = NULL;
+
+    pcmk__info("Retrying %u resource history updates individually",
+               updates->length);
+
+    while ((update = g_queue_pop_head(updates)) != NULL) {
+        GQueue *single = NULL;
+
+        if (!is_latest(update)) {
+            pcmk__info("Not retrying resource history update for %s: it has "
+                       "been superseded", update->desc);
+            free_history_update(update);
+            continue;
+        }
+
+        single = g_queue_new();
+        g_queue_push_tail(single, update);
+        call_id = send_history_updates(single);
+
+        /* If a newer update was sent while the batch was in progress, it's
+         * still the pending one
+         */
+        if (pending && (call_id > 0)) {
+            pending_rsc_update = call_id;
+        }
+    }
+    g_queue_free(updates);
+}
+
+static void
+cib_rsc_callback(xmlNode *msg, int call_id, int rc, xmlNode *output,
+                 void *user_data)
+{
+    struct history_batch *batch = user_data;
+    bool pending = (call_id == pending_rsc_update);
+
+    if (rc == pcmk_ok) {
+        pcmk__trace("Resource history update completed for %s (call=%d rc=%d)",
+                    batch->desc, call_id, rc);
+
+    } else if (call_id > 0) {
+        pcmk__warn("Resource history update %d failed for %s: %s "
+                   QB_XS " rc=%d",
+                   call_id, batch->desc, pcmk_strerror(rc), rc);
+
+    } else {
+        pcmk__warn("Resource history update failed for %s: %s " QB_XS " rc=%d",
+                   batch->desc, pcmk_strerror(rc), rc);
+    }
+
+    if (pending) {
+        pending_rsc_update = 0;
+        controld_trigger_fsa();
+    }
+
+    if ((rc != pcmk_ok) && (batch->updates->length > 1)) {
+        retry_history_updates(batch, pending);
+    }
+}
+
+/*!
+ * \internal
+ * \brief Send resource history updates to the CIB manager
+ *
+ * A single update is sent as a plain modification. Multiple updates are sent
+ * as one transaction, so that the CIB manager applies them atomically and
+ * creates and broadcasts a single patchset.
+ *
+ * \param[in,out] updates  Updates to send (this function takes ownership)
+ *
+ * \return CIB call ID on success, otherwise negative legacy return code
+ */
+static int
+send_history_updates(GQueue *updates)
+{
+    cib_t *cib = controld_globals.cib_conn;
+    struct history_batch *batch = NULL;
+    GString *desc = g_string_sized_new(256);
+    int call_opt = crmd_cib_smart_opt();
+    int cib_rc = -ENOTCONN;
+
+    for (const GList *iter = updates->head; iter != NULL; iter = iter->next) {
+        const struct history_update *update = iter->data;
+
+        pcmk__add_separated_word(&desc, 256, update->desc, ", ");
+    }
+
+    if (cib == NULL) {
+        // Fall through to error handling below
+
+    } else if (updates->length == 1) {
+        const struct history_update *update = g_queue_peek_head(updates);
+
+        cib_rc = cib->cmds->modify(cib, PCMK_XE_STATUS, update->xml, call_opt);
+
+    } else {
+        cib_rc = cib->cmds->init_transaction(cib);
+
+        for (const GList *iter = updates->head;
+             (iter != NULL) && (cib_rc == pcmk_ok); iter = iter->next) {
+
+            const struct history_update *update = iter->data;
+
+            cib_rc = cib->cmds->modify(cib, PCMK_XE_STATUS, update->xml,
+                                       call_opt|cib_transaction);
+        }
+
+        if (cib_rc == pcmk_ok) {
+            cib_rc = cib->cmds->end_transaction(cib, true, call_opt);
+        } else {
+            cib->cmds->end_transaction(cib, false, cib_none);
+        }
+    }
+
+    if (cib_rc >= 0) {
+        pcmk__debug("Submitted CIB update %d with %u resource history "
+                    "update%s", cib_rc, updates->length,
+                    pcmk__plural_s(updates->length));
+
+    } else {
+        pcmk__err("Failed to update resource history for %s: %s",
+                  desc->str, pcmk_rc_str(pcmk_legacy2rc(cib_rc)));
+    }
+
+    if (cib == NULL) {
+        g_queue_free_full(updates, free_history_update);
+        g_string_free(desc, TRUE);
+        return cib_rc;
+    }
+
+    batch = pcmk__assert_alloc(1, sizeof(struct history_batch));
+    batch->updates = updates;
+    batch->desc = pcmk__str_copy(desc->str);
+    g_string_free(desc, TRUE);
+
+    // CIB library handles freeing the batch
+    cib->cmds->register_callback_full(cib, cib_rc, cib_op_timeout(), FALSE,
+                                      batch, "cib_rsc_callback",
+                                      cib_rsc_callback, free_history_batch);
+    return cib_rc;
+}
+
+/*!
+ * \internal
+ * \brief Send all queued resource history updates to the CIB manager
+ *
+ * \note On success, the CIB update's call ID will be stored in
+ *       pending_rsc_update.
+ */
+void
+controld_flush_resource_history(void)
+{
+    GQueue *updates = history_updates;
+    int call_id = 0;
+
+    if (updates == NULL) {
+        return;
+    }
+
+    // Anything queued from here on belongs to the next batch
+    history_updates = NULL;
+    call_id = send_history_updates(updates);
+    if (call_id > 0) {
+        pending_rsc_update = call_id;
+    }
+}
+
+static gboolean
+flush_resource_history_cb(gpointer user_data)
+{
+    controld_flush_resource_history();
+    return G_SOURCE_CONTINUE;
+}
+
+/*!
+ * \internal
+ * \brief Queue a resource history update to be sent to the CIB manager
+ *
+ * \param[in,out] xml   Update to the \c PCMK_XE_STATUS section (this function
+ *                      takes ownership)
+ * \param[in]     op    Action result being recorded
+ * \param[in]     node  Name of node where action occurred
+ */
+void
+controld_queue_resource_history(xmlNode *xml, const lrmd_event_data_t *op,
+                                const char *node)
+{
+    struct history_update *update = pcmk__assert_alloc(1, sizeof(*update));
+
+    update->xml = xml;
+    update->desc = pcmk__assert_asprintf(PCMK__OP_FMT " on %s (call=%d)",
+                                         op->rsc_id, op->op_type,
+                                         op->interval_ms, node, op->call_id);
+    update->key = history_key(node, op->rsc_id);
+    update->seq = set_latest(update->key);
+
+    if (history_updates == NULL) {
+        history_updates = g_queue_new();
+    }
+    g_queue_push_tail(history_updates, update);
+
+    if (history_updates->length >= MAX_HISTORY_BATCH) {
+        controld_flush_resource_history();
+        return;
+    }
+
+    if (history_trigger == NULL) {
+        history_trigger = mainloop_add_trigger(G_PRIORITY_LOW,
+                                               flush_resource_history_cb,
+                                               NULL);
+    }
+    mainloop_set_trigger(history_trigger);
+}
+
+/*!
+ * \internal
+ * \brief Note that some resource history is being deleted from the CIB
+ *
+ * Updates sent before this will not be resent if their batch fails.
+ *
+ * \param[in] node    Name of node whose history is being deleted
+ * \param[in] rsc_id  Resource whose history is being deleted (or \c NULL for
+ *                    the node's entire history)
+ */
+void
+controld_supersede_resource_history(const char *node, const char *rsc_id)
+{
+    char *key = NULL;
+
+    CRM_CHECK(node != NULL, return);
+
+    key = history_key(node, rsc_id);
+    set_latest(key);
+    free(key);
+}
+
+/*!
+ * \internal
+ * \brief Get the call ID of the most recent in-progress history update
+ *
+ * \return CIB call ID of most recent resource history update not yet
+ *         confirmed by the CIB manager, or 0 if none
+ */
+int
+controld_pending_history_update(void)
+{
+    return pending_rsc_update;
+}
+
+/*!
+ * \internal
+ * \brief Send any queued resource history updates and free related memory
+ */
+void
+controld_stop_resource_history(void)
+{
+    controld_flush_resource_history();
+    g_clear_pointer(&history_trigger, mainloop_destroy_trigger);
+    g_clear_pointer(&history_latest, g_hash_table_destroy);
+}
@@ -819,6 +819,7 @@ do_dc_join_ack(long long action, enum crmd_fsa_cause cause,
      *
      * The delete and modify requests are part of an atomic transaction.
      */
+    controld_flush_resource_history();
     rc = cib->cmds->init_transaction(cib);
     if (rc != pcmk_ok) {
         goto done;
@@ -827,6 +828,7 @@ do_dc_join_ack(long long action, enum crmd_fsa_cause cause,
     // Delete relevant parts of node's current executor state from CIB
     controld_node_history_deletion_strings(join_from, unlocked_only, &xpath,
                                            NULL);
+    controld_supersede_resource_history(join_from, NULL);
 
     rc = cib->cmds->remove(cib, xpath, NULL,
                            cib_xpath|cib_multiple|cib_transaction);
@@ -280,6 +280,7 @@ search_conflicting_node_callback(xmlNode * msg, int call_id, int rc,
                          "uname with %s",
                          node_uuid, node_uname, new_node_uuid);
 
+            controld_flush_resource_history();
             delete_call_id = cib_conn->cmds->remove(cib_conn, PCMK_XE_NODES,
                                                     node_xml, cib_none);
             fsa_register_cib_callback(delete_call_id, pcmk__str_copy(node_uuid),
@@ -49,9 +49,10 @@ save_cib_contents(xmlNode *msg, int call_id, int rc, xmlNode *output,
     CRM_CHECK(id != NULL, return);
 
     if (rc == pcmk_ok) {
+        const char *ext =
+            pcmk__compression_extension(pcmk__compression_configured());
         char *filename = pcmk__assert_asprintf(PCMK_SCHEDULER_INPUT_DIR
-                                               "/pe-core-%s.bz2",
-                                               id);
+                                               "/pe-core-%s.%s", id, ext);
 
         if (pcmk__xml_write_file(output, filename, true) != pcmk_rc_ok) {
             pcmk__err("Could not save CIB to %s after scheduler crash",
@@ -79,8 +80,9 @@ handle_disconnect(void)
 
         pcmk__crit("Lost connection to the scheduler "
                    QB_XS " CIB will be saved to "
-                   PCMK_SCHEDULER_INPUT_DIR "/pe-core-%s.bz2",
-                   uuid_str);
+                   PCMK_SCHEDULER_INPUT_DIR "/pe-core-%s.%s",
+                   uuid_str,
+                   pcmk__compression_extension(pcmk__compression_configured()));
 
         /* Save the current CIB so that we have a chance of figuring out what
          * killed the scheduler.
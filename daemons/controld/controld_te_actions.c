@@ -310,6 +310,7 @@ controld_record_action_event(pcmk__graph_action_t *action,
     pcmk__create_history_xml(rsc, op, CRM_FEATURE_SET, target_rc, target,
                              __func__);
 
+    controld_flush_resource_history();
     rc = cib_conn->cmds->modify(cib_conn, PCMK_XE_STATUS, state, cib_none);
     fsa_register_cib_callback(rc, NULL, cib_action_updated);
     pcmk__xml_free(state);
@@ -403,6 +404,10 @@ execute_rsc_action(pcmk__graph_t *graph, pcmk__graph_action_t *action)
     cmd = pcmk__new_request(pcmk_ipc_controld, CRM_SYSTEM_TENGINE, router_node,
                             CRM_SYSTEM_LRMD, CRM_OP_INVOKE_LRM, rsc_op);
 
+    // Let the node tell us promptly when its queue crosses its job limit
+    pcmk__xe_set_int(cmd, PCMK__XA_CRM_LIMIT_WINDOW,
+                     throttle_get_window(router_node));
+
     if (is_local) {
         /* shortcut local resource commands */
         ha_msg_input_t data = {
@@ -660,6 +665,59 @@ graph_action_allowed(pcmk__graph_t *graph, pcmk__graph_action_t *action)
     return allowed_on_node(graph, action, target);
 }
 
+/*!
+ * \internal
+ * \brief Feed the time an action took into its node's throttle
+ *
+ * \param[in] action  Graph action whose result was received
+ * \param[in] event   Action result (\c PCMK__XE_LRM_RSC_OP)
+ */
+void
+te_record_action_latency(const pcmk__graph_action_t *action,
+                         const xmlNode *event)
+{
+    int status = PCMK_EXEC_DONE;
+    int exec_ms = 0;
+    int queue_ms = 0;
+    int elapsed_ms = 0;
+    bool timed_out = false;
+    const char *task = NULL;
+    const char *target = NULL;
+
+    if ((action->type != pcmk__rsc_graph_action)
+        || (pcmk__xe_get(action->xml, PCMK__META_ON_NODE) == NULL)) {
+        return;
+    }
+
+    pcmk__xe_get_int(event, PCMK__XA_OP_STATUS, &status);
+    pcmk__xe_get_int(event, PCMK_XA_EXEC_TIME, &exec_ms);
+    pcmk__xe_get_int(event, PCMK_XA_QUEUE_TIME, &queue_ms);
+    elapsed_ms = QB_MAX(exec_ms, 0) + QB_MAX(queue_ms, 0);
+    timed_out = (status == PCMK_EXEC_TIMEOUT);
+
+    // Attribute the result to the same node(s) that counted it as a job
+    task = pcmk__xe_get(action->xml, PCMK_XA_OPERATION);
+    target = pcmk__xe_get(action->xml, PCMK__XA_ROUTER_NODE);
+
+    if ((target == NULL)
+        && pcmk__strcase_any_of(task, PCMK_ACTION_MIGRATE_TO,
+                                PCMK_ACTION_MIGRATE_FROM, NULL)) {
+
+        throttle_record_result(crm_meta_value(action->params,
+                                              PCMK__META_MIGRATE_SOURCE),
+                               elapsed_ms, action->timeout, timed_out);
+        throttle_record_result(crm_meta_value(action->params,
+                                              PCMK__META_MIGRATE_TARGET),
+                               elapsed_ms, action->timeout, timed_out);
+        return;
+    }
+
+    if (target == NULL) {
+        target = pcmk__xe_get(action->xml, PCMK__META_ON_NODE);
+    }
+    throttle_record_result(target, elapsed_ms, action->timeout, timed_out);
+}
+
 /*!
  * \brief Confirm a graph action (and optionally update graph)
  *
@@ -553,6 +553,7 @@ process_graph_event(xmlNode *event, const char *event_node)
             }
 
             stop_te_timer(action);
+            te_record_action_latency(action, event);
             te_action_confirmed(action, controld_globals.transition_graph);
 
             if (pcmk__is_set(action->flags, pcmk__graph_action_failed)) {
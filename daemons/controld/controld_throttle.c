@@ -37,6 +37,14 @@ struct throttle_record_s {
     int max;
     enum throttle_state_e mode;
     char *node;
+
+    /* Job limit adapted to observed action latency, or 0 if latency has not
+     * limited the node (in which case only the load-based limit applies)
+     */
+    double window;
+
+    int results;    // Results observed since window was last decreased
+    int queue;      // Last reported executor queue length (-1 if unknown)
 };
 
 static int throttle_job_max = 0;
@@ -46,6 +54,11 @@ static float throttle_load_target = 0.0;
 #define THROTTLE_FACTOR_MEDIUM 1.6
 #define THROTTLE_FACTOR_HIGH   2.0
 
+/* An action result counts as slow if the action took longer than this fraction
+ * of its timeout
+ */
+#define THROTTLE_SLOW_FRACTION 0.5
+
 static GHashTable *throttle_records = NULL;
 static mainloop_timer_t *throttle_timer = NULL;
 
@@ -177,21 +190,70 @@ throttle_mode(void)
     return mode;
 }
 
+/*!
+ * \internal
+ * \brief Count actions in flight in the local executor and remote connections
+ *
+ * \return Number of pending non-recurring actions on this node
+ */
+static int
+throttle_queue_length(void)
+{
+    int queue = 0;
+    GList *states = lrm_state_get_list();
+
+    for (const GList *iter = states; iter != NULL; iter = iter->next) {
+        const lrm_state_t *lrm_state = iter->data;
+        GHashTableIter op_iter;
+        const active_op_t *op = NULL;
+
+        if (lrm_state->active_ops == NULL) {
+            continue;
+        }
+
+        g_hash_table_iter_init(&op_iter, lrm_state->active_ops);
+        while (g_hash_table_iter_next(&op_iter, NULL, (gpointer *) &op)) {
+            // Recurring actions stay in the table between runs
+            if (op->interval_ms == 0) {
+                queue++;
+            }
+        }
+    }
+
+    g_list_free(states);
+    return queue;
+}
+
+static enum throttle_state_e last_mode = -1;   // Mode last sent to peers
+static int last_queue = -1;     // Queue length last sent to peers
+
+/* Number of non-recurring actions in flight, kept up to date as actions start
+ * and finish (and recounted by the timer, in case an action was dropped
+ * without a result)
+ */
+static int queue_length = 0;
+
+// Job limit the DC last gave this node (or 0 if latency doesn't limit it)
+static int dc_window = 0;
+
 static void
-throttle_send_command(enum throttle_state_e mode)
+throttle_send_command(enum throttle_state_e mode, int queue)
 {
     xmlNode *xml = NULL;
-    static enum throttle_state_e last = -1;
 
-    if(mode != last) {
-        pcmk__info("New throttle mode: %s load (was %s)", load2str(mode),
-                   load2str(last));
-        last = mode;
+    if ((mode != last_mode) || (queue != last_queue)) {
+        if (mode != last_mode) {
+            pcmk__info("New throttle mode: %s load (was %s)", load2str(mode),
+                       load2str(last_mode));
+        }
+        last_mode = mode;
+        last_queue = queue;
 
         xml = pcmk__new_request(pcmk_ipc_controld, CRM_SYSTEM_CRMD, NULL,
                                 CRM_SYSTEM_CRMD, CRM_OP_THROTTLE, NULL);
         pcmk__xe_set_int(xml, PCMK__XA_CRM_LIMIT_MODE, mode);
         pcmk__xe_set_int(xml, PCMK__XA_CRM_LIMIT_MAX, throttle_job_max);
+        pcmk__xe_set_int(xml, PCMK__XA_CRM_LIMIT_QUEUE, queue);
 
         pcmk__cluster_send_message(NULL, pcmk_ipc_controld, xml);
         pcmk__xml_free(xml);
@@ -201,10 +263,52 @@ throttle_send_command(enum throttle_state_e mode)
 static gboolean
 throttle_timer_cb(void *data)
 {
-    throttle_send_command(throttle_mode());
+    queue_length = throttle_queue_length();
+    throttle_send_command(throttle_mode(), queue_length);
     return TRUE;
 }
 
+/*!
+ * \internal
+ * \brief Remember the job limit the DC last gave this node
+ *
+ * \param[in] msg  Executor request from the DC
+ */
+void
+throttle_set_window(const xmlNode *msg)
+{
+    // Older DCs don't send it, in which case the queue is sent only by timer
+    pcmk__xe_get_int(msg, PCMK__XA_CRM_LIMIT_WINDOW, &dc_window);
+}
+
+/*!
+ * \internal
+ * \brief Track the executor queue length, and tell peers if it crossed the
+ *        DC's job limit
+ *
+ * The DC doesn't raise a node's job limit while the node has more actions
+ * queued than the limit allows, so it needs to know promptly when the queue
+ * goes above or below the limit. Other changes wait for the next timer.
+ *
+ * \param[in] change  Number of non-recurring actions started (or, if
+ *                    negative, finished)
+ */
+void
+throttle_queue_changed(int change)
+{
+    queue_length = QB_MAX(queue_length + change, 0);
+
+    if ((dc_window <= 0) || (last_mode == -1)) {
+        return; // Latency doesn't limit us, or we haven't reported load yet
+    }
+
+    if ((queue_length > dc_window) != (last_queue > dc_window)) {
+        pcmk__trace("Executor queue length %d crossed job limit %d",
+                    queue_length, dc_window);
+        throttle_send_command(last_mode, queue_length);
+    }
+}
+
 static void
 throttle_record_free(void *p)
 {
@@ -336,22 +440,44 @@ throttle_get_total_job_limit(int l)
     return limit;
 }
 
-int
-throttle_get_job_limit(const char *node)
+/*!
+ * \internal
+ * \brief Get the throttle record for a node, creating it if needed
+ *
+ * \param[in] node  Name of node to get record for
+ *
+ * \return Throttle record for \p node
+ */
+static struct throttle_record_s *
+throttle_get_record(const char *node)
 {
-    int jobs = 1;
-    struct throttle_record_s *r = NULL;
+    struct throttle_record_s *r = g_hash_table_lookup(throttle_records, node);
 
-    r = g_hash_table_lookup(throttle_records, node);
     if(r == NULL) {
         r = pcmk__assert_alloc(1, sizeof(struct throttle_record_s));
         r->node = pcmk__str_copy(node);
         r->mode = throttle_low;
         r->max = throttle_job_max;
+        r->queue = -1;
         pcmk__trace("Defaulting to local values for unknown node %s", node);
 
         g_hash_table_insert(throttle_records, r->node, r);
     }
+    return r;
+}
+
+/*!
+ * \internal
+ * \brief Get the job limit for a node based only on its reported load
+ *
+ * \param[in] r  Throttle record for node
+ *
+ * \return Maximum number of jobs allowed by node's load
+ */
+static int
+throttle_load_job_limit(const struct throttle_record_s *r)
+{
+    int jobs = 1;
 
     switch(r->mode) {
         case throttle_extreme:
@@ -368,36 +494,150 @@ throttle_get_job_limit(const char *node)
             jobs = QB_MAX(1, r->max);
             break;
         default:
-            pcmk__err("Unknown throttle mode %.4x on %s", r->mode, node);
+            pcmk__err("Unknown throttle mode %.4x on %s", r->mode, r->node);
             break;
     }
     return jobs;
 }
 
+int
+throttle_get_job_limit(const char *node)
+{
+    const struct throttle_record_s *r = throttle_get_record(node);
+    int jobs = throttle_load_job_limit(r);
+
+    if ((r->window > 0) && (r->window < jobs)) {
+        jobs = QB_MAX(1, (int) r->window);
+    }
+    return jobs;
+}
+
+/*!
+ * \internal
+ * \brief Get the job limit the DC uses for a node based on action latency
+ *
+ * \param[in] node  Name of node to check
+ *
+ * \return Latency-based job limit for \p node, or 0 if latency doesn't limit it
+ */
+int
+throttle_get_window(const char *node)
+{
+    const struct throttle_record_s *r = NULL;
+
+    if ((node == NULL) || (throttle_records == NULL)) {
+        return 0;
+    }
+    r = g_hash_table_lookup(throttle_records, node);
+    return (r == NULL)? 0 : (int) r->window;
+}
+
+/*!
+ * \internal
+ * \brief Adapt a node's latency-based job limit to an action result
+ *
+ * The limit is adjusted using additive increase/multiplicative decrease: a
+ * slow result halves the limit (at most once per limit's worth of results, so
+ * a burst of slow results from jobs started under the old limit counts once),
+ * and every other result raises it by the reciprocal of the limit (so roughly
+ * by one job per limit's worth of results). Once the limit grows back to what
+ * the node's load allows, latency stops limiting the node.
+ *
+ * \param[in,out] r     Throttle record for node where action was executed
+ * \param[in]     slow  Whether the action timed out or was slow
+ *
+ * \return true if the limit was decreased, otherwise false
+ */
+static bool
+throttle_adjust_window(struct throttle_record_s *r, bool slow)
+{
+    int load_jobs = throttle_load_job_limit(r);
+
+    if (slow) {
+        if ((r->window > 0) && (r->results < r->window)) {
+            // Already decreased for this window
+            r->results++;
+            return false;
+        }
+
+        r->window = QB_MAX(1.0, ((r->window > 0)? r->window : load_jobs) / 2);
+        r->results = 0;
+        return true;
+    }
+
+    if (r->window <= 0) {
+        return false;
+    }
+
+    r->results++;
+
+    // More actions queued than we allow means the node is busy with others
+    if ((r->queue >= 0) && (r->queue > r->window)) {
+        pcmk__trace("Not raising job limit for %s with %d actions queued",
+                    r->node, r->queue);
+        return false;
+    }
+
+    r->window += 1.0 / r->window;
+    if (r->window >= load_jobs) {
+        pcmk__info("Action latency on %s no longer limits its jobs", r->node);
+        r->window = 0;
+        r->results = 0;
+    }
+    return false;
+}
+
+/*!
+ * \internal
+ * \brief Adapt a node's job limit to the time an action took there
+ *
+ * \param[in] node        Name of node where action was executed
+ * \param[in] elapsed_ms  Time the action spent queued and executing
+ * \param[in] timeout_ms  Action timeout (or 0 if none)
+ * \param[in] timed_out   Whether the action timed out
+ */
+void
+throttle_record_result(const char *node, int elapsed_ms, int timeout_ms,
+                       bool timed_out)
+{
+    bool slow = timed_out
+                || ((timeout_ms > 0)
+                    && (elapsed_ms > timeout_ms * THROTTLE_SLOW_FRACTION));
+    struct throttle_record_s *r = NULL;
+
+    if ((node == NULL) || (throttle_records == NULL)) {
+        return;
+    }
+
+    r = throttle_get_record(node);
+    if (throttle_adjust_window(r, slow)) {
+        pcmk__notice("Limiting %s to %d jobs because an action took %dms "
+                     "(timeout %dms)",
+                     node, (int) r->window, elapsed_ms, timeout_ms);
+    }
+}
+
 void
 throttle_update(xmlNode *xml)
 {
     int max = 0;
     int mode = 0;
+    int queue = -1; // Older versions don't report the queue length
     struct throttle_record_s *r = NULL;
     const char *from = pcmk__xe_get(xml, PCMK__XA_SRC);
 
     pcmk__xe_get_int(xml, PCMK__XA_CRM_LIMIT_MODE, &mode);
     pcmk__xe_get_int(xml, PCMK__XA_CRM_LIMIT_MAX, &max);
+    pcmk__xe_get_int(xml, PCMK__XA_CRM_LIMIT_QUEUE, &queue);
 
-    r = g_hash_table_lookup(throttle_records, from);
-
-    if(r == NULL) {
-        r = pcmk__assert_alloc(1, sizeof(struct throttle_record_s));
-        r->node = pcmk__str_copy(from);
-        g_hash_table_insert(throttle_records, r->node, r);
-    }
+    r = throttle_get_record(from);
 
     r->max = max;
     r->mode = (enum throttle_state_e) mode;
+    r->queue = queue;
 
-    pcmk__debug("Node %s has %s load and supports at most %d jobs; new job "
-                "limit %d",
-                from, load2str((enum throttle_state_e) mode), max,
+    pcmk__debug("Node %s has %s load, %d queued actions, and supports at most "
+                "%d jobs; new job limit %d",
+                from, load2str((enum throttle_state_e) mode), queue, max,
                 throttle_get_job_limit(from));
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright 2013-2021 the Pacemaker project contributors
+ * Copyright 2013-2026 the Pacemaker project contributors
  *
  * The version control history for this file may have further details.
  *
@@ -14,3 +14,8 @@ void controld_configure_throttle(GHashTable *options);
 void throttle_update(xmlNode *xml);
 int throttle_get_job_limit(const char *node);
 int throttle_get_total_job_limit(int l);
+int throttle_get_window(const char *node);
+void throttle_set_window(const xmlNode *msg);
+void throttle_queue_changed(int change);
+void throttle_record_result(const char *node, int elapsed_ms, int timeout_ms,
+                            bool timed_out);
@@ -65,6 +65,8 @@ void abort_transition_graph(int abort_priority,
 	abort_transition_graph(pri, action, text, reason,__func__,__LINE__);
 
 void te_action_confirmed(pcmk__graph_action_t *action, pcmk__graph_t *graph);
+void te_record_action_latency(const pcmk__graph_action_t *action,
+                              const xmlNode *event);
 void te_reset_job_counts(void);
 
 #endif
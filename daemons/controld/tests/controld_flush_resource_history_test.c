@@ -0,0 +1,354 @@
+/*
+ * Copyright 2026 the Pacemaker project contributors
+ *
+ * The version control history for this file may have further details.
+ *
+ * This source code is licensed under the GNU General Public License version 2
+ * or later (GPLv2+) WITHOUT ANY WARRANTY.
+ */
+
+#include <crm_internal.h>
+
+#include <crm/common/unittest_internal.h>
+
+// The code under test uses static state, so build it into this test directly
+#include "controld_history.c"
+
+/* Stand-ins for the parts of the controller that the code under test uses */
+
+controld_globals_t controld_globals = { 0, };
+
+void
+controld_trigger_fsa_as(const char *fn, int line)
+{
+}
+
+int
+crmd_cib_smart_opt(void)
+{
+    return cib_none;
+}
+
+unsigned int
+cib_op_timeout(void)
+{
+    return 0;
+}
+
+/* A fake CIB connection. Updates for the node named "gone" fail with ENXIO (as
+ * if its node_state entry did not exist), and a transaction containing one
+ * fails as a whole. Replies are held until deliver_replies() is called.
+ */
+
+#define GONE "gone"
+
+struct reply {
+    int call_id;
+    int rc;
+    void *user_data;
+    void (*callback)(xmlNode *, int, int, xmlNode *, void *);
+    void (*free_func)(void *);
+};
+
+static cib_api_operations_t fake_cmds;
+static cib_t fake_cib = { .cmds = &fake_cmds, };
+
+static int last_call_id = 0;
+static GList *failed_calls = NULL;      // Call IDs that will fail
+static GQueue *replies = NULL;
+static GList *in_transaction = NULL;    // Updates (xmlNode *) in transaction
+static GString *applied = NULL;         // "<rsc>:<call> " for each update
+static int transactions = 0;            // Number of transactions committed
+
+static const char *
+update_node(const xmlNode *update)
+{
+    return pcmk__xe_get(pcmk__xe_first_child(update, PCMK__XE_NODE_STATE, NULL,
+                                             NULL),
+                        PCMK_XA_ID);
+}
+
+static void
+apply(const xmlNode *update)
+{
+    const xmlNode *rsc = pcmk__xe_first_child(update, PCMK__XE_NODE_STATE,
+                                              NULL, NULL);
+
+    rsc = pcmk__xe_first_child(rsc, PCMK__XE_LRM, NULL, NULL);
+    rsc = pcmk__xe_first_child(rsc, PCMK__XE_LRM_RESOURCES, NULL, NULL);
+    rsc = pcmk__xe_first_child(rsc, PCMK__XE_LRM_RESOURCE, NULL, NULL);
+
+    g_string_append_printf(applied, "%s:%s ", pcmk__xe_get(rsc, PCMK_XA_ID),
+                           pcmk__xe_get(rsc, PCMK__XA_CALL_ID));
+}
+
+static int
+fake_modify(cib_t *cib, const char *section, xmlNode *data, int call_options)
+{
+    assert_string_equal(section, PCMK_XE_STATUS);
+
+    if (pcmk__is_set(call_options, cib_transaction)) {
+        in_transaction = g_list_append(in_transaction, data);
+        return pcmk_ok;
+    }
+
+    assert_null(in_transaction);
+    last_call_id++;
+    if (pcmk__str_eq(update_node(data), GONE, pcmk__str_none)) {
+        failed_calls = g_list_prepend(failed_calls,
+                                      GINT_TO_POINTER(last_call_id));
+    } else {
+        apply(data);
+    }
+    return last_call_id;
+}
+
+static int
+fake_init_transaction(cib_t *cib)
+{
+    assert_null(in_transaction);
+    return pcmk_ok;
+}
+
+static int
+fake_end_transaction(cib_t *cib, bool commit, int call_options)
+{
+    bool ok = true;
+
+    if (!commit) {
+        g_clear_pointer(&in_transaction, g_list_free);
+        return pcmk_ok;
+    }
+
+    for (const GList *iter = in_transaction; iter != NULL; iter = iter->next) {
+        if (pcmk__str_eq(update_node(iter->data), GONE, pcmk__str_none)) {
+            ok = false;
+        }
+    }
+    if (ok) {
+        for (const GList *iter = in_transaction; iter != NULL;
+             iter = iter->next) {
+            apply(iter->data);
+        }
+    }
+
+    transactions++;
+    g_clear_pointer(&in_transaction, g_list_free);
+
+    last_call_id++;
+    if (!ok) {
+        failed_calls = g_list_prepend(failed_calls,
+                                      GINT_TO_POINTER(last_call_id));
+    }
+    return last_call_id;
+}
+
+static gboolean
+fake_register_callback_full(cib_t *cib, int call_id, int timeout,
+                            gboolean only_success, void *user_data,
+                            const char *callback_name,
+                            void (*callback)(xmlNode *, int, int, xmlNode *,
+                                             void *),
+                            void (*free_func)(void *))
+{
+    struct reply *reply = pcmk__assert_alloc(1, sizeof(struct reply));
+
+    reply->call_id = call_id;
+    reply->rc = pcmk_ok;
+    reply->user_data = user_data;
+    reply->callback = callback;
+    reply->free_func = free_func;
+
+    if (g_list_find(failed_calls, GINT_TO_POINTER(call_id)) != NULL) {
+        reply->rc = -ENXIO;
+    }
+    g_queue_push_tail(replies, reply);
+    return TRUE;
+}
+
+/*!
+ * \internal
+ * \brief Deliver the oldest held reply
+ *
+ * \return \c true if a reply was delivered, or \c false if none was held
+ */
+static bool
+deliver_reply(void)
+{
+    struct reply *reply = g_queue_pop_head(replies);
+
+    if (reply == NULL) {
+        return false;
+    }
+    reply->callback(NULL, reply->call_id, reply->rc, NULL, reply->user_data);
+    reply->free_func(reply->user_data);
+    free(reply);
+    return true;
+}
+
+/*!
+ * \internal
+ * \brief Deliver held replies in order, including replies to retries
+ */
+static void
+deliver_replies(void)
+{
+    while (deliver_reply()) {
+        // Delivering a reply may hold more (replies to retries)
+    }
+}
+
+static void
+queue_update(const char *node, const char *rsc_id, int call_id)
+{
+    lrmd_event_data_t op = {
+        .rsc_id = (char *) rsc_id,
+        .op_type = (char *) PCMK_ACTION_START,
+        .call_id = call_id,
+    };
+    xmlNode *update = pcmk__xe_create(NULL, PCMK_XE_STATUS);
+    xmlNode *xml = pcmk__xe_create(update, PCMK__XE_NODE_STATE);
+
+    pcmk__xe_set(xml, PCMK_XA_ID, node);
+    xml = pcmk__xe_create(xml, PCMK__XE_LRM);
+    xml = pcmk__xe_create(xml, PCMK__XE_LRM_RESOURCES);
+    xml = pcmk__xe_create(xml, PCMK__XE_LRM_RESOURCE);
+    pcmk__xe_set(xml, PCMK_XA_ID, rsc_id);
+    pcmk__xe_set_int(xml, PCMK__XA_CALL_ID, call_id);
+
+    controld_queue_resource_history(update, &op, node);
+}
+
+static int
+setup_test(void **state)
+{
+    fake_cmds.modify = fake_modify;
+    fake_cmds.init_transaction = fake_init_transaction;
+    fake_cmds.end_transaction = fake_end_transaction;
+    fake_cmds.register_callback_full = fake_register_callback_full;
+    controld_globals.cib_conn = &fake_cib;
+
+    replies = g_queue_new();
+    applied = g_string_new(NULL);
+    transactions = 0;
+    return 0;
+}
+
+static int
+teardown_test(void **state)
+{
+    controld_stop_resource_history();
+    deliver_replies();
+    g_queue_free(replies);
+    g_string_free(applied, TRUE);
+    g_clear_pointer(&failed_calls, g_list_free);
+    return 0;
+}
+
+static void
+single_update(void **state)
+{
+    queue_update("node1", "rsc1", 1);
+    controld_flush_resource_history();
+    assert_int_equal(controld_pending_history_update(), last_call_id);
+
+    deliver_replies();
+    assert_string_equal(applied->str, "rsc1:1 ");
+    assert_int_equal(transactions, 0);
+    assert_int_equal(controld_pending_history_update(), 0);
+}
+
+static void
+batched_updates(void **state)
+{
+    queue_update("node1", "rsc1", 1);
+    queue_update("node1", "rsc2", 2);
+    queue_update("node2", "rsc1", 3);
+    controld_flush_resource_history();
+
+    deliver_replies();
+    assert_string_equal(applied->str, "rsc1:1 rsc2:2 rsc1:3 ");
+    assert_int_equal(transactions, 1);
+    assert_int_equal(controld_pending_history_update(), 0);
+}
+
+static void
+bad_update_in_batch(void **state)
+{
+    queue_update("node1", "rsc1", 1);
+    queue_update(GONE, "rsc2", 2);
+    queue_update("node2", "rsc3", 3);
+    controld_flush_resource_history();
+
+    // The transaction fails, then each update is retried on its own
+    deliver_replies();
+    assert_string_equal(applied->str, "rsc1:1 rsc3:3 ");
+    assert_int_equal(transactions, 1);
+    assert_int_equal(controld_pending_history_update(), 0);
+}
+
+static void
+retry_keeps_newer_pending(void **state)
+{
+    int newer = 0;
+
+    queue_update("node1", "rsc1", 1);
+    queue_update(GONE, "rsc2", 2);
+    controld_flush_resource_history();
+
+    queue_update("node2", "rsc3", 3);
+    controld_flush_resource_history();
+    newer = last_call_id;
+
+    // The older batch fails while the newer update is still in progress
+    assert_true(deliver_reply());
+    assert_int_equal(controld_pending_history_update(), newer);
+
+    deliver_replies();
+    assert_string_equal(applied->str, "rsc3:3 rsc1:1 ");
+    assert_int_equal(controld_pending_history_update(), 0);
+}
+
+static void
+superseded_update_not_retried(void **state)
+{
+    queue_update("node1", "rsc1", 1);
+    queue_update(GONE, "rsc2", 2);
+    controld_flush_resource_history();
+
+    // A newer result for rsc1 on node1 is sent before the batch fails
+    queue_update("node1", "rsc1", 3);
+    controld_flush_resource_history();
+
+    deliver_replies();
+    assert_string_equal(applied->str, "rsc1:3 ");
+}
+
+static void
+deleted_history_not_retried(void **state)
+{
+    queue_update("node1", "rsc1", 1);
+    queue_update("node2", "rsc2", 2);
+    queue_update(GONE, "rsc3", 3);
+    controld_flush_resource_history();
+
+    // node1's history is deleted before the batch fails
+    controld_supersede_resource_history("node1", NULL);
+
+    deliver_replies();
+    assert_string_equal(applied->str, "rsc2:2 ");
+}
+
+PCMK__UNIT_TEST(pcmk__xml_test_setup_group, pcmk__xml_test_teardown_group,
+                cmocka_unit_test_setup_teardown(single_update, setup_test,
+                                                teardown_test),
+                cmocka_unit_test_setup_teardown(batched_updates, setup_test,
+                                                teardown_test),
+                cmocka_unit_test_setup_teardown(bad_update_in_batch,
+                                                setup_test, teardown_test),
+                cmocka_unit_test_setup_teardown(retry_keeps_newer_pending,
+                                                setup_test, teardown_test),
+                cmocka_unit_test_setup_teardown(superseded_update_not_retried,
+                                                setup_test, teardown_test),
+                cmocka_unit_test_setup_teardown(deleted_history_not_retried,
+                                                setup_test, teardown_test))
@@ -0,0 +1,291 @@
+/*
+ * Copyright 2026 the Pacemaker project contributors
+ *
+ * The version control history for this file may have further details.
+ *
+ * This source code is licensed under the GNU General Public License version 2
+ * or later (GPLv2+) WITHOUT ANY WARRANTY.
+ */
+
+#include <crm_internal.h>
+
+#include <crm/common/unittest_internal.h>
+
+// The code under test uses static state, so build it into this test directly
+#include "controld_throttle.c"
+
+/* Stand-ins for the parts of the controller that the code under test uses */
+
+static lrm_state_t fake_lrm_state = { 0, };
+
+GList *
+lrm_state_get_list(void)
+{
+    return g_list_append(NULL, &fake_lrm_state);
+}
+
+static int sends = 0;       // Number of throttle updates sent
+static int sent_queue = 0;  // Queue length in last throttle update sent
+
+bool
+pcmk__cluster_send_message(const pcmk__node_status_t *node,
+                           enum pcmk_ipc_server service, const xmlNode *data)
+{
+    sends++;
+    pcmk__xe_get_int(data, PCMK__XA_CRM_LIMIT_QUEUE, &sent_queue);
+    return true;
+}
+
+unsigned int
+pcmk__cluster_num_active_nodes(void)
+{
+    return 1;
+}
+
+#define NODE "node1"
+
+static struct throttle_record_s *record = NULL;
+
+static int
+setup_test(void **state)
+{
+    throttle_records = pcmk__strkey_table(NULL, throttle_record_free);
+
+    // A lightly loaded node that allows 8 jobs
+    record = throttle_get_record(NODE);
+    record->mode = throttle_none;
+    record->max = 8;
+
+    fake_lrm_state.active_ops = pcmk__strkey_table(free, free);
+    last_mode = -1;
+    last_queue = -1;
+    queue_length = 0;
+    dc_window = 0;
+    sends = 0;
+    sent_queue = 0;
+    return 0;
+}
+
+static int
+teardown_test(void **state)
+{
+    g_clear_pointer(&throttle_records, g_hash_table_destroy);
+    g_clear_pointer(&fake_lrm_state.active_ops, g_hash_table_destroy);
+    record = NULL;
+    return 0;
+}
+
+static void
+add_results(int n, bool slow)
+{
+    for (int i = 0; i < n; i++) {
+        throttle_adjust_window(record, slow);
+    }
+}
+
+static void
+fast_results_only(void **state)
+{
+    add_results(20, false);
+    assert_true(record->window == 0);
+    assert_int_equal(throttle_get_job_limit(NODE), 8);
+    assert_int_equal(throttle_get_window(NODE), 0);
+}
+
+static void
+slow_result_halves_limit(void **state)
+{
+    assert_true(throttle_adjust_window(record, true));
+    assert_int_equal(throttle_get_job_limit(NODE), 4);
+    assert_int_equal(throttle_get_window(NODE), 4);
+}
+
+static void
+slow_burst_counts_once(void **state)
+{
+    assert_true(throttle_adjust_window(record, true));
+
+    // Results of jobs started under the old limit don't decrease it again
+    for (int i = 0; i < 4; i++) {
+        assert_false(throttle_adjust_window(record, true));
+    }
+    assert_int_equal(throttle_get_job_limit(NODE), 4);
+
+    assert_true(throttle_adjust_window(record, true));
+    assert_int_equal(throttle_get_job_limit(NODE), 2);
+}
+
+static void
+limit_at_least_one(void **state)
+{
+    add_results(50, true);
+    assert_true(record->window >= 1.0);
+    assert_int_equal(throttle_get_job_limit(NODE), 1);
+}
+
+static void
+fast_results_raise_limit(void **state)
+{
+    int results = 0;
+
+    throttle_adjust_window(record, true);
+
+    throttle_adjust_window(record, false);
+    assert_true(record->window > 4.0);
+
+    // Roughly one job per limit's worth of results, until the load limit
+    while ((record->window > 0) && (results < 100)) {
+        int before = throttle_get_job_limit(NODE);
+
+        throttle_adjust_window(record, false);
+        assert_true(throttle_get_job_limit(NODE) >= before);
+        results++;
+    }
+    assert_in_range(results, 20, 30);
+    assert_int_equal(throttle_get_job_limit(NODE), 8);
+    assert_int_equal(record->results, 0);
+}
+
+static void
+busy_node_not_raised(void **state)
+{
+    throttle_adjust_window(record, true);
+
+    record->queue = 6;
+    add_results(10, false);
+    assert_true(record->window == 4.0);
+
+    // Unknown queue length (older node) doesn't prevent increases
+    record->queue = -1;
+    throttle_adjust_window(record, false);
+    assert_true(record->window > 4.0);
+}
+
+static void
+load_limit_applies(void **state)
+{
+    throttle_adjust_window(record, true);
+
+    record->mode = throttle_med;
+    assert_int_equal(throttle_get_job_limit(NODE), 2);
+
+    // The latency limit is dropped once it reaches the load limit
+    throttle_adjust_window(record, false);
+    assert_true(record->window == 0);
+}
+
+static void
+slow_results_detected(void **state)
+{
+    throttle_record_result(NODE, 400, 1000, false);
+    throttle_record_result(NODE, 60000, 0, false);
+    assert_true(record->window == 0);
+
+    throttle_record_result(NODE, 600, 1000, false);
+    assert_int_equal(throttle_get_job_limit(NODE), 4);
+
+    for (int i = 0; i < 4; i++) {
+        throttle_record_result(NODE, 0, 1000, true);
+    }
+    assert_int_equal(throttle_get_job_limit(NODE), 4);
+
+    throttle_record_result(NODE, 0, 1000, true);
+    assert_int_equal(throttle_get_job_limit(NODE), 2);
+}
+
+static void
+set_queue(int queue)
+{
+    throttle_queue_changed(queue - queue_length);
+}
+
+static void
+add_active_op(const char *id, guint interval_ms)
+{
+    active_op_t *op = pcmk__assert_alloc(1, sizeof(active_op_t));
+
+    op->interval_ms = interval_ms;
+    g_hash_table_insert(fake_lrm_state.active_ops, pcmk__str_copy(id), op);
+}
+
+static void
+set_dc_window(int window)
+{
+    xmlNode *msg = pcmk__xe_create(NULL, PCMK__XE_MESSAGE);
+
+    if (window >= 0) {
+        pcmk__xe_set_int(msg, PCMK__XA_CRM_LIMIT_WINDOW, window);
+    }
+    throttle_set_window(msg);
+    pcmk__xml_free(msg);
+}
+
+static void
+queue_without_window(void **state)
+{
+    throttle_send_command(throttle_none, 0);
+    assert_int_equal(sends, 1);
+
+    set_queue(5);
+    set_queue(0);
+    assert_int_equal(sends, 1);
+
+    // A request without a window (from an older DC) leaves it unchanged
+    set_dc_window(2);
+    set_dc_window(-1);
+    assert_int_equal(dc_window, 2);
+}
+
+static void
+queue_crosses_window(void **state)
+{
+    throttle_send_command(throttle_none, 0);
+    set_dc_window(2);
+
+    set_queue(2);
+    assert_int_equal(sends, 1);
+
+    set_queue(3);
+    assert_int_equal(sends, 2);
+    assert_int_equal(sent_queue, 3);
+
+    set_queue(4);
+    assert_int_equal(sends, 2);
+
+    set_queue(1);
+    assert_int_equal(sends, 3);
+    assert_int_equal(sent_queue, 1);
+
+    // Results for actions that weren't counted don't make the queue negative
+    throttle_queue_changed(-2);
+    assert_int_equal(queue_length, 0);
+    assert_int_equal(sends, 3);
+}
+
+static void
+queue_recounted(void **state)
+{
+    add_active_op("op1", 0);
+    add_active_op("op2", 0);
+
+    // Recurring actions stay in the table between runs, so they don't count
+    add_active_op("recurring", 10000);
+
+    assert_int_equal(throttle_queue_length(), 2);
+}
+
+#define throttle_test(fn) \
+    cmocka_unit_test_setup_teardown(fn, setup_test, teardown_test)
+
+PCMK__UNIT_TEST(pcmk__xml_test_setup_group, pcmk__xml_test_teardown_group,
+                throttle_test(fast_results_only),
+                throttle_test(slow_result_halves_limit),
+                throttle_test(slow_burst_counts_once),
+                throttle_test(limit_at_least_one),
+                throttle_test(fast_results_raise_limit),
+                throttle_test(busy_node_not_raised),
+                throttle_test(load_limit_applies),
+                throttle_test(slow_results_detected),
+                throttle_test(queue_without_window),
+                throttle_test(queue_crosses_window),
+                throttle_test(queue_recounted))
@@ -0,0 +1,552 @@
+/*
+ * Copyright 2026 the Pacemaker project contributors
+ *
+ * The version control history for this file may have further details.
+ *
+ * This source code is licensed under the GNU General Public License version 2
+ * or later (GPLv2+) WITHOUT ANY WARRANTY.
+ */
+
+#include <crm_internal.h>
+
+#include <crm/common/unittest_internal.h>
+
+// The code under test uses static state, so build it into this test directly
+#include "controld_throttle.c"
+
+/* This replays the transition graphs expected by the scheduler regression
+ * tests against a model executor, once with a fixed per-node job limit (as the
+ * controller uses when node load is negligible) and once with the limit
+ * adapted to action latency by the code under test.
+ *
+ * In the model, a node slows down once it runs more actions than it has
+ * capacity for, and some nodes may be slower than others. Graphs are executed
+ * by libpacemaker as the controller executes them, with resource actions
+ * allowed only while their nodes are under the job limit the code under test
+ * gives. Nodes report their executor queue lengths to the code under test as
+ * the controller does, periodically and when the length crosses the limit.
+ */
+
+/* Stand-ins for the parts of the controller that the code under test uses */
+
+GList *
+lrm_state_get_list(void)
+{
+    return NULL;
+}
+
+bool
+pcmk__cluster_send_message(const pcmk__node_status_t *node,
+                           enum pcmk_ipc_server service, const xmlNode *data)
+{
+    return true;
+}
+
+unsigned int
+pcmk__cluster_num_active_nodes(void)
+{
+    return 1;
+}
+
+// Per-node job limit allowed by node load
+#define JOB_LIMIT 8
+
+// Timeout used for actions that don't specify one
+#define DEFAULT_TIMEOUT_MS 20000
+
+// How often nodes report their executor queue length (the throttle timer)
+#define REPORT_INTERVAL_MS (30 * 1000)
+
+// Node model
+struct model {
+    double latency_ms;      // Median action duration on an idle node
+    int capacity;           // Actions a node can run before each slows down
+    int slow_nodes;         // Number of nodes (in name order) that are slow
+    double slow_factor;     // How many times longer actions take on slow nodes
+};
+
+// Totals for all graphs replayed with one job limit
+struct replay_stats {
+    int graphs;             // Graphs executed to completion
+    int actions;            // Resource actions subject to job limits
+    int slow;               // Results counted as slow by the code under test
+    int timeouts;           // Results that timed out
+    double time_ms;         // Total time to execute all graphs
+};
+
+// State of a node in the model executor
+struct model_node {
+    char *name;
+    double latency_ms;      // Median action duration when idle
+    int running;            // Number of actions in flight
+    int reported;           // Number of actions in flight last reported
+};
+
+// Resource action in flight in the model executor
+struct model_action {
+    pcmk__graph_action_t *action;
+    GList *nodes;           // Nodes action counts against (struct model_node)
+    double duration_ms;     // How long action takes
+    double end_ms;          // When action's result is received
+};
+
+static const struct model *model = NULL;
+static bool adaptive = false;
+static GHashTable *nodes = NULL;    // Node name -> struct model_node
+static GList *in_flight = NULL;     // struct model_action, in order of end_ms
+static double now_ms = 0.0;
+
+static void
+free_model_node(void *data)
+{
+    struct model_node *node = data;
+
+    free(node->name);
+    free(node);
+}
+
+static struct model_node *
+get_node(const char *name)
+{
+    struct model_node *node = g_hash_table_lookup(nodes, name);
+
+    if (node == NULL) {
+        node = pcmk__assert_alloc(1, sizeof(struct model_node));
+        node->name = pcmk__str_copy(name);
+        node->latency_ms = model->latency_ms;
+        g_hash_table_insert(nodes, node->name, node);
+    }
+    return node;
+}
+
+/*!
+ * \internal
+ * \brief Get the nodes a resource action counts against for job limits
+ *
+ * This follows graph_action_allowed() in the controller.
+ *
+ * \param[in] action  Graph action to check
+ *
+ * \return Newly allocated list of nodes (struct model_node) that \p action
+ *         counts against
+ */
+static GList *
+counted_nodes(const pcmk__graph_action_t *action)
+{
+    const char *task = pcmk__xe_get(action->xml, PCMK_XA_OPERATION);
+    const char *target = NULL;
+    GList *counted = NULL;
+
+    if ((action->type != pcmk__rsc_graph_action)
+        || (pcmk__xe_get(action->xml, PCMK__META_ON_NODE) == NULL)) {
+        return NULL;
+    }
+
+    target = pcmk__xe_get(action->xml, PCMK__XA_ROUTER_NODE);
+
+    if ((target == NULL)
+        && pcmk__strcase_any_of(task, PCMK_ACTION_MIGRATE_TO,
+                                PCMK_ACTION_MIGRATE_FROM, NULL)) {
+
+        const char *source = crm_meta_value(action->params,
+                                            PCMK__META_MIGRATE_SOURCE);
+
+        target = crm_meta_value(action->params, PCMK__META_MIGRATE_TARGET);
+        if (source != NULL) {
+            counted = g_list_append(counted, get_node(source));
+        }
+
+    } else if (target == NULL) {
+        target = pcmk__xe_get(action->xml, PCMK__META_ON_NODE);
+    }
+
+    if (target != NULL) {
+        counted = g_list_append(counted, get_node(target));
+    }
+    return counted;
+}
+
+/*!
+ * \internal
+ * \brief Report a node's executor queue length to the code under test
+ *
+ * \param[in,out] node  Node to report
+ */
+static void
+report_queue(struct model_node *node)
+{
+    xmlNode *xml = pcmk__xe_create(NULL, PCMK__XE_MESSAGE);
+
+    pcmk__xe_set(xml, PCMK__XA_SRC, node->name);
+    pcmk__xe_set_int(xml, PCMK__XA_CRM_LIMIT_MODE, throttle_none);
+    pcmk__xe_set_int(xml, PCMK__XA_CRM_LIMIT_MAX, JOB_LIMIT);
+    pcmk__xe_set_int(xml, PCMK__XA_CRM_LIMIT_QUEUE, node->running);
+    throttle_update(xml);
+    pcmk__xml_free(xml);
+
+    node->reported = node->running;
+}
+
+/*!
+ * \internal
+ * \brief Report a node's queue length if it crossed the node's job limit
+ *
+ * This follows throttle_queue_changed(), as run on the node.
+ *
+ * \param[in,out] node  Node to check
+ */
+static void
+check_queue(struct model_node *node)
+{
+    int window = throttle_get_window(node->name);
+
+    if ((window > 0)
+        && ((node->running > window) != (node->reported > window))) {
+        report_queue(node);
+    }
+}
+
+static void
+confirm_action(pcmk__graph_t *graph, pcmk__graph_action_t *action)
+{
+    pcmk__set_graph_action_flags(action, pcmk__graph_action_confirmed);
+    pcmk__update_graph(graph, action);
+}
+
+static int
+model_confirm(pcmk__graph_t *graph, pcmk__graph_action_t *action)
+{
+    confirm_action(graph, action);
+    return pcmk_rc_ok;
+}
+
+static gint
+compare_end(gconstpointer a, gconstpointer b)
+{
+    const struct model_action *action_a = a;
+    const struct model_action *action_b = b;
+
+    // Keep actions that end at the same time in the order they started
+    return (action_a->end_ms > action_b->end_ms)? 1 : -1;
+}
+
+/*!
+ * \internal
+ * \brief Get how long an action will take if started now
+ *
+ * \param[in] action  Graph action to check
+ * \param[in] node    Node where \p action will run
+ *
+ * \return Duration of \p action in milliseconds
+ */
+static double
+action_duration(const pcmk__graph_action_t *action,
+                const struct model_node *node)
+{
+    // Use the same variation for an action regardless of job limit
+    GRand *rand = g_rand_new_with_seed(action->id);
+    double variation = g_rand_double_range(rand, 0.75, 1.25);
+    double load = QB_MAX(1.0, (double) node->running / model->capacity);
+
+    g_rand_free(rand);
+    return node->latency_ms * load * variation;
+}
+
+static int
+model_rsc(pcmk__graph_t *graph, pcmk__graph_action_t *action)
+{
+    GList *counted = counted_nodes(action);
+    struct model_action *running = NULL;
+
+    if (counted == NULL) {
+        confirm_action(graph, action);
+        return pcmk_rc_ok;
+    }
+
+    running = pcmk__assert_alloc(1, sizeof(struct model_action));
+    running->action = action;
+    running->nodes = counted;
+    running->duration_ms = action_duration(action, counted->data);
+    running->end_ms = now_ms + running->duration_ms;
+
+    for (GList *iter = counted; iter != NULL; iter = iter->next) {
+        struct model_node *node = iter->data;
+
+        node->running++;
+        check_queue(node);
+    }
+
+    in_flight = g_list_insert_sorted(in_flight, running, compare_end);
+    return pcmk_rc_ok;
+}
+
+static bool
+model_allowed(pcmk__graph_t *graph, pcmk__graph_action_t *action)
+{
+    GList *counted = counted_nodes(action);
+    bool allowed = true;
+
+    for (GList *iter = counted; iter != NULL; iter = iter->next) {
+        const struct model_node *node = iter->data;
+
+        if (node->running >= throttle_get_job_limit(node->name)) {
+            allowed = false;
+        }
+    }
+    g_list_free(counted);
+    return allowed;
+}
+
+static pcmk__graph_functions_t model_fns = {
+    model_confirm,
+    model_rsc,
+    model_confirm,
+    model_confirm,
+    model_allowed,
+};
+
+/*!
+ * \internal
+ * \brief Receive the result of the first action in flight
+ *
+ * \param[in,out] graph  Graph being executed
+ * \param[in,out] stats  Where to count the result
+ */
+static void
+complete_action(pcmk__graph_t *graph, struct replay_stats *stats)
+{
+    struct model_action *done = in_flight->data;
+    int timeout_ms = done->action->timeout;
+    int elapsed_ms = 0;
+    bool timed_out = false;
+
+    in_flight = g_list_delete_link(in_flight, in_flight);
+
+    if (timeout_ms <= 0) {
+        timeout_ms = DEFAULT_TIMEOUT_MS;
+    }
+
+    // An action that exceeds its timeout is reported when it expires
+    timed_out = (done->duration_ms > timeout_ms);
+    elapsed_ms = (int) QB_MIN(done->duration_ms, timeout_ms);
+
+    stats->actions++;
+    if (timed_out) {
+        stats->timeouts++;
+    }
+    if (elapsed_ms > timeout_ms * THROTTLE_SLOW_FRACTION) {
+        stats->slow++;
+    }
+
+    for (GList *iter = done->nodes; iter != NULL; iter = iter->next) {
+        struct model_node *node = iter->data;
+
+        node->running--;
+        if (adaptive) {
+            throttle_record_result(node->name, elapsed_ms, timeout_ms,
+                                   timed_out);
+        }
+        check_queue(node);
+    }
+
+    confirm_action(graph, done->action);
+    g_list_free(done->nodes);
+    free(done);
+}
+
+/*!
+ * \internal
+ * \brief Set up the model executor's nodes for a graph
+ *
+ * \param[in] graph  Graph to be executed
+ */
+static void
+create_nodes(const pcmk__graph_t *graph)
+{
+    GList *names = NULL;
+    int slow = 0;
+
+    nodes = pcmk__strkey_table(NULL, free_model_node);
+
+    for (const GList *s = graph->synapses; s != NULL; s = s->next) {
+        const pcmk__graph_synapse_t *synapse = s->data;
+
+        for (const GList *a = synapse->actions; a != NULL; a = a->next) {
+            g_list_free(counted_nodes(a->data));
+        }
+    }
+
+    names = g_list_sort(g_hash_table_get_keys(nodes),
+                        (GCompareFunc) strcmp);
+
+    for (const GList *iter = names;
+         (iter != NULL) && (slow < model->slow_nodes); iter = iter->next) {
+
+        struct model_node *node = g_hash_table_lookup(nodes, iter->data);
+
+        node->latency_ms *= model->slow_factor;
+        slow++;
+    }
+    g_list_free(names);
+}
+
+/*!
+ * \internal
+ * \brief Execute a graph against the model executor
+ *
+ * \param[in]     filename  Name of file containing graph
+ * \param[in,out] stats     Where to add statistics for graph
+ */
+static void
+replay_graph(const char *filename, struct replay_stats *stats)
+{
+    xmlNode *xml = pcmk__xml_read(filename);
+    pcmk__graph_t *graph = NULL;
+    double next_report_ms = 0.0;
+    GHashTableIter iter;
+    struct model_node *node = NULL;
+
+    assert_non_null(xml);
+    graph = pcmk__unpack_graph(xml, filename);
+    assert_non_null(graph);
+
+    throttle_records = pcmk__strkey_table(NULL, throttle_record_free);
+    create_nodes(graph);
+    now_ms = 0.0;
+
+    while (true) {
+        enum pcmk__graph_status status = pcmk__graph_active;
+
+        while (next_report_ms <= now_ms) {
+            g_hash_table_iter_init(&iter, nodes);
+            while (g_hash_table_iter_next(&iter, NULL, (gpointer *) &node)) {
+                report_queue(node);
+            }
+            next_report_ms += REPORT_INTERVAL_MS;
+        }
+
+        status = pcmk__execute_graph(graph);
+
+        if (graph->complete) {
+            if (status == pcmk__graph_complete) {
+                stats->graphs++;
+            }
+            break;
+        }
+
+        if (in_flight == NULL) {
+            if (status == pcmk__graph_active) {
+                continue; // Confirmed actions may have made others ready
+            }
+            break; // Nothing in flight and nothing can be fired
+        }
+
+        now_ms = ((struct model_action *) in_flight->data)->end_ms;
+        complete_action(graph, stats);
+    }
+
+    stats->time_ms += now_ms;
+
+    g_clear_pointer(&nodes, g_hash_table_destroy);
+    g_clear_pointer(&throttle_records, g_hash_table_destroy);
+    pcmk__free_graph(graph);
+    pcmk__xml_free(xml);
+}
+
+/*!
+ * \internal
+ * \brief Execute all graphs expected by the scheduler regression tests
+ *
+ * \param[in]  use_model     Node model to use
+ * \param[in]  use_adaptive  Whether to adapt job limits to action latency
+ * \param[out] stats         Where to store statistics
+ */
+static void
+replay_all(const struct model *use_model, bool use_adaptive,
+           struct replay_stats *stats)
+{
+    GDir *dir = g_dir_open(PCMK__TEST_GRAPH_DIR, 0, NULL);
+    GList *files = NULL;
+    const char *name = NULL;
+
+    assert_non_null(dir);
+    while ((name = g_dir_read_name(dir)) != NULL) {
+        if (g_str_has_suffix(name, ".exp")) {
+            files = g_list_prepend(files,
+                                   pcmk__assert_asprintf("%s/%s",
+                                                         PCMK__TEST_GRAPH_DIR,
+                                                         name));
+        }
+    }
+    g_dir_close(dir);
+    files = g_list_sort(files, (GCompareFunc) strcmp);
+
+    model = use_model;
+    adaptive = use_adaptive;
+    memset(stats, 0, sizeof(struct replay_stats));
+
+    for (const GList *iter = files; iter != NULL; iter = iter->next) {
+        replay_graph(iter->data, stats);
+    }
+    g_list_free_full(files, free);
+
+    print_message("%s limit: %d graphs, %d limited actions, total time %.1fs, "
+                  "%d slow, %d timed out\n",
+                  (adaptive? "Adaptive" : "Fixed"), stats->graphs,
+                  stats->actions, stats->time_ms / 1000, stats->slow,
+                  stats->timeouts);
+}
+
+static int
+setup(void **state)
+{
+    pcmk__xml_test_setup_group(state);
+    pcmk__set_graph_functions(&model_fns);
+    return 0;
+}
+
+static void
+no_slow_nodes(void **state)
+{
+    // Nodes can run everything they are given without slowing down
+    const struct model fast = { 100.0, JOB_LIMIT, 0, 1.0 };
+    struct replay_stats fixed;
+    struct replay_stats adapted;
+
+    replay_all(&fast, false, &fixed);
+    replay_all(&fast, true, &adapted);
+
+    assert_true(fixed.graphs > 0);
+    assert_true(fixed.actions > 0);
+    assert_int_equal(fixed.slow, 0);
+
+    // Without slow results, latency doesn't limit anything
+    assert_int_equal(adapted.graphs, fixed.graphs);
+    assert_int_equal(adapted.actions, fixed.actions);
+    assert_int_equal(adapted.slow, 0);
+    assert_true(adapted.time_ms == fixed.time_ms);
+}
+
+static void
+slow_node(void **state)
+{
+    // One node is five times slower, and nodes slow down past two actions
+    const struct model mixed = { 1000.0, 2, 1, 5.0 };
+    struct replay_stats fixed;
+    struct replay_stats adapted;
+
+    replay_all(&mixed, false, &fixed);
+    replay_all(&mixed, true, &adapted);
+
+    assert_int_equal(adapted.graphs, fixed.graphs);
+    assert_int_equal(adapted.actions, fixed.actions);
+
+    // Limiting the slow node leads to fewer slow and timed-out results
+    assert_true(fixed.slow > 0);
+    assert_true(adapted.timeouts <= fixed.timeouts);
+    assert_true(adapted.slow < fixed.slow);
+}
+
+PCMK__UNIT_TEST(setup, pcmk__xml_test_teardown_group,
+                cmocka_unit_test(no_slow_nodes),
+                cmocka_unit_test(slow_node))
@@ -13,7 +13,6 @@
 #include <stdlib.h>                     // NULL, free
 #include <sys/types.h>                  // time_t
 #include <time.h>                       // time
-#include <unistd.h>                     // unlink
 
 #include <glib.h>                       // g_hash_table_destroy
 #include <libxml/tree.h>                // xmlNode
@@ -32,6 +31,15 @@
 
 static GHashTable *schedulerd_handlers = NULL;
 
+/* Digest of the most recent scheduler input, and that input after it was
+ * upgraded to the latest schema. When the controller repokes us with an
+ * unchanged CIB, we can schedule it again rather than validating and
+ * transforming the same input again. (Scheduling adds connection resources for
+ * guest nodes to the input, but doesn't add them again if they're present.)
+ */
+static char *last_digest = NULL;
+static xmlNode *last_converted = NULL;
+
 static pcmk_scheduler_t *
 init_scheduler(void)
 {
@@ -63,7 +71,6 @@ handle_pecalc_request(pcmk__request_t *request)
     xmlNode *wrapper = pcmk__xe_first_child(msg, PCMK__XE_CRM_XML, NULL, NULL);
     xmlNode *xml_data = pcmk__xe_first_child(wrapper, NULL, NULL, NULL);
 
-    static char *last_digest = NULL;
     static char *filename = NULL;
 
     unsigned int seq = 0U;
@@ -82,22 +89,33 @@ handle_pecalc_request(pcmk__request_t *request)
                        NULL, CRM_EX_INDETERMINATE);
 
     digest = pcmk__digest_xml(xml_data, false);
-    converted = pcmk__xml_copy(NULL, xml_data);
-    if (pcmk__update_configured_schema(&converted, true) != pcmk_rc_ok) {
-        scheduler->priv->graph = pcmk__xe_create(NULL,
-                                                 PCMK__XE_TRANSITION_GRAPH);
-        pcmk__xe_set_int(scheduler->priv->graph, "transition_id", 0);
-        pcmk__xe_set_int(scheduler->priv->graph, PCMK_OPT_CLUSTER_DELAY, 0);
-        process = false;
-        free(digest);
 
-    } else if (pcmk__str_eq(digest, last_digest, pcmk__str_casei)) {
+    if ((last_converted != NULL)
+        && pcmk__str_eq(digest, last_digest, pcmk__str_casei)) {
+        pcmk__debug("Reusing upgraded scheduler input from previous request");
+        converted = last_converted;
         is_repoke = true;
         free(digest);
 
     } else {
-        free(last_digest);
-        last_digest = digest;
+        converted = pcmk__xml_copy(NULL, xml_data);
+
+        if (pcmk__update_configured_schema(&converted, true) != pcmk_rc_ok) {
+            scheduler->priv->graph = pcmk__xe_create(NULL,
+                                                     PCMK__XE_TRANSITION_GRAPH);
+            pcmk__xe_set_int(scheduler->priv->graph, "transition_id", 0);
+            pcmk__xe_set_int(scheduler->priv->graph, PCMK_OPT_CLUSTER_DELAY,
+                             0);
+            process = false;
+            free(digest);
+
+        } else {
+            free(last_digest);
+            last_digest = digest;
+
+            pcmk__xml_free(last_converted);
+            last_converted = converted;
+        }
     }
 
     if (process) {
@@ -106,6 +124,7 @@ handle_pecalc_request(pcmk__request_t *request)
                                   pcmk__sched_no_counts
                                   |pcmk__sched_show_utilization);
         pcmk__schedule_actions(scheduler);
+        pcmk__log_scheduler_usage(scheduler);
 
         // Don't free converted as part of scheduler
         scheduler->input = NULL;
@@ -166,7 +185,8 @@ handle_pecalc_request(pcmk__request_t *request)
         pcmk__info("Input has not changed since last time, not saving to disk");
 
     } else {
-        unlink(filename);
+        pcmk__remove_series_file(PCMK_SCHEDULER_INPUT_DIR,
+                                 series[series_id].name, seq);
         pcmk__xe_set_time(xml_data, PCMK_XA_EXECUTION_DATE, execution_date);
         pcmk__xml_write_file(xml_data, filename, true);
         pcmk__write_series_sequence(PCMK_SCHEDULER_INPUT_DIR, series[series_id].name,
@@ -176,7 +196,9 @@ handle_pecalc_request(pcmk__request_t *request)
     pcmk__set_result(&request->result, CRM_EX_OK, PCMK_EXEC_DONE, NULL);
 
 done:
-    pcmk__xml_free(converted);
+    if (converted != last_converted) {
+        pcmk__xml_free(converted);
+    }
     pcmk_free_scheduler(scheduler);
 
     return reply;
@@ -223,6 +245,8 @@ void
 schedulerd_unregister_handlers(void)
 {
     g_clear_pointer(&schedulerd_handlers, g_hash_table_destroy);
+    g_clear_pointer(&last_digest, free);
+    g_clear_pointer(&last_converted, pcmk__xml_free);
 }
 
 void
@@ -189,6 +189,7 @@ cib__client_triggers_refresh(const char *name)
 int cib__get_notify_patchset(const xmlNode *msg, const xmlNode **patchset);
 xmlNode *cib__get_calldata(const xmlNode *request);
 void cib__set_calldata(xmlNode *request, xmlNode *data);
+bool cib__acl_enabled(xmlNode *xml, const char *user);
 
 int cib__perform_op_ro(cib__op_fn_t fn, xmlNode *req, xmlNode **current_cib,
                        xmlNode **output);
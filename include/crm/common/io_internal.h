@@ -35,10 +35,25 @@ extern "C" {
 #define PCMK__BZ2_WORK      20
 #define PCMK__BZ2_THRESHOLD (128 * 1024)
 
+//! Compression formats that Pacemaker can read and write
+enum pcmk__compression {
+    pcmk__compression_none,     //!< Not compressed
+    pcmk__compression_bzip2,    //!< \c bzip2 (always supported)
+    pcmk__compression_zstd,     //!< \c zstd (if built with \c libzstd)
+};
+
+enum pcmk__compression pcmk__compression_detect(const void *data,
+                                                size_t length);
+enum pcmk__compression pcmk__compression_from_filename(const char *filename);
+enum pcmk__compression pcmk__compression_configured(void);
+const char *pcmk__compression_extension(enum pcmk__compression codec);
+
 int pcmk__real_path(const char *path, char **resolved_path);
 
 char *pcmk__series_filename(const char *directory, const char *series,
-                            unsigned int sequence, bool bzip);
+                            unsigned int sequence, bool compress);
+void pcmk__remove_series_file(const char *directory, const char *series,
+                              unsigned int sequence);
 int pcmk__read_series_sequence(const char *directory, const char *series,
                                unsigned int *seq);
 void pcmk__write_series_sequence(const char *directory, const char *series,
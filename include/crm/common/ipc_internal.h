@@ -228,9 +228,17 @@ int pcmk__ipc_send_ack_as(const char *function, int line, pcmk__client_t *c,
 
 int pcmk__ipc_prepare_iov(uint32_t request, const GString *message,
                           uint16_t index, struct iovec **result, ssize_t *bytes);
+int pcmk__ipc_send_string(pcmk__client_t *c, uint32_t request,
+                          const GString *message, uint32_t flags);
 int pcmk__ipc_send_xml(pcmk__client_t *c, uint32_t request,
                        const xmlNode *message, uint32_t flags);
 int pcmk__ipc_send_iov(pcmk__client_t *c, struct iovec *iov, uint32_t flags);
+
+typedef struct pcmk__ipc_event_s pcmk__ipc_event_t;
+
+pcmk__ipc_event_t *pcmk__ipc_new_shared_event(struct iovec *iov);
+int pcmk__ipc_send_shared_event(pcmk__client_t *c, pcmk__ipc_event_t *event);
+void pcmk__ipc_unref_event(pcmk__ipc_event_t *event);
 void pcmk__ipc_free_client_buffer(crm_ipc_t *client);
 int pcmk__ipc_msg_append(GByteArray **buffer, guint8 *data);
 xmlNode *pcmk__client_data2xml(pcmk__client_t *c, uint32_t *id, uint32_t *flags);
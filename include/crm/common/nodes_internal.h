@@ -127,6 +127,15 @@ struct pcmk__node_private {
     pcmk_scheduler_t *scheduler;        // Scheduler data that node is part of
 };
 
+/* Node copies (see pe__copy_node()) are created and freed in large numbers
+ * during assignment, so each copy is a single allocation holding both the node
+ * object and its own assignment data
+ */
+typedef struct {
+    pcmk_node_t node;                       // Must be first
+    struct pcmk__node_assignment assign;    // Copy's assignment data
+} pcmk__node_copy_t;
+
 void pcmk__free_node_copy(void *data);
 pcmk_node_t *pcmk__find_node_in_list(const GList *nodes, const char *node_name);
 
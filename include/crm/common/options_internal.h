@@ -149,6 +149,7 @@ bool pcmk__valid_fencing_watchdog_timeout(const char *value);
 #define PCMK__ENV_CALLGRIND_ENABLED         "callgrind_enabled"
 #define PCMK__ENV_CERT_FILE                 "cert_file"
 #define PCMK__ENV_CLUSTER_TYPE              "cluster_type"
+#define PCMK__ENV_COMPRESSION               "compression"
 #define PCMK__ENV_CRL_FILE                  "crl_file"
 #define PCMK__ENV_DEBUG                     "debug"
 #define PCMK__ENV_FAIL_FAST                 "fail_fast"
@@ -225,6 +226,7 @@ bool pcmk__valid_fencing_watchdog_timeout(const char *value);
 #define PCMK__VALUE_LRMD                    "lrmd"
 #define PCMK__VALUE_MAINT                   "maint"
 #define PCMK__VALUE_OUTPUT                  "output"
+#define PCMK__VALUE_PARTIAL                 "partial"
 #define PCMK__VALUE_PASSWORD                "password"
 #define PCMK__VALUE_PRIMITIVE               "primitive"
 #define PCMK__VALUE_REFRESH                 "refresh"
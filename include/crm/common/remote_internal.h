@@ -54,7 +54,13 @@ typedef struct {
     gnutls_session_t tls_session;
 } pcmk__remote_t;
 
+typedef struct pcmk__remote_msg_s pcmk__remote_msg_t;
+
 int pcmk__remote_send_xml(pcmk__remote_t *remote, const xmlNode *msg);
+int pcmk__remote_prepare_xml(const xmlNode *msg, pcmk__remote_msg_t **prepared);
+int pcmk__remote_send_prepared(pcmk__remote_t *remote,
+                               pcmk__remote_msg_t *prepared);
+void pcmk__remote_free_prepared(pcmk__remote_msg_t *prepared);
 int pcmk__remote_ready(const pcmk__remote_t *remote, int timeout_ms);
 int pcmk__read_available_remote_data(pcmk__remote_t *remote);
 int pcmk__read_remote_message(pcmk__remote_t *remote, int timeout_ms);
@@ -15,6 +15,7 @@
 #define PCMK__CRM_COMMON_SCHEDULER_INTERNAL__H
 
 #include <inttypes.h>                          // UINT64_C
+#include <time.h>                              // clock_t
 #include <crm/common/action_relation_internal.h>
 #include <crm/common/actions_internal.h>
 #include <crm/common/attrs_internal.h>
@@ -177,6 +178,32 @@ enum pcmk__scheduler_flags {
     pcmk__sched_fence_remote_no_quorum  = (UINT64_C(1) << 28),
 };
 
+// Phases of a scheduler run whose resource usage is recorded
+enum pcmk__sched_phase {
+    pcmk__sched_phase_unpack = 0,       // Unpack CIB, health, constraints
+    pcmk__sched_phase_node_criteria,    // Apply node-specific criteria
+    pcmk__sched_phase_assign,           // Assign resources to nodes
+    pcmk__sched_phase_actions,          // Schedule resource and node actions
+    pcmk__sched_phase_orderings,        // Apply ordering constraints
+    pcmk__sched_phase_graph,            // Create transition graph
+
+    // Number of phases (not a phase itself)
+    pcmk__sched_phase_max,
+};
+
+// Resource usage recorded for one scheduler phase
+typedef struct {
+    double wall_s;          // Elapsed (monotonic) time in seconds
+    double cpu_s;           // Process CPU time in seconds
+    long max_rss_kb;        // Process peak resident set size after phase (KiB)
+} pcmk__sched_usage_t;
+
+// Resource usage at the start of a scheduler phase
+typedef struct {
+    int64_t wall_us;        // Monotonic time (in microseconds)
+    clock_t cpu;            // Process CPU time
+} pcmk__sched_mark_t;
+
 // Implementation of pcmk__scheduler_private_t
 struct pcmk__scheduler_private {
     // Be careful about when each piece of information is available and final
@@ -209,8 +236,12 @@ struct pcmk__scheduler_private {
     GHashTable *tags;               // Key = tag ID, value = element list
     GList *actions;                 // All scheduled actions
     GHashTable *singletons;         // Scheduled non-resource actions
+    GHashTable *action_index;       // Key = action key, value = GQueue of
+                                    // actions with that key
     int next_action_id;             // Counter used as ID for actions
     xmlNode *failed;                // History entries of failed actions
+    GHashTable *history_index;      // Key = node name, value = table of
+                                    // resource history elements by ID
     GList *param_check;             // History entries that need to be checked
     GList *stop_needed;             // Containers that need stop actions
     GList *location_constraints;    // Location constraints
@@ -224,6 +255,9 @@ struct pcmk__scheduler_private {
     time_t recheck_by;              // Hint to controller when to reschedule
     xmlNode *graph;                 // Transition graph
     int synapse_count;              // Number of transition graph synapses
+
+    // Resource usage of each phase of most recent scheduler run
+    pcmk__sched_usage_t usage[pcmk__sched_phase_max];
 };
 
 // Group of enum pcmk__warnings flags for warnings we want to log once
@@ -312,6 +346,13 @@ extern uint32_t pcmk__warnings;
     } while (0)
 
 void pcmk__set_scheduler_defaults(pcmk_scheduler_t *scheduler);
+const char *pcmk__sched_phase_text(enum pcmk__sched_phase phase);
+void pcmk__sched_phase_start(pcmk__sched_mark_t *mark);
+void pcmk__sched_phase_end(pcmk_scheduler_t *scheduler,
+                           enum pcmk__sched_phase phase,
+                           const pcmk__sched_mark_t *mark);
+void pcmk__add_sched_usage(pcmk__sched_usage_t *total,
+                           const pcmk__sched_usage_t *usage);
 time_t pcmk__scheduler_epoch_time(pcmk_scheduler_t *scheduler);
 void pcmk__update_recheck_time(time_t recheck, pcmk_scheduler_t *scheduler,
                                const char *reason);
@@ -49,6 +49,8 @@ void pcmk__add_separated_word(GString **list, size_t init_size,
                               const char *word, const char *separator);
 int pcmk__compress(const char *data, size_t length, char **result,
                    size_t *result_len);
+int pcmk__decompress(const char *data, size_t length, char *result,
+                     size_t *result_len);
 
 int pcmk__scan_ll(const char *text, long long *result, long long default_value);
 int pcmk__scan_min_int(const char *text, int *result, int minimum);
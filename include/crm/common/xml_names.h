@@ -160,6 +160,7 @@ extern "C" {
 #define PCMK_XE_PARAMETERS                  "parameters"
 #define PCMK_XE_PATCHSET                    "patchset"
 #define PCMK_XE_PERIOD                      "period"
+#define PCMK_XE_PHASE                       "phase"
 #define PCMK_XE_PODMAN                      "podman"
 #define PCMK_XE_PORT_MAPPING                "port-mapping"
 #define PCMK_XE_POSITION                    "position"
@@ -254,6 +255,7 @@ extern "C" {
 #define PCMK_XA_COMPLETED                   "completed"
 #define PCMK_XA_CONTROL_PORT                "control-port"
 #define PCMK_XA_COUNT                       "count"
+#define PCMK_XA_CPU_DURATION                "cpu-duration"
 #define PCMK_XA_CRM_DEBUG_ORIGIN            "crm-debug-origin"
 #define PCMK_XA_CRM_FEATURE_SET             "crm_feature_set"
 #define PCMK_XA_CRMD                        "crmd"
@@ -327,6 +329,7 @@ extern "C" {
 #define PCMK_XA_MAINTENANCE                 "maintenance"
 #define PCMK_XA_MAINTENANCE_MODE            "maintenance-mode"
 #define PCMK_XA_MANAGED                     "managed"
+#define PCMK_XA_MAX_RSS                     "max-rss"
 #define PCMK_XA_MESSAGE                     "message"
 #define PCMK_XA_MINUTES                     "minutes"
 #define PCMK_XA_MIXED_VERSION               "mixed_version"
@@ -219,9 +219,11 @@ pcmk_action_t *find_first_action(const GList *input, const char *uuid,
 enum pcmk__action_type get_complex_task(const pcmk_resource_t *rsc,
                                         const char *name);
 
-GList *find_actions(GList *input, const char *key, const pcmk_node_t *on_node);
-GList *find_actions_exact(GList *input, const char *key,
-                          const pcmk_node_t *on_node);
+pcmk_action_t *pe__find_resource_action(const pcmk_resource_t *rsc,
+                                        const char *key,
+                                        const pcmk_node_t *on_node);
+GList *pe__resource_actions_by_key(const pcmk_resource_t *rsc, const char *key,
+                                   const pcmk_node_t *node, bool require_node);
 GList *pe__resource_actions(const pcmk_resource_t *rsc, const pcmk_node_t *node,
                             const char *task, bool require_node);
 
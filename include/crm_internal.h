@@ -73,6 +73,8 @@ extern "C" {
 #define PCMK__ATTRD_CMD_QUERY           "query"
 #define PCMK__ATTRD_CMD_REFRESH         "refresh"
 #define PCMK__ATTRD_CMD_SYNC_RESPONSE   "sync-response"
+#define PCMK__ATTRD_CMD_SYNC_SUMMARY    "sync-summary"
+#define PCMK__ATTRD_CMD_SYNC_REQUEST    "sync-request"
 #define PCMK__ATTRD_CMD_CLEAR_FAILURE   "clear-failure"
 #define PCMK__ATTRD_CMD_CONFIRM         "confirm"
 
@@ -41,6 +41,7 @@ typedef struct {
 void pcmk__unpack_constraints(pcmk_scheduler_t *scheduler);
 
 void pcmk__schedule_actions(pcmk_scheduler_t *scheduler);
+void pcmk__log_scheduler_usage(const pcmk_scheduler_t *scheduler);
 
 GList *pcmk__copy_node_list(const GList *list, bool reset);
 
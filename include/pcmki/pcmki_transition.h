@@ -17,7 +17,7 @@
 #include <stdint.h>                     // uint32_t
 #include <sys/types.h>                  // time_t
 
-#include <glib.h>                       // GList, GHashTable
+#include <glib.h>                       // GList, GHashTable, GSequence
 #include <libxml/tree.h>                // xmlNode
 
 #include <crm/common/scheduler_types.h> // pcmk_scheduler_t
@@ -52,6 +52,12 @@ typedef struct {
 
     GList *actions;           /* pcmk__graph_action_t* */
     GList *inputs;            /* pcmk__graph_action_t* */
+
+    //! Order of synapse in its graph's list of synapses
+    int position;
+
+    //! Number of inputs that have not been confirmed yet
+    int pending_inputs;
 } pcmk__graph_synapse_t;
 
 #define pcmk__set_synapse_flags(synapse, flags_to_set) do {             \
@@ -141,6 +147,12 @@ typedef struct {
 
     GList *synapses;          /* pcmk__graph_synapse_t* */
 
+    //! Synapse inputs for each action (action ID -> GList of inputs)
+    GHashTable *dependents;
+
+    //! Unexecuted synapses with all inputs confirmed, ordered by position
+    GSequence *ready;
+
     int migration_limit;
 
     //! Failcount after one failed stop action
@@ -662,7 +662,8 @@ file_signoff(cib_t *cib)
 
         /* Otherwise, it's a simple write */
         } else {
-            bool compress = g_str_has_suffix(private->filename, ".bz2");
+            bool compress = (pcmk__compression_from_filename(private->filename)
+                             != pcmk__compression_none);
 
             if (pcmk__xml_write_file(private->cib_xml, private->filename,
                                      compress) != pcmk_rc_ok) {
@@ -149,8 +149,18 @@ read_config(GHashTable *options, xmlNode *current_cib)
     free(now);
 }
 
-static bool
-cib_acl_enabled(xmlNode *xml, const char *user)
+/*!
+ * \internal
+ * \brief Check whether ACLs apply to a user for a given CIB
+ *
+ * \param[in] xml   CIB XML
+ * \param[in] user  User name
+ *
+ * \return \c true if \p user requires ACLs and ACLs are enabled in \p xml,
+ *         otherwise \c false
+ */
+bool
+cib__acl_enabled(xmlNode *xml, const char *user)
 {
     const char *value = NULL;
     GHashTable *options = NULL;
@@ -233,7 +243,7 @@ cib__perform_op_ro(cib__op_fn_t fn, xmlNode *req, xmlNode **current_cib,
 
     cib = *current_cib;
 
-    if (cib_acl_enabled(cib, user)) {
+    if (cib__acl_enabled(cib, user)) {
         cib_filtered = pcmk__acl_filtered_copy(user, cib->doc, cib);
 
         if (cib_filtered == NULL) {
@@ -523,7 +533,7 @@ cib__perform_op_rw(enum cib_variant variant, cib__op_fn_t fn, xmlNode *req,
     user = pcmk__xe_get(req, PCMK__XA_CIB_USER);
     pcmk__xe_get_flags(req, PCMK__XA_CIB_CALLOPT, &call_options, cib_none);
 
-    enable_acl = cib_acl_enabled(*cib, user);
+    enable_acl = cib__acl_enabled(*cib, user);
 
     pcmk__trace("Processing %s for section '%s', user '%s'", op,
                 pcmk__s(section, "(null)"), pcmk__s(user, "(null)"));
@@ -653,7 +663,7 @@ done:
     /* @TODO This may not work correctly when !should_copy_cib(), since we don't
      * keep the original CIB.
      */
-    if ((rc != pcmk_rc_ok) && cib_acl_enabled(old_versions, user)) {
+    if ((rc != pcmk_rc_ok) && cib__acl_enabled(old_versions, user)) {
         xmlNode *saved_cib = *cib;
 
         *cib = pcmk__acl_filtered_copy(user, old_versions->doc, *cib);
@@ -19,7 +19,6 @@
 #include <sys/types.h>                  // size_t
 #include <sys/utsname.h>
 
-#include <bzlib.h>
 #include <corosync/corodefs.h>
 #include <corosync/corotypes.h>
 #include <corosync/hdb.h>
@@ -463,14 +462,13 @@ pcmk__cpg_message_data(cpg_handle_t handle, uint32_t sender_id, uint32_t pid,
     }
 
     if (msg->is_compressed && (msg->size > 0)) {
-        int rc = BZ_OK;
-        unsigned int new_size = msg->size + 1;
+        int rc = pcmk_rc_ok;
+        size_t new_size = msg->size + 1;
         char *uncompressed = pcmk__assert_alloc(new_size, sizeof(char));
 
-        rc = BZ2_bzBuffToBuffDecompress(uncompressed, &new_size, msg->data,
-                                        msg->compressed_size, 1, 0);
-        rc = pcmk__bzlib2rc(rc);
-        if ((rc == pcmk_rc_ok) && (msg->size != new_size)) { // libbz2 bug?
+        rc = pcmk__decompress(msg->data, msg->compressed_size, uncompressed,
+                              &new_size);
+        if ((rc == pcmk_rc_ok) && (msg->size != new_size)) { // Bad header?
             rc = pcmk_rc_compression;
         }
         if (rc != pcmk_rc_ok) {
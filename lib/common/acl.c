@@ -29,8 +29,34 @@
 typedef struct {
     enum pcmk__xml_flags mode;
     gchar *xpath;
+    xmlXPathCompExpr *expr;     //!< Compiled \c xpath (\c NULL if invalid)
+    unsigned int refs;          //!< Number of lists that contain this ACL
 } xml_acl_t;
 
+/* ACLs granted to one PCMK_XE_ACL_TARGET or PCMK_XE_ACL_GROUP element. These
+ * are unpacked for all targets and groups at once and shared by all users, so
+ * that role references are resolved and XPath expressions are compiled only
+ * when the PCMK_XE_ACLS section changes.
+ */
+typedef struct {
+    bool is_group;  //!< Whether this is a group (rather than user) entry
+    char *name;     //!< User or group name
+    GList *acls;    //!< ACLs granted to \c name (<tt>xml_acl_t *</tt>)
+} acl_holder_t;
+
+// ACL holders unpacked from the most recently used PCMK_XE_ACLS section
+static struct {
+    char *digest;   //!< Digest of the PCMK_XE_ACLS section unpacked
+    GList *holders; //!< Holders in document order (<tt>acl_holder_t *</tt>)
+} acl_cache = { NULL, NULL };
+
+// Modes of nodes matched by ACLs, for creating an ACL-filtered copy
+struct acl_modes {
+    GHashTable *table;          //!< Modes keyed by element (<tt>xmlNode *</tt>)
+    GHashTable *denied_below;   //!< Elements with a denied descendant
+    const xml_acl_t *acl;       //!< ACL currently being matched
+};
+
 /*!
  * \internal
  * \brief Free an \c xml_acl_t object
@@ -44,11 +70,14 @@ free_acl(void *data)
 {
     xml_acl_t *acl = data;
 
-    if (acl == NULL) {
+    if ((acl == NULL) || (--acl->refs > 0)) {
         return;
     }
 
     g_free(acl->xpath);
+    if (acl->expr != NULL) {
+        xmlXPathFreeCompExpr(acl->expr);
+    }
     free(acl);
 }
 
@@ -219,29 +248,33 @@ create_acl(const xmlNode *xml, enum pcmk__xml_flags mode)
     warn_on_specifier_mismatch(xml, xpath, ref, tag, attr);
 
     acl->mode = mode;
+    acl->refs = 1;
 
     if (xpath != NULL) {
         acl->xpath = g_strdup(xpath);
-        return acl;
-    }
 
-    buf = g_string_sized_new(128);
+    } else {
+        buf = g_string_sized_new(128);
 
-    g_string_append_printf(buf, "//%s", pcmk__s(tag, "*"));
+        g_string_append_printf(buf, "//%s", pcmk__s(tag, "*"));
 
-    if ((ref != NULL) && (attr != NULL)) {
-        // Not possible with schema validation enabled
-        g_string_append_printf(buf, "[@" PCMK_XA_ID "='%s' and @%s]", ref,
-                               attr);
+        if ((ref != NULL) && (attr != NULL)) {
+            // Not possible with schema validation enabled
+            g_string_append_printf(buf, "[@" PCMK_XA_ID "='%s' and @%s]", ref,
+                                   attr);
 
-    } else if (ref != NULL) {
-        g_string_append_printf(buf, "[@" PCMK_XA_ID "='%s']", ref);
+        } else if (ref != NULL) {
+            g_string_append_printf(buf, "[@" PCMK_XA_ID "='%s']", ref);
 
-    } else if (attr != NULL) {
-        g_string_append_printf(buf, "[@%s]", attr);
+        } else if (attr != NULL) {
+            g_string_append_printf(buf, "[@%s]", attr);
+        }
+
+        acl->xpath = g_string_free(buf, FALSE);
     }
 
-    acl->xpath = g_string_free(buf, FALSE);
+    // If this fails, libxml2 logs the error, and the ACL will match nothing
+    acl->expr = xmlXPathCompile((const xmlChar *) acl->xpath);
     return acl;
 }
 
@@ -484,105 +517,208 @@ unpack_acl_role_ref_or_perm(xmlNode *xml, void *user_data)
 
 /*!
  * \internal
- * \brief Unpack an ACL target (user) element to a list of \c xml_acl_t
+ * \brief Free an \c acl_holder_t object
  *
- * \param[in]     xml      \c PCMK_XE_ACL_TARGET element to unpack
- * \param[in,out] docpriv  XML document private data whose \c acls field to
- *                         append to
+ * \param[in,out] data  \c acl_holder_t object to free
+ *
+ * \note This is a \c GDestroyNotify function.
  */
 static void
-unpack_acl_target(xmlNode *xml, xml_doc_private_t *docpriv)
+free_acl_holder(void *data)
 {
-    const char *id = pcmk__s(pcmk__xe_get(xml, PCMK_XA_NAME), pcmk__xe_id(xml));
+    acl_holder_t *holder = data;
+
+    if (holder == NULL) {
+        return;
+    }
 
+    free(holder->name);
+    pcmk__free_acls(holder->acls);
+    free(holder);
+}
+
+/*!
+ * \internal
+ * \brief Unpack an ACL target (user) or group element to an \c acl_holder_t
+ *
+ * \param[in]     xml        Element to unpack (\c PCMK_XE_ACL_TARGET
+ *                           or \c PCMK_XE_ACL_GROUP)
+ * \param[in,out] user_data  List of ACL holders to append to
+ *                           (<tt>GList **</tt>)
+ *
+ * \return \c pcmk_rc_ok (to keep iterating)
+ *
+ * \note This is used as a callback for \c pcmk__xe_foreach_child().
+ */
+static int
+unpack_acl_target_or_group(xmlNode *xml, void *user_data)
+{
+    GList **holders = user_data;
+    bool is_group = false;
+    const char *id = NULL;
+    acl_holder_t *holder = NULL;
+
+    if (pcmk__xe_is(xml, PCMK_XE_ACL_GROUP)) {
+        is_group = true;
+
+    } else if (!pcmk__xe_is(xml, PCMK_XE_ACL_TARGET)) {
+        return pcmk_rc_ok;
+    }
+
+    id = pcmk__s(pcmk__xe_get(xml, PCMK_XA_NAME), pcmk__xe_id(xml));
     if (id == NULL) {
         // Not possible with schema validation enabled
-        pcmk__config_err("Ignoring <" PCMK_XE_ACL_TARGET "> element with no "
-                         PCMK_XA_NAME " or " PCMK_XA_ID " attribute");
+        pcmk__config_err("Ignoring <%s> element with no " PCMK_XA_NAME " or "
+                         PCMK_XA_ID " attribute", (const char *) xml->name);
 
-        // There is no user ID for the current ACL user to match
-        return;
+        // There is no user or group ID for the current ACL user to match
+        return pcmk_rc_ok;
     }
 
-    if (!pcmk__str_eq(id, docpriv->acl_user, pcmk__str_none)) {
-        return;
-    }
+    pcmk__trace("Unpacking ACLs for %s '%s'", (is_group? "group" : "user"),
+                id);
 
-    pcmk__trace("Unpacking ACLs for user '%s'", id);
+    holder = pcmk__assert_alloc(1, sizeof(acl_holder_t));
+    holder->is_group = is_group;
+    holder->name = pcmk__str_copy(id);
     pcmk__xe_foreach_child(xml, NULL, unpack_acl_role_ref_or_perm,
-                           &docpriv->acls);
+                           &holder->acls);
+
+    *holders = g_list_prepend(*holders, holder);
+    return pcmk_rc_ok;
 }
 
 /*!
  * \internal
- * \brief Unpack an ACL group element to a list of \c xml_acl_t
+ * \brief Find the \c PCMK_XE_ACLS element in an XML document
+ *
+ * \param[in] doc  XML document to search
  *
- * \param[in]     xml      \c PCMK_XE_ACL_TARGET element to unpack
- * \param[in,out] docpriv  XML document private data whose \c acls field to
- *                         append to
+ * \return \c PCMK_XE_ACLS element in \p doc, or \c NULL if none is found
  */
-static void
-unpack_acl_group(xmlNode *xml, xml_doc_private_t *docpriv)
+static xmlNode *
+find_acls_section(xmlDoc *doc)
 {
-    const char *id = pcmk__s(pcmk__xe_get(xml, PCMK_XA_NAME), pcmk__xe_id(xml));
+    xmlNode *acls = NULL;
 
-    if (id == NULL) {
-        // Not possible with schema validation enabled
-        pcmk__config_err("Ignoring <" PCMK_XE_ACL_GROUP "> element with no "
-                         PCMK_XA_NAME " or " PCMK_XA_ID " attribute");
+    // The schema allows PCMK_XE_ACLS only here, so avoid a full search
+    if (doc != NULL) {
+        acls = pcmk__xe_first_child(xmlDocGetRootElement(doc),
+                                    PCMK_XE_CONFIGURATION, NULL, NULL);
+        acls = pcmk__xe_first_child(acls, PCMK_XE_ACLS, NULL, NULL);
+    }
+    if (acls == NULL) {
+        acls = pcmk__xpath_find_one(doc, "//" PCMK_XE_ACLS, PCMK__LOG_NEVER);
+    }
+    return acls;
+}
 
-        // There is no group ID for the current ACL user to match
-        return;
+/*!
+ * \internal
+ * \brief Get the ACL holders defined by a \c PCMK_XE_ACLS section
+ *
+ * The holders are unpacked again only if the section differs from the one
+ * used the last time this was called.
+ *
+ * \param[in] acls  \c PCMK_XE_ACLS element (may be \c NULL)
+ *
+ * \return List of ACL holders (<tt>acl_holder_t *</tt>) defined by \p acls
+ *
+ * \note The return value is owned by the cache and is valid only until the
+ *       next call.
+ */
+static GList *
+get_acl_holders(xmlNode *acls)
+{
+    char *digest = NULL;
+
+    if (acls == NULL) {
+        pcmk__acl_cleanup();
+        return NULL;
     }
 
-    if (!pcmk__is_user_in_group(docpriv->acl_user, id)) {
-        return;
+    digest = pcmk__digest_xml(acls, false);
+    if (pcmk__str_eq(digest, acl_cache.digest, pcmk__str_none)) {
+        free(digest);
+        return acl_cache.holders;
     }
 
-    pcmk__trace("Unpacking ACLs for group '%s' (user '%s')", id,
-                docpriv->acl_user);
-    pcmk__xe_foreach_child(xml, NULL, unpack_acl_role_ref_or_perm,
-                           &docpriv->acls);
+    pcmk__acl_cleanup();
+    acl_cache.digest = digest;
+    pcmk__xe_foreach_child(acls, NULL, unpack_acl_target_or_group,
+                           &acl_cache.holders);
+    acl_cache.holders = g_list_reverse(acl_cache.holders);
+    return acl_cache.holders;
 }
 
 /*!
  * \internal
- * \brief Unpack an ACL target (user) or group element to a list of \c xml_acl_t
+ * \brief Free the cached ACL definitions
+ */
+void
+pcmk__acl_cleanup(void)
+{
+    g_clear_pointer(&acl_cache.digest, free);
+    g_list_free_full(acl_cache.holders, free_acl_holder);
+    acl_cache.holders = NULL;
+}
+
+/*!
+ * \internal
+ * \brief Get the ACLs that apply to a user
  *
- * \param[in]     xml        Element to unpack (\c PCMK_XE_ACL_TARGET
- *                           or \c PCMK_XE_ACL_GROUP)
- * \param[in,out] user_data  XML document private data whose \c acls field to
- *                           append to (<tt>xml_doc_private_t *</tt>)
+ * \param[in] source  XML document whose ACL definitions to use
+ * \param[in] user    User whose ACLs to get
  *
- * \return \c pcmk_rc_ok (to keep iterating)
+ * \return List of ACLs (<tt>xml_acl_t *</tt>) that apply to \p user
  *
- * \note The caller is responsible for freeing \p user_data->acls using
+ * \note The caller is responsible for freeing the return value using
  *       \c pcmk__free_acls().
- * \note This is used as a callback for \c pcmk__xe_foreach_child().
  */
-static int
-unpack_acl_target_or_group(xmlNode *xml, void *user_data)
+static GList *
+user_acls(xmlDoc *source, const char *user)
 {
-    if (pcmk__xe_is(xml, PCMK_XE_ACL_TARGET)) {
-        unpack_acl_target(xml, user_data);
-        return pcmk_rc_ok;
-    }
+    GList *result = NULL;
 
-    if (pcmk__xe_is(xml, PCMK_XE_ACL_GROUP)) {
-        unpack_acl_group(xml, user_data);
-        return pcmk_rc_ok;
-    }
+    for (const GList *iter = get_acl_holders(find_acls_section(source));
+         iter != NULL; iter = iter->next) {
 
-    return pcmk_rc_ok;
+        const acl_holder_t *holder = iter->data;
+
+        if (holder->is_group) {
+            if (!pcmk__is_user_in_group(user, holder->name)) {
+                continue;
+            }
+            pcmk__trace("Using ACLs for group '%s' (user '%s')", holder->name,
+                        user);
+
+        } else if (pcmk__str_eq(holder->name, user, pcmk__str_none)) {
+            pcmk__trace("Using ACLs for user '%s'", user);
+
+        } else {
+            continue;
+        }
+
+        for (GList *acl_iter = holder->acls; acl_iter != NULL;
+             acl_iter = acl_iter->next) {
+
+            xml_acl_t *acl = acl_iter->data;
+
+            acl->refs++;
+            result = g_list_prepend(result, acl);
+        }
+    }
+    return g_list_reverse(result);
 }
 
 /*!
  * \internal
  * \brief Add a user's ACLs to a target XML document's private data
  *
- * Unpack the ACLs that apply to the user from the \c PCMK_XE_ACLS element in
- * the source document to the \c acls list in the target document. If that list
- * is already non-empty or if the user doesn't require ACLs, do nothing.
+ * Get the ACLs that apply to the user from the \c PCMK_XE_ACLS element in the
+ * source document, and set them as the \c acls list in the target document. If
+ * that list is already non-empty or if the user doesn't require ACLs, do
+ * nothing.
  *
  * Also set the target document's \c acl_user field to the given user.
  *
@@ -593,8 +729,6 @@ unpack_acl_target_or_group(xmlNode *xml, void *user_data)
 static void
 unpack_acls(xmlDoc *source, xml_doc_private_t *target, const char *user)
 {
-    xmlNode *acls = NULL;
-
     pcmk__assert(target != NULL);
 
     if ((target->acls != NULL) || !pcmk__acl_required(user)) {
@@ -602,9 +736,41 @@ unpack_acls(xmlDoc *source, xml_doc_private_t *target, const char *user)
     }
 
     pcmk__str_update(&target->acl_user, user);
+    target->acls = user_acls(source, user);
+}
+
+/*!
+ * \internal
+ * \brief Call a function for each node in a document that an ACL matches
+ *
+ * \param[in,out] ctxt       XPath context for the document to search
+ * \param[in]     acl        ACL whose compiled XPath expression to evaluate
+ * \param[in]     fn         Function to call for each matching node
+ * \param[in,out] user_data  Data to pass to \p fn
+ */
+static void
+foreach_acl_match(xmlXPathContext *ctxt, const xml_acl_t *acl,
+                  void (*fn)(xmlNode *, void *), void *user_data)
+{
+    xmlXPathObject *xpath_obj = NULL;
+    int num_results = 0;
+
+    if (acl->expr == NULL) {
+        // Invalid XPath expression (error was logged when compiling it)
+        return;
+    }
+
+    xpath_obj = xmlXPathCompiledEval(acl->expr, ctxt);
+    num_results = pcmk__xpath_num_results(xpath_obj);
+
+    for (int i = 0; i < num_results; i++) {
+        xmlNode *result = pcmk__xpath_result(xpath_obj, i);
 
-    acls = pcmk__xpath_find_one(source, "//" PCMK_XE_ACLS, PCMK__LOG_NEVER);
-    pcmk__xe_foreach_child(acls, NULL, unpack_acl_target_or_group, target);
+        if (result != NULL) {
+            fn(result, user_data);
+        }
+    }
+    xmlXPathFreeObject(xpath_obj);
 }
 
 /*!
@@ -677,15 +843,15 @@ apply_acl_to_match(xmlNode *match, void *user_data)
  * See \c apply_acl_to_match() for details on applying the ACL.
  *
  * \param[in,out] data       ACL object to apply (<tt>xml_acl_t *</tt>)
- * \param[in,out] user_data  XML document to match against (<tt>xmlDoc *</tt>)
+ * \param[in,out] user_data  XPath context for the XML document to match
+ *                           against (<tt>xmlXPathContext *</tt>)
  */
 static void
 apply_acl_to_doc(void *data, void *user_data)
 {
     xml_acl_t *acl = data;
-    xmlDoc *doc = user_data;
 
-    pcmk__xpath_foreach_result(doc, acl->xpath, apply_acl_to_match, acl);
+    foreach_acl_match(user_data, acl, apply_acl_to_match, acl);
 }
 
 /*!
@@ -704,15 +870,21 @@ void
 pcmk__apply_acls(xmlDoc *doc)
 {
     xml_doc_private_t *docpriv = NULL;
+    xmlXPathContext *ctxt = NULL;
 
     pcmk__assert(doc != NULL);
     docpriv = doc->_private;
 
-    if (!pcmk__xml_doc_all_flags_set(doc, pcmk__xf_acl_enabled)) {
+    if (!pcmk__xml_doc_all_flags_set(doc, pcmk__xf_acl_enabled)
+        || (docpriv->acls == NULL)) {
         return;
     }
 
-    g_list_foreach(docpriv->acls, apply_acl_to_doc, doc);
+    ctxt = xmlXPathNewContext(doc);
+    pcmk__mem_assert(ctxt);
+
+    g_list_foreach(docpriv->acls, apply_acl_to_doc, ctxt);
+    xmlXPathFreeContext(ctxt);
 }
 
 /*!
@@ -808,25 +980,35 @@ attr_is_id(const xmlAttr *attr, void *user_data)
 
 /*!
  * \internal
- * \brief Check whether an XML attribute's name is not \c PCMK_XA_ID
+ * \brief Record an ACL's mode for a node that matches its XPath expression
  *
- * \param[in] attr       Attribute to check
- * \param[in] user_data  Ignored
+ * This is like \c apply_acl_to_match(), except that the mode is recorded in a
+ * table instead of in the node's private data, so that the document being
+ * matched against is not modified.
  *
- * \return \c true if the attribute's name is not \c PCMK_XA_ID, or \c false
- *         otherwise
- *
- * \note This is compatible with \c pcmk__xe_remove_matching_attrs().
+ * \param[in] match      Node matched by the ACL's XPath expression
+ * \param[in] user_data  Where to record the mode (<tt>struct acl_modes *</tt>)
  */
-static bool
-attr_is_not_id(const xmlAttr *attr, void *user_data)
+static void
+record_acl_match(xmlNode *match, void *user_data)
 {
-    return !attr_is_id(attr, user_data);
+    struct acl_modes *modes = user_data;
+    uint32_t flags = 0;
+
+    // See apply_acl_to_match() for why we might not use match itself
+    match = pcmk__xpath_match_element(match);
+    if (match == NULL) {
+        return;
+    }
+
+    flags = GPOINTER_TO_UINT(g_hash_table_lookup(modes->table, match));
+    flags |= modes->acl->mode;
+    g_hash_table_insert(modes->table, match, GUINT_TO_POINTER(flags));
 }
 
 /*!
  * \internal
- * \brief Filter out nodes that are unreadable by the current ACL user
+ * \brief Copy the parts of an XML tree that are readable by the ACL user
  *
  * Access or denial via ACLs is inherited, with more specific ACLs (those that
  * match the node directly or match a more recent ancestor) taking precedence
@@ -837,41 +1019,41 @@ attr_is_not_id(const xmlAttr *attr, void *user_data)
  * then use that ACL for the current node. If not, then the current node
  * inherits read access or denial from its parent.
  *
- * Filter each child. Each child inherits read access or denial from the current
- * node, unless an ACL matched the child directly.
- *
- * If the current node is readable, don't modify it. If it's unreadable but has
- * at least one readable descendant, then remove all of its attributes other
- * than \c PCMK_XA_ID. If it's unreadable and has no readable descendants,
- * remove it.
+ * If the current node is readable, copy it with its attributes. If it's
+ * unreadable but has at least one readable descendant, then copy it without
+ * any attributes other than \c PCMK_XA_ID. If it's unreadable and has no
+ * readable descendants, don't copy it. Filter the children of a copied node
+ * the same way, except that a readable subtree with nothing denied below it is
+ * copied all at once.
  *
- * \param[in,out] xml                  XML tree (will be set to \c NULL if
- *                                     freed)
+ * \param[in,out] parent               Where to add the copy (\c NULL to create
+ *                                     a new document with the copy as root)
+ * \param[in]     xml                  XML tree to copy
  * \param[in]     in_readable_context  If \c true, the parent of \p xml is
  *                                     readable
+ * \param[in]     modes                ACL modes of nodes matched by ACLs
+ *
+ * \return Filtered copy of \p xml, or \c NULL if nothing in it is readable
  *
- * \note This function assumes that \c pcmk__apply_acls() has already been
- *       called for \p *xml->doc.
  * \note This function is recursive.
  */
-static void
-filter_unreadable_nodes(xmlNode **xml, bool in_readable_context)
+static xmlNode *
+copy_readable_nodes(xmlNode *parent, xmlNode *xml, bool in_readable_context,
+                    const struct acl_modes *modes)
 {
-    const xml_node_private_t *nodepriv = (*xml)->_private;
+    uint32_t flags = GPOINTER_TO_UINT(g_hash_table_lookup(modes->table, xml));
     bool direct = false;
     const char *how = NULL;
-    const char *name = (const char *) (*xml)->name;
-    const char *id = pcmk__s(pcmk__xe_id(*xml), "(unset)");
-    xmlNode *child = NULL;
+    xmlNode *copy = NULL;
 
     /* If an ACL matched xml directly, update the context for xml and its
      * descendants. Otherwise, keep the access that we inherited.
      */
-    if (is_mode_allowed(nodepriv->flags, pcmk__xf_acl_read)) {
+    if (is_mode_allowed(flags, pcmk__xf_acl_read)) {
         in_readable_context = true;
         direct = true;
 
-    } else if (pcmk__is_set(nodepriv->flags, pcmk__xf_acl_deny)) {
+    } else if (pcmk__is_set(flags, pcmk__xf_acl_deny)) {
         in_readable_context = false;
         direct = true;
     }
@@ -879,7 +1061,7 @@ filter_unreadable_nodes(xmlNode **xml, bool in_readable_context)
     if (direct) {
         how = "directly";
 
-    } else if (*xml == xmlDocGetRootElement((*xml)->doc)) {
+    } else if (parent == NULL) {
         how = "by default";
 
     } else {
@@ -887,36 +1069,137 @@ filter_unreadable_nodes(xmlNode **xml, bool in_readable_context)
     }
 
     pcmk__trace("ACLs %s read access to %s[@" PCMK_XA_ID "='%s'] %s",
-                (in_readable_context? "allow" : "deny"), name, id, how);
-
-    // Filter children recursively
-    child = pcmk__xml_first_child(*xml);
-    while (child != NULL) {
-        xmlNode *next = pcmk__xml_next(child);
+                (in_readable_context? "allow" : "deny"),
+                (const char *) xml->name, pcmk__s(pcmk__xe_id(xml), "(unset)"),
+                how);
+
+    if (in_readable_context
+        && !g_hash_table_contains(modes->denied_below, xml)) {
+        // Everything here is readable
+        return pcmk__xml_copy(parent, xml);
+    }
 
-        filter_unreadable_nodes(&child, in_readable_context);
-        child = next;
+    if (xml->type != XML_ELEMENT_NODE) {
+        return NULL;
     }
 
+    copy = pcmk__xe_create(parent, (const char *) xml->name);
+
     if (in_readable_context) {
-        // This node is readable, either directly or by inheritance
-        return;
-    }
+        pcmk__xe_copy_attrs(copy, xml, pcmk__xaf_none);
 
-    if ((*xml)->children != NULL) {
-        /* At least one descendant is readable, but this node is not.
-         *
-         * Remove all attributes except PCMK_XA_ID. Keep this node as a bare
-         * "scaffolding" element for structure, so that the path from the root
-         * to any readable descendant remains intact. Removing this node would
-         * also remove its readable descendants.
+    } else {
+        /* Keep an unreadable node only as a bare "scaffolding" element, so
+         * that the path from the root to any readable descendant remains
+         * intact
          */
-        pcmk__xe_remove_matching_attrs(*xml, true, attr_is_not_id, NULL);
+        const char *id = pcmk__xe_id(xml);
+
+        if (id != NULL) {
+            pcmk__xe_set(copy, PCMK_XA_ID, id);
+        }
+    }
+
+    for (xmlNode *child = xml->children; child != NULL; child = child->next) {
+        if (child->type == XML_TEXT_NODE) {
+            pcmk__xml_copy(copy, child);
+        } else {
+            copy_readable_nodes(copy, child, in_readable_context, modes);
+        }
+    }
+
+    if (!in_readable_context && (copy->children == NULL)) {
+        // This node and all its descendants are unreadable
+        g_clear_pointer(&copy, pcmk__xml_free);
+    }
+    return copy;
+}
+
+/*!
+ * \internal
+ * \brief Note the ancestors of each element that an ACL denies access to
+ *
+ * \param[in]     key        Element matched by an ACL (<tt>xmlNode *</tt>)
+ * \param[in]     value      ACL modes of \p key
+ * \param[in,out] user_data  ACL modes being built (<tt>struct acl_modes *</tt>)
+ *
+ * \note This is a \c GHFunc.
+ */
+static void
+add_denied_ancestors(gpointer key, gpointer value, gpointer user_data)
+{
+    struct acl_modes *modes = user_data;
+
+    if (!pcmk__is_set(GPOINTER_TO_UINT(value), pcmk__xf_acl_deny)) {
         return;
     }
 
-    // This node and all its descendants are unreadable, so remove it
-    g_clear_pointer(xml, pcmk__xml_free);
+    for (xmlNode *xml = ((xmlNode *) key)->parent;
+         (xml != NULL) && (xml->type == XML_ELEMENT_NODE)
+         && !g_hash_table_contains(modes->denied_below, xml);
+         xml = xml->parent) {
+
+        g_hash_table_add(modes->denied_below, xml);
+    }
+}
+
+/*!
+ * \internal
+ * \brief Copy the readable parts of a document's root element
+ *
+ * \param[in] user        User whose ACLs to use
+ * \param[in] acl_source  XML document whose ACL definitions to use
+ * \param[in] xml         Root element of the document to copy
+ *
+ * \return Newly allocated ACL-filtered copy of \p xml, or \c NULL if the entire
+ *         document is filtered out
+ */
+static xmlNode *
+filtered_copy_of_root(const char *user, xmlDoc *acl_source, xmlNode *xml)
+{
+    GList *acls = user_acls(acl_source, user);
+    struct acl_modes modes = { NULL, NULL, NULL };
+    xmlXPathContext *ctxt = NULL;
+    xmlNode *result = NULL;
+    xml_doc_private_t *docpriv = NULL;
+
+    if (acls == NULL) {
+        pcmk__trace("User '%s' without ACLs denied access to entire XML "
+                    "document", user);
+        return NULL;
+    }
+
+    /* Find what each ACL matches in the original rather than in a full copy,
+     * so that unreadable parts of the tree are never copied
+     */
+    modes.table = g_hash_table_new(NULL, NULL);
+    modes.denied_below = g_hash_table_new(NULL, NULL);
+    ctxt = xmlXPathNewContext(xml->doc);
+    pcmk__mem_assert(ctxt);
+
+    for (const GList *iter = acls; iter != NULL; iter = iter->next) {
+        modes.acl = iter->data;
+        foreach_acl_match(ctxt, modes.acl, record_acl_match, &modes);
+    }
+    xmlXPathFreeContext(ctxt);
+    g_hash_table_foreach(modes.table, add_denied_ancestors, &modes);
+
+    pcmk__trace("Filtering XML copy using user '%s' ACLs", user);
+    result = copy_readable_nodes(NULL, xml, false, &modes);
+
+    g_hash_table_destroy(modes.table);
+    g_hash_table_destroy(modes.denied_below);
+    pcmk__free_acls(acls);
+
+    if (result == NULL) {
+        pcmk__trace("ACLs deny user '%s' access to entire XML document", user);
+        return NULL;
+    }
+
+    docpriv = result->doc->_private;
+    pcmk__str_update(&docpriv->acl_user, user);
+    pcmk__xml_doc_set_flags(result->doc, pcmk__xf_acl_enabled);
+    return result;
 }
 
 /*!
@@ -951,39 +1234,26 @@ filter_unreadable_nodes(xmlNode **xml, bool in_readable_context)
 xmlNode *
 pcmk__acl_filtered_copy(const char *user, xmlDoc *acl_source, xmlNode *xml)
 {
+    xmlNode *root_copy = NULL;
     xmlNode *result = NULL;
-    xml_doc_private_t *docpriv = NULL;
 
     pcmk__assert((acl_source != NULL) && (xml != NULL));
 
-    result = pcmk__xml_copy(NULL, xml);
-
     if (!pcmk__acl_required(user)) {
         // Return an unfiltered copy
-        return result;
-    }
-
-    pcmk__enable_acls(acl_source->doc, result->doc, user);
-
-    docpriv = result->doc->_private;
-    if (docpriv->acls == NULL) {
-        pcmk__trace("User '%s' without ACLs denied access to entire XML "
-                    "document", user);
-        pcmk__xml_free(result);
-        return NULL;
+        return pcmk__xml_copy(NULL, xml);
     }
 
-    pcmk__trace("Filtering XML copy using user '%s' ACLs", user);
-    filter_unreadable_nodes(&result, false);
-
-    // coverity[check_after_deref : FALSE] Doesn't understand g_clear_pointer
-    if (result == NULL) {
-        // Entire document was freed, so don't free docpriv->acls here
-        pcmk__trace("ACLs deny user '%s' access to entire XML document", user);
-        return NULL;
+    if (xml == xmlDocGetRootElement(xml->doc)) {
+        return filtered_copy_of_root(user, acl_source, xml);
     }
 
-    g_clear_pointer(&docpriv->acls, pcmk__free_acls);
+    /* ACL XPath expressions are evaluated with the copy as the document root,
+     * so match them against a standalone copy of a non-root element
+     */
+    root_copy = pcmk__xml_copy(NULL, xml);
+    result = filtered_copy_of_root(user, acl_source, root_copy);
+    pcmk__xml_free(root_copy);
     return result;
 }
 
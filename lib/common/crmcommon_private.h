@@ -155,6 +155,9 @@ void pcmk__xc_update(xmlNode *parent, xmlNode *target, xmlNode *update);
 G_GNUC_INTERNAL
 void pcmk__free_acls(GList *acls);
 
+G_GNUC_INTERNAL
+void pcmk__acl_cleanup(void);
+
 G_GNUC_INTERNAL
 bool pcmk__is_user_in_group(const char *user, const char *group);
 
@@ -183,6 +186,14 @@ void pcmk__mark_xml_node_dirty(xmlNode *xml);
 G_GNUC_INTERNAL
 bool pcmk__dump_xml_attr(const xmlAttr *attr, void *user_data);
 
+//! Callback for consuming serialized XML text as it is produced
+typedef void (*pcmk__xml_flush_fn)(GString *buffer, void *user_data);
+
+G_GNUC_INTERNAL
+void pcmk__xml_string_chunked(const xmlNode *data, uint32_t options,
+                              GString *buffer, pcmk__xml_flush_fn flush,
+                              void *user_data);
+
 G_GNUC_INTERNAL
 int pcmk__xe_set_score(xmlNode *target, const char *name, const char *value);
 
@@ -487,6 +498,13 @@ typedef struct {
     GList *transforms;
 
     void *cache;
+
+    /*!
+     * Digest of the last CIB found valid against this schema, excluding the
+     * parts that cannot affect validity (see \c validation_digest())
+     */
+    char *valid_digest;
+
     enum pcmk__schema_validator validator;
     pcmk__schema_version_t version;
 } pcmk__schema_t;
@@ -46,25 +46,104 @@
  * that nodes be unfenced again after a device's configuration changes.
  */
 
+// Serialized XML is hashed in chunks of (roughly) this many bytes
+#define DIGEST_CHUNK_SIZE 16384
+
+// State for hashing serialized XML without building the full text
+struct digest_stream {
+    GChecksum *checksum;    // Running MD5 checksum
+    GString *buffer;        // Text serialized but not yet hashed
+    size_t total;           // Number of bytes hashed so far
+};
+
+/*!
+ * \internal
+ * \brief Hash any buffered text once enough has accumulated
+ *
+ * \param[in,out] stream  Digest stream
+ * \param[in]     force   If \c true, hash buffered text regardless of size
+ */
+static void
+flush_digest_stream(struct digest_stream *stream, bool force)
+{
+    GString *buffer = stream->buffer;
+
+    if ((buffer->len == 0)
+        || (!force && (buffer->len < DIGEST_CHUNK_SIZE))) {
+        return;
+    }
+
+    g_checksum_update(stream->checksum, (const guchar *) buffer->str,
+                      buffer->len);
+    stream->total += buffer->len;
+    g_string_truncate(buffer, 0);
+}
+
+/*!
+ * \internal
+ * \brief Hash serialized XML once enough has accumulated
+ *
+ * \param[in,out] buffer     Serialized XML not yet hashed
+ * \param[in,out] user_data  Digest stream (<tt>struct digest_stream *</tt>)
+ *
+ * \note This is compatible with \c pcmk__xml_flush_fn.
+ */
+static void
+flush_xml_for_digest(GString *buffer, void *user_data)
+{
+    struct digest_stream *stream = user_data;
+
+    pcmk__assert(buffer == stream->buffer);
+    flush_digest_stream(stream, false);
+}
+
 /*!
  * \internal
- * \brief Dump XML in a format used with v1 digests
+ * \brief Calculate the MD5 checksum of serialized XML
  *
- * \param[in] xml  Root of XML to dump
+ * \param[in]  xml      XML to digest
+ * \param[in]  options  Group of \c pcmk__xml_fmt_options flags (other than
+ *                      \c pcmk__xml_fmt_pretty)
+ * \param[in]  v1       If \c true, hash the text with a prefixed space and a
+ *                      suffixed newline, as used by v1 digests
+ * \param[out] length   Where to store the number of bytes hashed
+ *
+ * \return Newly allocated string containing digest
  *
- * \return Newly allocated buffer containing dumped XML
+ * \note The result is the same as \c pcmk__md5sum() of the text that
+ *       \c pcmk__xml_string() would produce, but the text is hashed in
+ *       chunks rather than all at once.
  */
-static GString *
-dump_xml_for_digest(const xmlNode *xml)
+static char *
+md5sum_xml(const xmlNode *xml, uint32_t options, bool v1, size_t *length)
 {
-    GString *buffer = g_string_sized_new(1024);
+    struct digest_stream stream = {
+        .checksum = g_checksum_new(G_CHECKSUM_MD5),
+        .buffer = g_string_sized_new(DIGEST_CHUNK_SIZE + 1024),
+        .total = 0,
+    };
+    char *digest = NULL;
 
-    /* for compatibility with the old result which is used for v1 digests */
-    g_string_append_c(buffer, ' ');
-    pcmk__xml_string(xml, 0, buffer, 0);
-    g_string_append_c(buffer, '\n');
+    pcmk__assert(stream.checksum != NULL);
 
-    return buffer;
+    if (v1) {
+        // For compatibility with the old result which is used for v1 digests
+        g_string_append_c(stream.buffer, ' ');
+    }
+    pcmk__xml_string_chunked(xml, options, stream.buffer, flush_xml_for_digest,
+                             &stream);
+    if (v1) {
+        g_string_append_c(stream.buffer, '\n');
+    }
+    flush_digest_stream(&stream, true);
+
+    // Make a copy just so that callers can use free() instead of g_free()
+    digest = pcmk__str_copy(g_checksum_get_string(stream.checksum));
+    *length = stream.total;
+
+    g_checksum_free(stream.checksum);
+    g_string_free(stream.buffer, TRUE);
+    return digest;
 }
 
 /*!
@@ -121,17 +200,14 @@ pcmk__md5sum(const char *input)
 static char *
 calculate_xml_digest_v1(const xmlNode *input)
 {
-    GString *buffer = dump_xml_for_digest(input);
-    char *digest = NULL;
+    size_t length = 0;
+    char *digest = md5sum_xml(input, 0, true, &length);
 
-    // buffer->len > 2 for initial space and trailing newline
-    CRM_CHECK(buffer->len > 2,
-              g_string_free(buffer, TRUE);
+    // length > 2 for initial space and trailing newline
+    CRM_CHECK(length > 2,
+              free(digest);
               return NULL);
 
-    digest = pcmk__md5sum(buffer->str);
-
-    g_string_free(buffer, TRUE);
     return digest;
 }
 
@@ -208,14 +284,9 @@ pcmk__digest_xml(const xmlNode *xml, bool filter)
     /* @TODO Filtering accounts for significant CPU usage. Consider removing if
      * possible.
      */
-    char *digest = NULL;
-    GString *buf = g_string_sized_new(1024);
-
-    pcmk__xml_string(xml, (filter? pcmk__xml_fmt_filtered : 0), buf, 0);
-    digest = pcmk__md5sum(buf->str);
-    if (digest == NULL) {
-        goto done;
-    }
+    size_t length = 0;
+    char *digest = md5sum_xml(xml, (filter? pcmk__xml_fmt_filtered : 0),
+                              false, &length);
 
     pcmk__if_tracing(
         {
@@ -231,8 +302,6 @@ pcmk__digest_xml(const xmlNode *xml, bool filter)
         {}
     );
 
-done:
-    g_string_free(buf, TRUE);
     return digest;
 }
 
@@ -97,6 +97,128 @@ pcmk__real_path(const char *path, char **resolved_path)
 #endif
 }
 
+/*!
+ * \internal
+ * \brief Detect the compression format of data from its leading bytes
+ *
+ * \param[in] data    Data to check
+ * \param[in] length  Number of bytes available at \p data
+ *
+ * \return Compression format of \p data (\c pcmk__compression_none if it is
+ *         not in a recognized compressed format)
+ */
+enum pcmk__compression
+pcmk__compression_detect(const void *data, size_t length)
+{
+    // bzip2 streams start with "BZh" followed by the block size ('1' to '9')
+    static const unsigned char bzip2_magic[] = { 'B', 'Z', 'h' };
+
+    // zstd frames start with the little-endian magic number 0xFD2FB528
+    static const unsigned char zstd_magic[] = { 0x28, 0xB5, 0x2F, 0xFD };
+
+    const unsigned char *bytes = data;
+
+    if (bytes == NULL) {
+        return pcmk__compression_none;
+    }
+    if ((length > sizeof(bzip2_magic))
+        && (memcmp(bytes, bzip2_magic, sizeof(bzip2_magic)) == 0)
+        && (bytes[3] >= '1') && (bytes[3] <= '9')) {
+        return pcmk__compression_bzip2;
+    }
+    if ((length >= sizeof(zstd_magic))
+        && (memcmp(bytes, zstd_magic, sizeof(zstd_magic)) == 0)) {
+        return pcmk__compression_zstd;
+    }
+    return pcmk__compression_none;
+}
+
+/*!
+ * \internal
+ * \brief Get the compression format implied by a file name's extension
+ *
+ * \param[in] filename  File name to check
+ *
+ * \return Compression format implied by \p filename (\c pcmk__compression_none
+ *         if the extension does not indicate compression)
+ */
+enum pcmk__compression
+pcmk__compression_from_filename(const char *filename)
+{
+    if (filename == NULL) {
+        return pcmk__compression_none;
+    }
+    if (g_str_has_suffix(filename, ".bz2")) {
+        return pcmk__compression_bzip2;
+    }
+    if (g_str_has_suffix(filename, ".zst")) {
+        return pcmk__compression_zstd;
+    }
+    return pcmk__compression_none;
+}
+
+/*!
+ * \internal
+ * \brief Get the compression format to use when writing compressed files
+ *
+ * This is \c bzip2 unless the \c PCMK_compression environment variable
+ * selects another supported format.
+ *
+ * \return Compression format to use for newly written compressed files
+ */
+enum pcmk__compression
+pcmk__compression_configured(void)
+{
+    static bool warned = false;
+    const char *value = pcmk__env_option(PCMK__ENV_COMPRESSION);
+
+    if ((value == NULL) || pcmk__str_eq(value, "bzip2", pcmk__str_casei)) {
+        return pcmk__compression_bzip2;
+    }
+
+    if (pcmk__str_eq(value, "zstd", pcmk__str_casei)) {
+#if HAVE_ZSTD
+        return pcmk__compression_zstd;
+#else
+        if (!warned) {
+            pcmk__warn("Using bzip2 instead of PCMK_" PCMK__ENV_COMPRESSION
+                       " value '%s' because this build does not support it",
+                       value);
+            warned = true;
+        }
+        return pcmk__compression_bzip2;
+#endif
+    }
+
+    if (!warned) {
+        pcmk__warn("Using bzip2 instead of invalid PCMK_"
+                   PCMK__ENV_COMPRESSION " value '%s'", value);
+        warned = true;
+    }
+    return pcmk__compression_bzip2;
+}
+
+/*!
+ * \internal
+ * \brief Get the file name extension (without dot) for a compression format
+ *
+ * \param[in] codec  Compression format
+ *
+ * \return File name extension for \p codec (\c "raw" if not compressed)
+ */
+const char *
+pcmk__compression_extension(enum pcmk__compression codec)
+{
+    switch (codec) {
+        case pcmk__compression_bzip2:
+            return "bz2";
+        case pcmk__compression_zstd:
+            return "zst";
+        default:
+            return "raw";
+    }
+}
+
 /*!
  * \internal
  * \brief Create a file name using a sequence number
@@ -104,18 +226,66 @@ pcmk__real_path(const char *path, char **resolved_path)
  * \param[in] directory  Directory that contains the file series
  * \param[in] series     Start of file name
  * \param[in] sequence   Sequence number
- * \param[in] bzip       Whether to use ".bz2" instead of ".raw" as extension
+ * \param[in] compress   If \c true, use the extension of the configured
+ *                       compression format instead of ".raw"
  *
  * \return Newly allocated file path (asserts on error, so always non-NULL)
  * \note The caller is responsible for freeing the return value.
  */
 char *
 pcmk__series_filename(const char *directory, const char *series,
-                      unsigned int sequence, bool bzip)
+                      unsigned int sequence, bool compress)
 {
+    enum pcmk__compression codec = pcmk__compression_none;
+
     pcmk__assert((directory != NULL) && (series != NULL));
+
+    if (compress) {
+        codec = pcmk__compression_configured();
+    }
     return pcmk__assert_asprintf("%s/%s-%u.%s", directory, series, sequence,
-                                 (bzip? "bz2" : "raw"));
+                                 pcmk__compression_extension(codec));
+}
+
+/*!
+ * \internal
+ * \brief Remove a file series' file for a given sequence number
+ *
+ * The file may have been written with any compression format (for example,
+ * before \c PCMK_compression was changed), so this removes the file with each
+ * possible extension. Otherwise, files with the old extension would never be
+ * replaced once the series wraps around.
+ *
+ * \param[in] directory  Directory that contains the file series
+ * \param[in] series     Start of file name
+ * \param[in] sequence   Sequence number
+ */
+void
+pcmk__remove_series_file(const char *directory, const char *series,
+                         unsigned int sequence)
+{
+    static const enum pcmk__compression codecs[] = {
+        pcmk__compression_none,
+        pcmk__compression_bzip2,
+        pcmk__compression_zstd,
+    };
+
+    pcmk__assert((directory != NULL) && (series != NULL));
+
+    for (int i = 0; i < PCMK__NELEM(codecs); i++) {
+        char *filename = pcmk__assert_asprintf("%s/%s-%u.%s", directory, series,
+                                               sequence,
+                                               pcmk__compression_extension(
+                                                   codecs[i]));
+
+        if (unlink(filename) == 0) {
+            pcmk__trace("Removed %s", filename);
+
+        } else if (errno != ENOENT) {
+            pcmk__warn("Could not remove %s: %s", filename, strerror(errno));
+        }
+        free(filename);
+    }
 }
 
 /*!
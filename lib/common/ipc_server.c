@@ -302,19 +302,58 @@ pcmk_free_ipc_event(struct iovec *event)
     free(event);
 }
 
+/* A server event waiting to be sent. The same event may be queued for several
+ * clients at once (see pcmk__ipc_send_shared_event()), so its I/O vector is
+ * freed only when the last reference to it is released.
+ */
+struct pcmk__ipc_event_s {
+    struct iovec *iov;      // Header and payload
+    unsigned int refs;      // Number of holders (client queues and creator)
+};
+
+static pcmk__ipc_event_t *
+new_event(struct iovec *iov)
+{
+    pcmk__ipc_event_t *event = pcmk__assert_alloc(1, sizeof(pcmk__ipc_event_t));
+
+    event->iov = iov;
+    event->refs = 1;
+    return event;
+}
+
+/*!
+ * \internal
+ * \brief Release a reference to a server event, freeing it if it was the last
+ *
+ * \param[in,out] event  Event to release
+ */
+void
+pcmk__ipc_unref_event(pcmk__ipc_event_t *event)
+{
+    if (event == NULL) {
+        return;
+    }
+
+    pcmk__assert(event->refs > 0);
+    if (--(event->refs) == 0) {
+        pcmk_free_ipc_event(event->iov);
+        free(event);
+    }
+}
+
 static void
 free_event(void *data)
 {
-    pcmk_free_ipc_event(data);
+    pcmk__ipc_unref_event(data);
 }
 
 static void
-add_event(pcmk__client_t *c, struct iovec *iov)
+add_event(pcmk__client_t *c, pcmk__ipc_event_t *event)
 {
     if (c->event_queue == NULL) {
         c->event_queue = g_queue_new();
     }
-    g_queue_push_tail(c->event_queue, iov);
+    g_queue_push_tail(c->event_queue, event);
 }
 
 void
@@ -533,7 +572,7 @@ crm_ipcs_flush_events(pcmk__client_t *c)
 
     while (sent < 100) {
         pcmk__ipc_header_t *header = NULL;
-        struct iovec *event = NULL;
+        pcmk__ipc_event_t *event = NULL;
 
         if ((c->event_queue == NULL) || g_queue_is_empty(c->event_queue)) {
             break;
@@ -553,7 +592,7 @@ crm_ipcs_flush_events(pcmk__client_t *c)
          * replies, which will cause wider failures.
          */
         for (unsigned int retries = 5; retries > 0; retries--) {
-            qb_rc = qb_ipcs_event_sendv(c->ipcs, event, 2);
+            qb_rc = qb_ipcs_event_sendv(c->ipcs, event->iov, 2);
 
             if (qb_rc >= 0) {
                 break;
@@ -570,12 +609,12 @@ crm_ipcs_flush_events(pcmk__client_t *c)
         event = g_queue_pop_head(c->event_queue);
 
         sent++;
-        header = event[0].iov_base;
+        header = event->iov[0].iov_base;
 
         pcmk__trace("Event %" PRId32 " to %p[%u] (%zd bytes) sent: %.120s",
                     header->qb.id, c->ipcs, c->pid, qb_rc,
-                    (char *) (event[1].iov_base));
-        pcmk_free_ipc_event(event);
+                    (char *) (event->iov[1].iov_base));
+        pcmk__ipc_unref_event(event);
     }
 
 no_more_retries:
@@ -803,7 +842,7 @@ pcmk__ipc_send_iov(pcmk__client_t *c, struct iovec *iov, uint32_t flags)
 
         if (pcmk__is_set(flags, crm_ipc_server_free)) {
             pcmk__trace("Sending the original to %p[%d]", c->ipcs, c->pid);
-            add_event(c, iov);
+            add_event(c, new_event(iov));
 
         } else {
             struct iovec *iov_copy = pcmk__new_ipc_event();
@@ -817,7 +856,7 @@ pcmk__ipc_send_iov(pcmk__client_t *c, struct iovec *iov, uint32_t flags)
             iov_copy[1].iov_base = pcmk__assert_alloc(1, iov[1].iov_len);
             memcpy(iov_copy[1].iov_base, iov[1].iov_base, iov[1].iov_len);
 
-            add_event(c, iov_copy);
+            add_event(c, new_event(iov_copy));
         }
 
         rc = crm_ipcs_flush_events(c);
@@ -871,23 +910,81 @@ pcmk__ipc_send_iov(pcmk__client_t *c, struct iovec *iov, uint32_t flags)
     return rc;
 }
 
+/*!
+ * \internal
+ * \brief Create a server event that can be sent to many clients without copying
+ *
+ * \param[in,out] iov  I/O vector created by pcmk__ipc_prepare_iov() (the
+ *                     result takes ownership of this)
+ *
+ * \return Newly allocated event
+ * \note The caller holds one reference to the result, which it must release
+ *       with pcmk__ipc_unref_event() after sending it to all desired clients.
+ *       The event will be freed once all clients have been sent it.
+ */
+pcmk__ipc_event_t *
+pcmk__ipc_new_shared_event(struct iovec *iov)
+{
+    pcmk__ipc_header_t *header = NULL;
+
+    pcmk__assert(iov != NULL);
+
+    /* Every recipient would get the same header flags and ID from
+     * pcmk__ipc_send_iov() anyway, so set them once here
+     */
+    header = iov[0].iov_base;
+    pcmk__set_ipc_flags(header->flags, "server event", crm_ipc_server_event);
+    if (header->qb.id == 0) {
+        header->qb.id = id_for_server_event(header);
+    }
+    return new_event(iov);
+}
+
+/*!
+ * \internal
+ * \brief Queue a shared server event for a client and try to send it
+ *
+ * \param[in,out] c      Client to send event to
+ * \param[in,out] event  Event created by pcmk__ipc_new_shared_event()
+ *
+ * \return Standard Pacemaker return code (\c EAGAIN is not an error here,
+ *         because the event will be retried when the queue is next flushed)
+ */
+int
+pcmk__ipc_send_shared_event(pcmk__client_t *c, pcmk__ipc_event_t *event)
+{
+    pcmk__assert((c != NULL) && (event != NULL));
+
+    pcmk__trace("Sending a shared event to %p[%d]", c->ipcs, c->pid);
+    event->refs++;
+    add_event(c, event);
+    return crm_ipcs_flush_events(c);
+}
+
+/*!
+ * \internal
+ * \brief Send an already serialized message to an IPC client
+ *
+ * \param[in,out] c        Client to send message to
+ * \param[in]     request  Request ID that message is a reply to (if any)
+ * \param[in]     message  Serialized XML to send
+ * \param[in]     flags    Group of <tt>enum crm_ipc_flags</tt>
+ *
+ * \return Standard Pacemaker return code
+ */
 int
-pcmk__ipc_send_xml(pcmk__client_t *c, uint32_t request, const xmlNode *message,
-                   uint32_t flags)
+pcmk__ipc_send_string(pcmk__client_t *c, uint32_t request,
+                      const GString *message, uint32_t flags)
 {
     struct iovec *iov = NULL;
     int rc = pcmk_rc_ok;
-    GString *iov_buffer = NULL;
     uint16_t index = 0;
     bool event_or_proxied = false;
 
-    if (c == NULL) {
+    if ((c == NULL) || (message == NULL)) {
         return EINVAL;
     }
 
-    iov_buffer = g_string_sized_new(1024);
-    pcmk__xml_string(message, 0, iov_buffer, 0);
-
     /* Testing crm_ipc_server_event is obvious.  pcmk__client_proxied is less
      * obvious.  According to pcmk__ipc_send_iov, replies to proxied connections
      * need to be sent as events.  However, do_local_notify (which calls this
@@ -901,7 +998,7 @@ pcmk__ipc_send_xml(pcmk__client_t *c, uint32_t request, const xmlNode *message,
                        || pcmk__is_set(c->flags, pcmk__client_proxied);
 
     do {
-        rc = pcmk__ipc_prepare_iov(request, iov_buffer, index, &iov, NULL);
+        rc = pcmk__ipc_prepare_iov(request, message, index, &iov, NULL);
 
         switch (rc) {
             case pcmk_rc_ok:
@@ -981,6 +1078,24 @@ done:
         pcmk__notice("IPC message to pid %u failed: %s " QB_XS " rc=%d", c->pid,
                      pcmk_rc_str(rc), rc);
     }
+    return rc;
+}
+
+int
+pcmk__ipc_send_xml(pcmk__client_t *c, uint32_t request, const xmlNode *message,
+                   uint32_t flags)
+{
+    int rc = pcmk_rc_ok;
+    GString *iov_buffer = NULL;
+
+    if (c == NULL) {
+        return EINVAL;
+    }
+
+    iov_buffer = g_string_sized_new(1024);
+    pcmk__xml_string(message, 0, iov_buffer, 0);
+
+    rc = pcmk__ipc_send_string(c, request, iov_buffer, flags);
 
     g_string_free(iov_buffer, TRUE);
     return rc;
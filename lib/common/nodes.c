@@ -63,15 +63,8 @@ pcmk__free_node(void *user_data)
 void
 pcmk__free_node_copy(void *data)
 {
-    if (data != NULL) {
-        pcmk_node_t *node = data;
-
-        if (node->assign != NULL) {
-            // This is the only member allocated separately for a node copy
-            free(node->assign);
-        }
-        free(node);
-    }
+    // The node's assignment data is part of the same allocation
+    free(data);
 }
 
 /*!
@@ -687,21 +687,83 @@ first_matching_xml_child(const xmlNode *parent, const char *name,
     return NULL;
 }
 
+/*!
+ * \internal
+ * \brief Find the longest already-resolved prefix of a v2 patchset xpath
+ *
+ * \param[in]     key        Search xpath
+ * \param[in]     whole_key  Whether \p key itself may be looked up
+ * \param[in]     cache      Resolved prefixes (xpath prefix -> XML)
+ * \param[in,out] target     Where to store XML matching the prefix, if found
+ *
+ * \return Length of the longest prefix of \p key found in \p cache (or 0 if
+ *         none was found)
+ */
+static size_t
+find_cached_prefix(const char *key, bool whole_key, GHashTable *cache,
+                   xmlNode **target)
+{
+    size_t len = strlen(key);
+    char *prefix = NULL;
+
+    if (g_hash_table_size(cache) == 0) {
+        return 0;
+    }
+
+    prefix = pcmk__str_copy(key);
+
+    if (!whole_key) {
+        len = 0;
+        for (size_t i = strlen(key); i > 0; i--) {
+            if (key[i] == '/') {
+                len = i;
+                break;
+            }
+        }
+    }
+
+    // Try each prefix that ends just before a slash, longest first
+    while (len > 0) {
+        prefix[len] = '\0';
+
+        *target = g_hash_table_lookup(cache, prefix);
+        if (*target != NULL) {
+            break;
+        }
+
+        do {
+            len--;
+        } while ((len > 0) && (key[len] != '/'));
+    }
+
+    free(prefix);
+    return len;
+}
+
 /*!
  * \internal
  * \brief Simplified, more efficient alternative to pcmk__xpath_find_one()
  *
- * \param[in] top              Root of XML to search
- * \param[in] key              Search xpath
- * \param[in] target_position  If deleting, where to delete
+ * \param[in]     top              Root of XML to search
+ * \param[in]     key              Search xpath
+ * \param[in]     target_position  If deleting, where to delete
+ * \param[in,out] cache            If not \c NULL, table mapping xpath
+ *                                 prefixes already resolved against \p top to
+ *                                 their matches (new ones will be added)
  *
  * \return XML child matching xpath if found, NULL otherwise
  *
  * \note This only works on simplified xpaths found in v2 patchset diffs,
  *       i.e. the only allowed search predicate is [@id='XXX'].
+ * \note A patchset that touches many entries below the same element (for
+ *       example, resource history on one node) repeats the same path prefix
+ *       in every change. With \p cache, each prefix is walked only once, so
+ *       siblings (such as every \c PCMK__XE_NODE_STATE) aren't rescanned for
+ *       every change.
  */
 static xmlNode *
-search_v2_xpath(const xmlNode *top, const char *key, int target_position)
+search_v2_xpath(const xmlNode *top, const char *key, int target_position,
+                GHashTable *cache)
 {
     xmlNode *target = (xmlNode *) top->doc;
     const char *current = key;
@@ -715,6 +777,21 @@ search_v2_xpath(const xmlNode *top, const char *key, int target_position)
     CRM_CHECK(key != NULL, return NULL);
     key_len = strlen(key);
 
+    if (cache != NULL) {
+        xmlNode *cached = NULL;
+        size_t len = find_cached_prefix(key, (target_position < 0), cache,
+                                        &cached);
+
+        if (len > 0) {
+            target = cached;
+            current = key + len;
+            if (*current == '\0') {
+                pcmk__trace("Found cached match for %s", key);
+                return target;
+            }
+        }
+    }
+
     /* These are scanned from key after a slash, so they can't be bigger
      * than key_len - 1 characters plus a null terminator.
      */
@@ -753,7 +830,15 @@ search_v2_xpath(const xmlNode *top, const char *key, int target_position)
                     target = NULL;
                     break;
             }
-            current = remainder;
+
+            // Remember the match for this prefix (unless position-dependent)
+            current += strlen(section) + 1;
+            if ((cache != NULL) && (target != NULL)
+                && (current_position < 0)) {
+
+                g_hash_table_insert(cache,
+                                    g_strndup(key, current - key), target);
+            }
         }
 
     // Continue if something remains to search, and we've matched so far
@@ -823,6 +908,10 @@ apply_v2_patchset(xmlNode *xml, const xmlNode *patchset)
     GList *change_objs = NULL;
     GList *gIter = NULL;
 
+    // Matches for path prefixes already resolved while applying the patchset
+    GHashTable *prefixes = g_hash_table_new_full(g_str_hash, g_str_equal,
+                                                 g_free, NULL);
+
     for (change = pcmk__xml_first_child(patchset); change != NULL;
          change = pcmk__xml_next(change)) {
         xmlNode *match = NULL;
@@ -842,7 +931,7 @@ apply_v2_patchset(xmlNode *xml, const xmlNode *patchset)
         if (strcmp(op, PCMK_VALUE_DELETE) == 0) {
             pcmk__xe_get_int(change, PCMK_XE_POSITION, &position);
         }
-        match = search_v2_xpath(xml, xpath, position);
+        match = search_v2_xpath(xml, xpath, position, prefixes);
         pcmk__trace("Performing %s on %s with %p", op, xpath, match);
 
         if ((match == NULL) && (strcmp(op, PCMK_VALUE_DELETE) == 0)) {
@@ -873,6 +962,8 @@ apply_v2_patchset(xmlNode *xml, const xmlNode *patchset)
             }
 
         } else if (strcmp(op, PCMK_VALUE_DELETE) == 0) {
+            // Cached matches may be match or its descendants
+            g_hash_table_remove_all(prefixes);
             pcmk__xml_free(match);
 
         } else if (strcmp(op, PCMK_VALUE_MODIFY) == 0) {
@@ -886,6 +977,12 @@ apply_v2_patchset(xmlNode *xml, const xmlNode *patchset)
                 continue;
             }
 
+            if (!pcmk__str_eq(pcmk__xe_id(match), pcmk__xe_id(attrs),
+                              pcmk__str_none)) {
+                // Cached paths to match and its descendants use the old ID
+                g_hash_table_remove_all(prefixes);
+            }
+
             /* Remove all existing attributes and then set the ones from attrs.
              * We remove all attributes, even the ones that will be reset or
              * unchanged, because for some reason we care about whether their
@@ -903,6 +1000,8 @@ apply_v2_patchset(xmlNode *xml, const xmlNode *patchset)
         }
     }
 
+    g_hash_table_destroy(prefixes);
+
     // Changes should be generated in the right order. Double checking.
     change_objs = g_list_sort(change_objs, sort_change_obj_by_position);
 
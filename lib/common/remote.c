@@ -28,7 +28,6 @@
 #include <time.h>                   // time
 #include <unistd.h>                 // close, read, write
 
-#include <bzlib.h>                  // BZ2_bzBuffToBuffDecompress
 #include <glib.h>                   // GUINT32_SWAP_LE_BE, g_string_*
 #include <gnutls/gnutls.h>          // gnutls_strerror, GNUTLS_E_AGAIN
 #include <libxml/tree.h>            // xmlNode
@@ -270,34 +269,69 @@ remote_send_iovs(pcmk__remote_t *remote, struct iovec *iov, int iovs)
     return rc;
 }
 
+// An XML message encoded (and possibly compressed) for sending
+struct pcmk__remote_msg_s {
+    struct iovec iov[2];    // Header and payload
+    bool compressed;        // Whether payload was allocated by pcmk__compress()
+};
+
 /*!
  * \internal
- * \brief Send an XML message over a Pacemaker Remote connection
+ * \brief Free an encoded Pacemaker Remote message
  *
- * \param[in,out] remote  Pacemaker Remote connection to use
- * \param[in]     msg     XML to send
+ * \param[in,out] prepared  Message created by pcmk__remote_prepare_xml()
+ */
+void
+pcmk__remote_free_prepared(pcmk__remote_msg_t *prepared)
+{
+    if (prepared == NULL) {
+        return;
+    }
+
+    free(prepared->iov[0].iov_base);
+
+    if (prepared->compressed) {
+        free(prepared->iov[1].iov_base);
+    } else {
+        g_free(prepared->iov[1].iov_base);
+    }
+    free(prepared);
+}
+
+/*!
+ * \internal
+ * \brief Encode an XML message for sending over Pacemaker Remote connections
+ *
+ * The message is serialized (and compressed, if large) only once, so it can be
+ * sent to any number of connections with pcmk__remote_send_prepared().
+ *
+ * \param[in]  msg       XML to encode
+ * \param[out] prepared  Where to store encoded message
  *
  * \return Standard Pacemaker return code
+ * \note On success, the caller is responsible for freeing \p *prepared with
+ *       pcmk__remote_free_prepared().
  */
 int
-pcmk__remote_send_xml(pcmk__remote_t *remote, const xmlNode *msg)
+pcmk__remote_prepare_xml(const xmlNode *msg, pcmk__remote_msg_t **prepared)
 {
-    int rc = pcmk_rc_ok;
-    static uint64_t id = 0;
+    pcmk__remote_msg_t *result = NULL;
+    struct iovec *iov = NULL;
     GString *xml_text = NULL;
-
-    struct iovec iov[2];
     struct remote_header_v0 *header;
-    bool did_compress = false;
     size_t payload_len = 0;
 
-    CRM_CHECK((remote != NULL) && (msg != NULL), return EINVAL);
+    CRM_CHECK((msg != NULL) && (prepared != NULL), return EINVAL);
+    *prepared = NULL;
 
     xml_text = g_string_sized_new(1024);
     pcmk__xml_string(msg, 0, xml_text, 0);
     CRM_CHECK(xml_text->len > 0,
               g_string_free(xml_text, TRUE); return EINVAL);
 
+    result = pcmk__assert_alloc(1, sizeof(pcmk__remote_msg_t));
+    iov = result->iov;
+
     header = pcmk__assert_alloc(1, sizeof(struct remote_header_v0));
 
     iov[0].iov_base = header;
@@ -305,8 +339,6 @@ pcmk__remote_send_xml(pcmk__remote_t *remote, const xmlNode *msg)
     iov[1].iov_base = NULL;
     iov[1].iov_len = 0;
 
-    id++;
-    header->id = id;
     header->endian = ENDIAN_LOCAL;
     header->version = REMOTE_MSG_VERSION;
     header->payload_offset = iov[0].iov_len;
@@ -322,7 +354,9 @@ pcmk__remote_send_xml(pcmk__remote_t *remote, const xmlNode *msg)
     if ((payload_len < xml_text->len) || (UINT32_MAX - iov[0].iov_len) < payload_len) {
         pcmk__err("Remote message size %zu + %zu exceeds maximum of %" PRIu32,
                   iov[0].iov_len, payload_len, UINT32_MAX);
-        goto done;
+        g_string_free(xml_text, TRUE);
+        pcmk__remote_free_prepared(result);
+        return EMSGSIZE;
     }
 
     if (payload_len >= PCMK__BZ2_THRESHOLD) {
@@ -344,11 +378,10 @@ pcmk__remote_send_xml(pcmk__remote_t *remote, const xmlNode *msg)
 #endif
                 pcmk__err("Compressed message size %zu exceeds maximum of %" PRIu32,
                           new_size, UINT32_MAX);
-                rc = EMSGSIZE;
-
                 g_string_free(xml_text, TRUE);
                 free(compressed);
-                goto done;
+                pcmk__remote_free_prepared(result);
+                return EMSGSIZE;
             }
 
             iov[1].iov_len = new_size;
@@ -358,11 +391,11 @@ pcmk__remote_send_xml(pcmk__remote_t *remote, const xmlNode *msg)
             header->payload_uncompressed = payload_len;
             g_string_free(xml_text, TRUE);
 
-            did_compress = true;
+            result->compressed = true;
         }
     }
 
-    if (!did_compress) {
+    if (!result->compressed) {
         iov[1].iov_len = payload_len;
         iov[1].iov_base = g_string_free(xml_text, FALSE);
 
@@ -371,21 +404,63 @@ pcmk__remote_send_xml(pcmk__remote_t *remote, const xmlNode *msg)
 
     header->size_total = iov[0].iov_len + iov[1].iov_len;
 
-    rc = remote_send_iovs(remote, iov, 2);
+    *prepared = result;
+    return pcmk_rc_ok;
+}
+
+/*!
+ * \internal
+ * \brief Send an encoded message over a Pacemaker Remote connection
+ *
+ * \param[in,out] remote    Pacemaker Remote connection to use
+ * \param[in,out] prepared  Message created by pcmk__remote_prepare_xml()
+ *
+ * \return Standard Pacemaker return code
+ */
+int
+pcmk__remote_send_prepared(pcmk__remote_t *remote,
+                           pcmk__remote_msg_t *prepared)
+{
+    static uint64_t id = 0;
+    struct remote_header_v0 *header = NULL;
+    int rc = pcmk_rc_ok;
+
+    CRM_CHECK((remote != NULL) && (prepared != NULL), return EINVAL);
+
+    // Each message sent gets its own ID, even when the payload is reused
+    header = prepared->iov[0].iov_base;
+    header->id = ++id;
+
+    rc = remote_send_iovs(remote, prepared->iov, 2);
     if (rc != pcmk_rc_ok) {
         pcmk__err("Could not send remote message: %s " QB_XS " rc=%d",
                   pcmk_rc_str(rc), rc);
     }
+    return rc;
+}
+
+/*!
+ * \internal
+ * \brief Send an XML message over a Pacemaker Remote connection
+ *
+ * \param[in,out] remote  Pacemaker Remote connection to use
+ * \param[in]     msg     XML to send
+ *
+ * \return Standard Pacemaker return code
+ */
+int
+pcmk__remote_send_xml(pcmk__remote_t *remote, const xmlNode *msg)
+{
+    pcmk__remote_msg_t *prepared = NULL;
+    int rc = pcmk_rc_ok;
 
-done:
-    free(iov[0].iov_base);
+    CRM_CHECK((remote != NULL) && (msg != NULL), return EINVAL);
 
-    if (did_compress) {
-        free(iov[1].iov_base);
-    } else {
-        g_free(iov[1].iov_base);
+    rc = pcmk__remote_prepare_xml(msg, &prepared);
+    if (rc == pcmk_rc_ok) {
+        rc = pcmk__remote_send_prepared(remote, prepared);
+        pcmk__remote_free_prepared(prepared);
     }
-
     return rc;
 }
 
@@ -410,6 +485,7 @@ handle_compressed_payload(const struct remote_header_v0 *header,
     unsigned int size_u = 0;
     char *uncompressed = NULL;
     size_t buffer_size = 0;
+    size_t decompressed_len = 0;
 
 #if (UINT32_MAX < UINT_MAX)
     if (header->payload_uncompressed >= UINT_MAX) {
@@ -455,11 +531,11 @@ handle_compressed_payload(const struct remote_header_v0 *header,
 
     uncompressed = pcmk__assert_alloc(buffer_size, sizeof(char));
 
-    rc = BZ2_bzBuffToBuffDecompress(uncompressed + header->payload_offset,
-                                    &size_u,
-                                    remote->buffer + header->payload_offset,
-                                    header->payload_compressed, 1, 0);
-    rc = pcmk__bzlib2rc(rc);
+    decompressed_len = size_u;
+    rc = pcmk__decompress(remote->buffer + header->payload_offset,
+                          header->payload_compressed,
+                          uncompressed + header->payload_offset,
+                          &decompressed_len);
 
     if (rc != pcmk_rc_ok) {
         pcmk__err("Decompression failed: %s " QB_XS " rc=%d",
@@ -467,6 +543,7 @@ handle_compressed_payload(const struct remote_header_v0 *header,
         free(uncompressed);
         return rc;
     }
+    size_u = (unsigned int) decompressed_len;
 
     pcmk__assert(size_u == header->payload_uncompressed);
 
@@ -12,6 +12,9 @@
 #include <stdbool.h>
 #include <stdint.h>             // uint32_t
 #include <errno.h>              // EINVAL
+#include <string.h>             // memset
+#include <sys/resource.h>       // getrusage, struct rusage
+#include <time.h>               // clock, CLOCKS_PER_SEC
 #include <glib.h>               // gboolean, FALSE, etc.
 #include <libxml/tree.h>        // xmlNode
 
@@ -127,7 +130,9 @@ pcmk_reset_scheduler(pcmk_scheduler_t *scheduler)
     scheduler->priv->actions = NULL;
 
     g_clear_pointer(&scheduler->priv->singletons, g_hash_table_destroy);
+    g_clear_pointer(&scheduler->priv->action_index, g_hash_table_destroy);
     g_clear_pointer(&scheduler->priv->failed, pcmk__xml_free);
+    g_clear_pointer(&scheduler->priv->history_index, g_hash_table_destroy);
 
     pcmk__free_param_checks(scheduler);
 
@@ -155,6 +160,8 @@ pcmk_reset_scheduler(pcmk_scheduler_t *scheduler)
 
     scheduler->priv->synapse_count = 0;
 
+    memset(scheduler->priv->usage, 0, sizeof(scheduler->priv->usage));
+
     g_clear_pointer(&scheduler->input, pcmk__xml_free);
 
     pcmk__set_scheduler_defaults(scheduler);
@@ -313,6 +320,107 @@ pcmk__update_recheck_time(time_t recheck, pcmk_scheduler_t *scheduler,
     }
 }
 
+/*!
+ * \internal
+ * \brief Get a string representation of a scheduler phase
+ *
+ * \param[in] phase  Scheduler phase
+ *
+ * \return Static string describing \p phase (suitable for XML attribute
+ *         values and logs)
+ */
+const char *
+pcmk__sched_phase_text(enum pcmk__sched_phase phase)
+{
+    switch (phase) {
+        case pcmk__sched_phase_unpack:
+            return "unpack";
+        case pcmk__sched_phase_node_criteria:
+            return "node-criteria";
+        case pcmk__sched_phase_assign:
+            return "assign";
+        case pcmk__sched_phase_actions:
+            return "actions";
+        case pcmk__sched_phase_orderings:
+            return "orderings";
+        case pcmk__sched_phase_graph:
+            return "graph";
+        default:
+            return "unknown";
+    }
+}
+
+/*!
+ * \internal
+ * \brief Note resource usage at the start of a scheduler phase
+ *
+ * \param[out] mark  Where to store starting resource usage
+ */
+void
+pcmk__sched_phase_start(pcmk__sched_mark_t *mark)
+{
+    pcmk__assert(mark != NULL);
+
+    mark->wall_us = g_get_monotonic_time();
+    mark->cpu = clock();
+}
+
+/*!
+ * \internal
+ * \brief Add a scheduler phase's resource usage to scheduler data
+ *
+ * \param[in,out] scheduler  Scheduler data
+ * \param[in]     phase      Phase that just ended
+ * \param[in]     mark       Resource usage at start of \p phase
+ *
+ * \note Times are added to any already recorded for \p phase, while the peak
+ *       resident set size replaces any already recorded.
+ */
+void
+pcmk__sched_phase_end(pcmk_scheduler_t *scheduler,
+                      enum pcmk__sched_phase phase,
+                      const pcmk__sched_mark_t *mark)
+{
+    pcmk__sched_usage_t *usage = NULL;
+    struct rusage info;
+
+    pcmk__assert((scheduler != NULL) && (mark != NULL)
+                 && (phase < pcmk__sched_phase_max));
+
+    usage = &(scheduler->priv->usage[phase]);
+    usage->wall_s += (g_get_monotonic_time() - mark->wall_us)
+                     / (double) G_USEC_PER_SEC;
+    usage->cpu_s += (clock() - mark->cpu) / (double) CLOCKS_PER_SEC;
+
+    if (getrusage(RUSAGE_SELF, &info) == 0) {
+        usage->max_rss_kb = info.ru_maxrss;
+    }
+}
+
+/*!
+ * \internal
+ * \brief Add the resource usage of one scheduler run to a running total
+ *
+ * \param[in,out] total  Usage of each phase so far
+ * \param[in]     usage  Usage of each phase in one run
+ *
+ * \note Both arguments must have \c pcmk__sched_phase_max entries. Times are
+ *       summed, and the largest peak resident set size is kept.
+ */
+void
+pcmk__add_sched_usage(pcmk__sched_usage_t *total,
+                      const pcmk__sched_usage_t *usage)
+{
+    pcmk__assert((total != NULL) && (usage != NULL));
+
+    for (int phase = 0; phase < pcmk__sched_phase_max; phase++) {
+        total[phase].wall_s += usage[phase].wall_s;
+        total[phase].cpu_s += usage[phase].cpu_s;
+        total[phase].max_rss_kb = QB_MAX(total[phase].max_rss_kb,
+                                         usage[phase].max_rss_kb);
+    }
+}
+
 /* Fail count clearing for parameter changes normally happens when unpacking
  * history, before resources are unpacked. However, for bundles using the
  * REMOTE_CONTAINER_HACK, we can't check the conditions until after unpacking
@@ -675,6 +675,7 @@ free_schema(void *data)
             break;
     }
 
+    free(schema->valid_digest);
     free(schema->name);
     g_list_free_full(schema->transforms, free);
     free(schema);
@@ -749,6 +750,86 @@ pcmk__cmp_schemas_by_name(const char *schema1_name, const char *schema2_name)
     }
 }
 
+/*!
+ * \internal
+ * \brief Check whether a CIB version attribute value is a plain integer
+ *
+ * \param[in] value  Attribute value to check
+ *
+ * \return \c true if \p value is a nonempty string of decimal digits,
+ *         otherwise \c false
+ */
+static bool
+is_plain_integer(const char *value)
+{
+    return !pcmk__str_empty(value)
+           && (value[strspn(value, "0123456789")] == '\0');
+}
+
+/*!
+ * \internal
+ * \brief Calculate a digest of the parts of a CIB that can affect validity
+ *
+ * Every CIB schema allows anything in the status section, and requires only
+ * that the version attributes be nonnegative integers. A CIB with the same
+ * digest as one that validated against a schema therefore validates against
+ * that schema too. Most CIB updates change only the status section and the
+ * version attributes, so they leave the digest unchanged.
+ *
+ * \param[in] doc  XML document to digest
+ *
+ * \return Newly allocated digest, or \c NULL if \p doc is not a CIB
+ */
+static char *
+validation_digest(xmlDoc *doc)
+{
+    const xmlNode *cib = xmlDocGetRootElement(doc);
+    GString *buffer = NULL;
+    char *digest = NULL;
+
+    if (!pcmk__xe_is(cib, PCMK_XE_CIB)) {
+        return NULL;
+    }
+
+    buffer = g_string_sized_new(1024);
+
+    // Attributes of the cib element, ignoring integer version values
+    for (const xmlAttr *attr = pcmk__xe_first_attr(cib); attr != NULL;
+         attr = attr->next) {
+
+        const char *name = (const char *) attr->name;
+
+        if (pcmk__str_any_of(name, PCMK_XA_ADMIN_EPOCH, PCMK_XA_EPOCH,
+                             PCMK_XA_NUM_UPDATES, NULL)
+            && is_plain_integer(pcmk__xml_attr_value(attr))) {
+
+            pcmk__g_strcat(buffer, " ", name, "=#", NULL);
+
+        } else {
+            pcmk__dump_xml_attr(attr, buffer);
+        }
+    }
+
+    // Digests of the cib element's children, except the status section
+    for (const xmlNode *child = cib->children; child != NULL;
+         child = child->next) {
+
+        if (pcmk__xe_is(child, PCMK_XE_STATUS)) {
+            g_string_append(buffer, " " PCMK_XE_STATUS);
+
+        } else {
+            char *child_digest = pcmk__digest_xml(child, false);
+
+            pcmk__g_strcat(buffer, " ", child_digest, NULL);
+            free(child_digest);
+        }
+    }
+
+    digest = pcmk__md5sum(buffer->str);
+    g_string_free(buffer, TRUE);
+    return digest;
+}
+
 static bool
 validate_with(xmlDoc *doc, pcmk__schema_t *schema,
               xmlRelaxNGValidityErrorFunc error_handler,
@@ -756,6 +837,7 @@ validate_with(xmlDoc *doc, pcmk__schema_t *schema,
 {
     bool valid = false;
     char *file = NULL;
+    char *digest = NULL;
     relaxng_ctx_cache_t **cache = NULL;
 
     if (schema == NULL) {
@@ -766,6 +848,19 @@ validate_with(xmlDoc *doc, pcmk__schema_t *schema,
         return true;
     }
 
+    /* Only a positive result is remembered, because an invalid CIB must be
+     * validated again so that its errors are reported to the caller
+     */
+    digest = validation_digest(doc);
+    if ((digest != NULL)
+        && pcmk__str_eq(digest, schema->valid_digest, pcmk__str_none)) {
+
+        pcmk__trace("CIB validates with %s (configuration unchanged since "
+                    "last validated)", schema->name);
+        free(digest);
+        return true;
+    }
+
     file = pcmk__xml_artefact_path(pcmk__xml_artefact_ns_legacy_rng,
                                    schema->name);
 
@@ -782,6 +877,13 @@ validate_with(xmlDoc *doc, pcmk__schema_t *schema,
             break;
     }
 
+    if (valid && (digest != NULL)) {
+        free(schema->valid_digest);
+        schema->valid_digest = digest;
+        digest = NULL;
+    }
+
+    free(digest);
     free(file);
     return valid;
 }
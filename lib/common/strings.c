@@ -19,6 +19,9 @@
 #include <float.h>  // DBL_MIN
 #include <limits.h>
 #include <bzlib.h>
+#if HAVE_ZSTD
+#include <zstd.h>
+#endif
 #include <sys/types.h>
 
 /*!
@@ -639,6 +642,77 @@ pcmk__compress(const char *data, size_t length, char **result, size_t *result_le
     return pcmk_rc_ok;
 }
 
+/*!
+ * \internal
+ * \brief Decompress data whose uncompressed size is known
+ *
+ * The compression format is detected from the data itself, so this accepts
+ * anything \c pcmk__compress() produces as well as \c zstd data (if built with
+ * \c libzstd support).
+ *
+ * \param[in]     data        Data to decompress
+ * \param[in]     length      Number of bytes of data to decompress
+ * \param[out]    result      Where to store decompressed data
+ * \param[in,out] result_len  On input, size of \p result; on output, number
+ *                            of bytes actually decompressed into \p result
+ *
+ * \return Standard Pacemaker return code
+ */
+int
+pcmk__decompress(const char *data, size_t length, char *result,
+                 size_t *result_len)
+{
+    int rc = pcmk_rc_ok;
+
+    pcmk__assert((data != NULL) && (result != NULL) && (result_len != NULL));
+
+    switch (pcmk__compression_detect(data, length)) {
+        case pcmk__compression_bzip2:
+            {
+                unsigned int dest_len = 0;
+
+#if (SIZE_MAX > UINT_MAX)
+                if ((length > UINT_MAX) || (*result_len > UINT_MAX)) {
+                    return EINVAL;
+                }
+#endif
+                dest_len = (unsigned int) *result_len;
+                rc = BZ2_bzBuffToBuffDecompress(result, &dest_len,
+                                                (char *) data,
+                                                (unsigned int) length, 1, 0);
+                rc = pcmk__bzlib2rc(rc);
+                *result_len = dest_len;
+            }
+            break;
+
+        case pcmk__compression_zstd:
+#if HAVE_ZSTD
+            {
+                size_t zrc = ZSTD_decompress(result, *result_len, data,
+                                             length);
+
+                if (ZSTD_isError(zrc)) {
+                    pcmk__debug("zstd decompression failed: %s",
+                                ZSTD_getErrorName(zrc));
+                    return pcmk_rc_compression;
+                }
+                *result_len = zrc;
+            }
+            break;
+#else
+            return ENOTSUP;
+#endif
+
+        default:
+            return pcmk_rc_bad_input;
+    }
+
+    if (rc == pcmk_rc_ok) {
+        pcmk__trace("Decompressed %zu bytes into %zu", length, *result_len);
+    }
+    return rc;
+}
+
 /*!
  * \internal
  * \brief Parse a boolean value from a string
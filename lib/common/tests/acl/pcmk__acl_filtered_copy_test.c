@@ -0,0 +1,156 @@
+/*
+ * Copyright 2026 the Pacemaker project contributors
+ *
+ * The version control history for this file may have further details.
+ *
+ * This source code is licensed under the GNU General Public License version 2
+ * or later (GPLv2+) WITHOUT ANY WARRANTY.
+ */
+
+#include <crm_internal.h>
+
+#include <crm/common/unittest_internal.h>
+
+#define ACLS                                                                \
+    "<acls>"                                                                \
+      "<acl_target id=\"alice\"><role id=\"r1\"/></acl_target>"             \
+      "<acl_target id=\"bob\"><role id=\"r2\"/></acl_target>"               \
+      "<acl_target id=\"carol\"/>"                                          \
+      "<acl_role id=\"r1\">"                                                \
+        "<acl_permission id=\"p1\" kind=\"read\" reference=\"rsc1\"/>"      \
+        "<acl_permission id=\"p2\" kind=\"deny\" "                          \
+                        "xpath=\"//primitive[@id='rsc1']/meta_attributes\"/>"\
+      "</acl_role>"                                                         \
+      "<acl_role id=\"r2\">"                                                \
+        "<acl_permission id=\"p3\" kind=\"read\" xpath=\"/cib\"/>"          \
+        "<acl_permission id=\"p4\" kind=\"deny\" object-type=\"acls\"/>"    \
+        "<acl_permission id=\"p5\" kind=\"deny\" object-type=\"status\"/>"  \
+      "</acl_role>"                                                         \
+    "</acls>"
+
+#define RESOURCES                                                           \
+    "<resources>"                                                           \
+      "<primitive id=\"rsc1\" class=\"ocf\" type=\"Dummy\">"                \
+        "<meta_attributes id=\"m1\">"                                       \
+          "<nvpair id=\"n1\" name=\"a\" value=\"b\"/>"                      \
+        "</meta_attributes>"                                                \
+      "</primitive>"                                                        \
+      "<primitive id=\"rsc2\" class=\"ocf\" type=\"Dummy\"/>"               \
+    "</resources>"
+
+#define CIB                                                                 \
+    "<cib epoch=\"1\">"                                                     \
+      "<configuration>" ACLS RESOURCES "</configuration>"                   \
+      "<status><node_state id=\"1\"/></status>"                             \
+    "</cib>"
+
+static void
+assert_filtered(const char *user, const char *expected)
+{
+    xmlNode *cib = pcmk__xml_parse(CIB);
+    xmlNode *result = NULL;
+
+    assert_non_null(cib);
+    result = pcmk__acl_filtered_copy(user, cib->doc, cib);
+
+    if (expected == NULL) {
+        assert_null(result);
+
+    } else {
+        GString *buf = g_string_sized_new(1024);
+
+        assert_non_null(result);
+        assert_ptr_not_equal(result->doc, cib->doc);
+        pcmk__xml_string(result, pcmk__xml_fmt_text, buf, 0);
+        assert_string_equal(buf->str, expected);
+        g_string_free(buf, TRUE);
+    }
+
+    pcmk__xml_free(result);
+    pcmk__xml_free(cib);
+}
+
+static void
+privileged_user(void **state)
+{
+    assert_filtered("root", CIB);
+    assert_filtered(NULL, CIB);
+}
+
+static void
+unknown_user(void **state)
+{
+    assert_filtered("nobody", NULL);
+}
+
+static void
+user_without_permissions(void **state)
+{
+    assert_filtered("carol", NULL);
+}
+
+static void
+read_with_denied_descendant(void **state)
+{
+    assert_filtered("alice",
+                    "<cib>"
+                      "<configuration>"
+                        "<resources>"
+                          "<primitive id=\"rsc1\" class=\"ocf\" "
+                                     "type=\"Dummy\"/>"
+                        "</resources>"
+                      "</configuration>"
+                    "</cib>");
+}
+
+static void
+read_all_but_denied(void **state)
+{
+    assert_filtered("bob",
+                    "<cib epoch=\"1\">"
+                      "<configuration>" RESOURCES "</configuration>"
+                    "</cib>");
+}
+
+static void
+repeated_and_changed(void **state)
+{
+    xmlNode *cib = pcmk__xml_parse(CIB);
+    xmlNode *result = NULL;
+    xmlNode *permission = NULL;
+
+    // Use cached ACL definitions, then change them
+    assert_filtered("alice", "<cib><configuration><resources>"
+                             "<primitive id=\"rsc1\" class=\"ocf\" "
+                             "type=\"Dummy\"/></resources></configuration>"
+                             "</cib>");
+
+    permission = pcmk__xpath_find_one(cib->doc,
+                                      "//" PCMK_XE_ACL_PERMISSION
+                                      "[@" PCMK_XA_ID "='p1']",
+                                      PCMK__LOG_NEVER);
+    assert_non_null(permission);
+    pcmk__xe_set(permission, PCMK_XA_REFERENCE, "rsc2");
+
+    result = pcmk__acl_filtered_copy("alice", cib->doc, cib);
+    assert_non_null(result);
+    assert_non_null(pcmk__xpath_find_one(result->doc,
+                                         "//" PCMK_XE_PRIMITIVE
+                                         "[@" PCMK_XA_ID "='rsc2']",
+                                         PCMK__LOG_NEVER));
+    assert_null(pcmk__xpath_find_one(result->doc,
+                                     "//" PCMK_XE_PRIMITIVE
+                                     "[@" PCMK_XA_ID "='rsc1']",
+                                     PCMK__LOG_NEVER));
+
+    pcmk__xml_free(result);
+    pcmk__xml_free(cib);
+}
+
+PCMK__UNIT_TEST(pcmk__xml_test_setup_group, pcmk__xml_test_teardown_group,
+                cmocka_unit_test(privileged_user),
+                cmocka_unit_test(unknown_user),
+                cmocka_unit_test(user_without_permissions),
+                cmocka_unit_test(read_with_denied_descendant),
+                cmocka_unit_test(read_all_but_denied),
+                cmocka_unit_test(repeated_and_changed))
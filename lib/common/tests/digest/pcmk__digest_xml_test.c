@@ -0,0 +1,144 @@
+/*
+ * Copyright 2026 the Pacemaker project contributors
+ *
+ * The version control history for this file may have further details.
+ *
+ * This source code is licensed under the GNU General Public License version 2
+ * or later (GPLv2+) WITHOUT ANY WARRANTY.
+ */
+
+#include <crm_internal.h>
+
+#include <crm/common/unittest_internal.h>
+#include <crm/common/xml.h>
+
+/* pcmk__digest_xml() and pcmk__digest_on_disk_cib() hash XML text as it is
+ * serialized, without building the full string. These tests check that the
+ * result is the same as hashing the output of pcmk__xml_string().
+ */
+
+static void
+assert_digest_matches(const xmlNode *xml)
+{
+    GString *buffer = g_string_sized_new(1024);
+    char *expected = NULL;
+    char *digest = NULL;
+
+    // v2, unfiltered
+    pcmk__xml_string(xml, 0, buffer, 0);
+    expected = pcmk__md5sum(buffer->str);
+    digest = pcmk__digest_xml(xml, false);
+    assert_string_equal(digest, expected);
+    free(expected);
+    free(digest);
+
+    // v2, filtered
+    g_string_truncate(buffer, 0);
+    pcmk__xml_string(xml, pcmk__xml_fmt_filtered, buffer, 0);
+    expected = pcmk__md5sum(buffer->str);
+    digest = pcmk__digest_xml(xml, true);
+    assert_string_equal(digest, expected);
+    free(expected);
+    free(digest);
+
+    // v1 (leading space and trailing newline), unfiltered
+    g_string_truncate(buffer, 0);
+    g_string_append_c(buffer, ' ');
+    pcmk__xml_string(xml, 0, buffer, 0);
+    g_string_append_c(buffer, '\n');
+    expected = pcmk__md5sum(buffer->str);
+    digest = pcmk__digest_on_disk_cib(xml);
+    assert_string_equal(digest, expected);
+    free(expected);
+    free(digest);
+
+    g_string_free(buffer, TRUE);
+}
+
+static void
+assert_digest_matches_str(const char *input)
+{
+    xmlNode *xml = pcmk__xml_parse(input);
+
+    assert_non_null(xml);
+    assert_digest_matches(xml);
+    pcmk__xml_free(xml);
+}
+
+static void
+empty_element(void **state)
+{
+    assert_digest_matches_str("<cib/>");
+    assert_digest_matches_str("<cib epoch=\"1\" num_updates=\"2\"/>");
+}
+
+static void
+escaped_values(void **state)
+{
+    assert_digest_matches_str("<cib>"
+                                "<a x=\"&lt;&gt;&amp;&quot;&apos;\"/>"
+                                "<b y=\"tab&#9;nl&#10;cr&#13;\">"
+                                  "<c z=\"caf&#xE9;\"/>"
+                                "</b>"
+                              "</cib>");
+}
+
+static void
+comments(void **state)
+{
+    assert_digest_matches_str("<cib>"
+                                "<!-- first -->"
+                                "<a>"
+                                  "<!-- nested <not> &amp; -->"
+                                  "<b/>"
+                                "</a>"
+                                "<!---->"
+                              "</cib>");
+}
+
+static void
+filterable_attrs(void **state)
+{
+    // Filterable attributes at the root, on a leaf, and on a parent
+    assert_digest_matches_str("<cib " PCMK_XA_CIB_LAST_WRITTEN "=\"now\" "
+                                   PCMK_XA_UPDATE_ORIGIN "=\"node1\" "
+                                   PCMK_XA_EPOCH "=\"3\">"
+                                "<a " PCMK_XA_CRM_DEBUG_ORIGIN "=\"here\"/>"
+                                "<b " PCMK_XA_UPDATE_CLIENT "=\"cibadmin\" "
+                                     PCMK_XA_UPDATE_USER "=\"root\" "
+                                     PCMK_XA_ID "=\"b1\">"
+                                  "<c " PCMK_XA_CRM_DEBUG_ORIGIN "=\"x\"/>"
+                                "</b>"
+                              "</cib>");
+}
+
+static void
+large_tree(void **state)
+{
+    // Big enough that the text is hashed in several chunks
+    xmlNode *xml = pcmk__xe_create(NULL, PCMK_XE_CIB);
+    xmlNode *parent = pcmk__xe_create(xml, PCMK_XE_STATUS);
+
+    for (int i = 0; i < 2000; i++) {
+        xmlNode *child = pcmk__xe_create(parent, PCMK__XE_NODE_STATE);
+        char *id = pcmk__itoa(i);
+
+        pcmk__xe_set(child, PCMK_XA_ID, id);
+        pcmk__xe_set(child, PCMK_XA_CRM_DEBUG_ORIGIN, "large_tree");
+        pcmk__xe_set(child, PCMK_XA_UNAME, "<node & \"name\">");
+        if ((i % 100) == 0) {
+            pcmk__xe_create(child, PCMK__XE_LRM);
+        }
+        free(id);
+    }
+
+    assert_digest_matches(xml);
+    pcmk__xml_free(xml);
+}
+
+PCMK__UNIT_TEST(pcmk__xml_test_setup_group, pcmk__xml_test_teardown_group,
+                cmocka_unit_test(empty_element),
+                cmocka_unit_test(escaped_values),
+                cmocka_unit_test(comments),
+                cmocka_unit_test(filterable_attrs),
+                cmocka_unit_test(large_tree))
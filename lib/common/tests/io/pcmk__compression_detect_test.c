@@ -0,0 +1,86 @@
+/*
+ * Copyright 2026 the Pacemaker project contributors
+ *
+ * The version control history for this file may have further details.
+ *
+ * This source code is licensed under the GNU General Public License version 2
+ * or later (GPLv2+) WITHOUT ANY WARRANTY.
+ */
+
+#include <crm_internal.h>
+
+#include <string.h>                 // strlen
+
+#include <crm/common/unittest_internal.h>
+
+static void
+null_input(void **state)
+{
+    assert_int_equal(pcmk__compression_detect(NULL, 0),
+                     pcmk__compression_none);
+    assert_int_equal(pcmk__compression_detect(NULL, 10),
+                     pcmk__compression_none);
+}
+
+static void
+plain_text(void **state)
+{
+    const char *text = "<cib/>";
+
+    assert_int_equal(pcmk__compression_detect(text, strlen(text)),
+                     pcmk__compression_none);
+    assert_int_equal(pcmk__compression_detect("", 0), pcmk__compression_none);
+}
+
+static void
+bzip2_data(void **state)
+{
+    char *result = NULL;
+    size_t len = 0;
+    const char *data = "AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA";
+
+    assert_int_equal(pcmk__compress(data, strlen(data), &result, &len),
+                     pcmk_rc_ok);
+    assert_int_equal(pcmk__compression_detect(result, len),
+                     pcmk__compression_bzip2);
+    free(result);
+
+    // Block size must be a digit from 1 to 9
+    assert_int_equal(pcmk__compression_detect("BZh0", 4),
+                     pcmk__compression_none);
+
+    // Magic alone is too short
+    assert_int_equal(pcmk__compression_detect("BZh", 3),
+                     pcmk__compression_none);
+}
+
+static void
+zstd_data(void **state)
+{
+    const char magic[] = { 0x28, 0xB5, 0x2F, 0xFD, 0x00 };
+
+    assert_int_equal(pcmk__compression_detect(magic, sizeof(magic)),
+                     pcmk__compression_zstd);
+    assert_int_equal(pcmk__compression_detect(magic, 3),
+                     pcmk__compression_none);
+}
+
+static void
+filenames(void **state)
+{
+    assert_int_equal(pcmk__compression_from_filename(NULL),
+                     pcmk__compression_none);
+    assert_int_equal(pcmk__compression_from_filename("pe-input-1.raw"),
+                     pcmk__compression_none);
+    assert_int_equal(pcmk__compression_from_filename("pe-input-1.bz2"),
+                     pcmk__compression_bzip2);
+    assert_int_equal(pcmk__compression_from_filename("pe-input-1.zst"),
+                     pcmk__compression_zstd);
+}
+
+PCMK__UNIT_TEST(NULL, NULL,
+                cmocka_unit_test(null_input),
+                cmocka_unit_test(plain_text),
+                cmocka_unit_test(bzip2_data),
+                cmocka_unit_test(zstd_data),
+                cmocka_unit_test(filenames))
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2026 the Pacemaker project contributors
+ *
+ * The version control history for this file may have further details.
+ *
+ * This source code is licensed under the GNU General Public License version 2
+ * or later (GPLv2+) WITHOUT ANY WARRANTY.
+ */
+
+#include <crm_internal.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <glib.h>
+
+#include <crm/common/unittest_internal.h>
+
+static char *dir = NULL;
+
+static void
+create_file(const char *name)
+{
+    char *path = pcmk__assert_asprintf("%s/%s", dir, name);
+    FILE *fp = fopen(path, "w");
+
+    assert_non_null(fp);
+    fclose(fp);
+    free(path);
+}
+
+static bool
+file_exists(const char *name)
+{
+    char *path = pcmk__assert_asprintf("%s/%s", dir, name);
+    bool exists = (access(path, F_OK) == 0);
+
+    free(path);
+    return exists;
+}
+
+static void
+remove_file(const char *name)
+{
+    char *path = pcmk__assert_asprintf("%s/%s", dir, name);
+
+    unlink(path);
+    free(path);
+}
+
+static int
+setup(void **state)
+{
+    dir = g_dir_make_tmp("pcmk__remove_series_file_test.XXXXXX", NULL);
+    assert_non_null(dir);
+    return 0;
+}
+
+static int
+teardown(void **state)
+{
+    const char *files[] = {
+        "pe-input-3.raw", "pe-input-3.bz2", "pe-input-3.zst",
+        "pe-input-4.bz2", "pe-warn-3.bz2",
+    };
+
+    for (int i = 0; i < PCMK__NELEM(files); i++) {
+        remove_file(files[i]);
+    }
+    rmdir(dir);
+    g_clear_pointer(&dir, g_free);
+    return 0;
+}
+
+static void
+null_args(void **state)
+{
+    pcmk__assert_asserts(pcmk__remove_series_file(NULL, "pe-input", 1));
+    pcmk__assert_asserts(pcmk__remove_series_file(dir, NULL, 1));
+}
+
+static void
+no_files(void **state)
+{
+    // Nothing to remove is not an error
+    pcmk__remove_series_file(dir, "pe-input", 3);
+    assert_false(file_exists("pe-input-3.bz2"));
+}
+
+static void
+all_extensions_removed(void **state)
+{
+    create_file("pe-input-3.raw");
+    create_file("pe-input-3.bz2");
+    create_file("pe-input-3.zst");
+
+    pcmk__remove_series_file(dir, "pe-input", 3);
+
+    assert_false(file_exists("pe-input-3.raw"));
+    assert_false(file_exists("pe-input-3.bz2"));
+    assert_false(file_exists("pe-input-3.zst"));
+}
+
+static void
+other_files_kept(void **state)
+{
+    create_file("pe-input-3.bz2");
+    create_file("pe-input-4.bz2");
+    create_file("pe-warn-3.bz2");
+
+    pcmk__remove_series_file(dir, "pe-input", 3);
+
+    assert_false(file_exists("pe-input-3.bz2"));
+    assert_true(file_exists("pe-input-4.bz2"));
+    assert_true(file_exists("pe-warn-3.bz2"));
+}
+
+PCMK__UNIT_TEST(NULL, NULL,
+                cmocka_unit_test_setup_teardown(null_args, setup, teardown),
+                cmocka_unit_test_setup_teardown(no_files, setup, teardown),
+                cmocka_unit_test_setup_teardown(all_extensions_removed, setup,
+                                                teardown),
+                cmocka_unit_test_setup_teardown(other_files_kept, setup,
+                                                teardown))
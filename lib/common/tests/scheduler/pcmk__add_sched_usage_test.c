@@ -0,0 +1,53 @@
+/*
+ * Copyright 2026 the Pacemaker project contributors
+ *
+ * The version control history for this file may have further details.
+ *
+ * This source code is licensed under the GNU General Public License version 2
+ * or later (GPLv2+) WITHOUT ANY WARRANTY.
+ */
+
+#include <crm_internal.h>
+
+#include <crm/common/scheduler.h>
+#include <crm/common/unittest_internal.h>
+
+static void
+null_args(void **state)
+{
+    pcmk__sched_usage_t usage[pcmk__sched_phase_max] = { { 0, }, };
+
+    pcmk__assert_asserts(pcmk__add_sched_usage(NULL, usage));
+    pcmk__assert_asserts(pcmk__add_sched_usage(usage, NULL));
+}
+
+static void
+sums_times_keeps_peak(void **state)
+{
+    pcmk__sched_usage_t total[pcmk__sched_phase_max] = { { 0, }, };
+    pcmk__sched_usage_t run[pcmk__sched_phase_max] = { { 0, }, };
+
+    for (int phase = 0; phase < pcmk__sched_phase_max; phase++) {
+        run[phase].wall_s = 0.5 * (phase + 1);
+        run[phase].cpu_s = 0.25 * (phase + 1);
+        run[phase].max_rss_kb = 1000 + phase;
+    }
+    pcmk__add_sched_usage(total, run);
+
+    // Second run used more memory in some phases and less in others
+    for (int phase = 0; phase < pcmk__sched_phase_max; phase++) {
+        run[phase].max_rss_kb = ((phase % 2) == 0)? 500 : 2000;
+    }
+    pcmk__add_sched_usage(total, run);
+
+    for (int phase = 0; phase < pcmk__sched_phase_max; phase++) {
+        assert_float_equal(total[phase].wall_s, 1.0 * (phase + 1), 1e-9);
+        assert_float_equal(total[phase].cpu_s, 0.5 * (phase + 1), 1e-9);
+        assert_int_equal(total[phase].max_rss_kb,
+                         ((phase % 2) == 0)? (1000 + phase) : 2000);
+    }
+}
+
+PCMK__UNIT_TEST(NULL, NULL,
+                cmocka_unit_test(null_args),
+                cmocka_unit_test(sums_times_keeps_peak))
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2026 the Pacemaker project contributors
+ *
+ * The version control history for this file may have further details.
+ *
+ * This source code is licensed under the GNU General Public License version 2
+ * or later (GPLv2+) WITHOUT ANY WARRANTY.
+ */
+
+#include <crm_internal.h>
+
+#include <time.h>           // clock()
+
+#include <crm/common/scheduler.h>
+#include <crm/common/unittest_internal.h>
+
+// Use some CPU time, so it is measurable
+static void
+busy_wait(void)
+{
+    clock_t start = clock();
+
+    while ((clock() - start) < (CLOCKS_PER_SEC / 100)) {
+        // Do nothing
+    }
+}
+
+static void
+null_args(void **state)
+{
+    pcmk_scheduler_t *scheduler = pcmk_new_scheduler();
+    pcmk__sched_mark_t mark;
+
+    pcmk__assert_asserts(pcmk__sched_phase_start(NULL));
+
+    pcmk__sched_phase_start(&mark);
+    pcmk__assert_asserts(pcmk__sched_phase_end(NULL, pcmk__sched_phase_unpack,
+                                               &mark));
+    pcmk__assert_asserts(pcmk__sched_phase_end(scheduler,
+                                               pcmk__sched_phase_unpack,
+                                               NULL));
+    pcmk__assert_asserts(pcmk__sched_phase_end(scheduler,
+                                               pcmk__sched_phase_max, &mark));
+    pcmk_free_scheduler(scheduler);
+}
+
+static void
+records_one_phase(void **state)
+{
+    pcmk_scheduler_t *scheduler = pcmk_new_scheduler();
+    const pcmk__sched_usage_t *usage = scheduler->priv->usage;
+    pcmk__sched_mark_t mark;
+
+    pcmk__sched_phase_start(&mark);
+    busy_wait();
+    pcmk__sched_phase_end(scheduler, pcmk__sched_phase_assign, &mark);
+
+    assert_true(usage[pcmk__sched_phase_assign].wall_s > 0.0);
+    assert_true(usage[pcmk__sched_phase_assign].cpu_s > 0.0);
+    assert_true(usage[pcmk__sched_phase_assign].max_rss_kb > 0);
+
+    // Other phases are untouched
+    for (int phase = 0; phase < pcmk__sched_phase_max; phase++) {
+        if (phase != pcmk__sched_phase_assign) {
+            assert_true(usage[phase].wall_s == 0.0);
+            assert_true(usage[phase].cpu_s == 0.0);
+            assert_int_equal(usage[phase].max_rss_kb, 0);
+        }
+    }
+
+    pcmk_free_scheduler(scheduler);
+}
+
+static void
+accumulates_times(void **state)
+{
+    pcmk_scheduler_t *scheduler = pcmk_new_scheduler();
+    const pcmk__sched_usage_t *usage =
+        &(scheduler->priv->usage[pcmk__sched_phase_graph]);
+    pcmk__sched_mark_t mark;
+    double wall_s = 0.0;
+    double cpu_s = 0.0;
+
+    pcmk__sched_phase_start(&mark);
+    busy_wait();
+    pcmk__sched_phase_end(scheduler, pcmk__sched_phase_graph, &mark);
+    wall_s = usage->wall_s;
+    cpu_s = usage->cpu_s;
+
+    // Ending the same phase again adds to the times rather than replacing them
+    pcmk__sched_phase_start(&mark);
+    busy_wait();
+    pcmk__sched_phase_end(scheduler, pcmk__sched_phase_graph, &mark);
+    assert_true(usage->wall_s > wall_s);
+    assert_true(usage->cpu_s > cpu_s);
+
+    pcmk_free_scheduler(scheduler);
+}
+
+static void
+reset_clears_usage(void **state)
+{
+    pcmk_scheduler_t *scheduler = pcmk_new_scheduler();
+    pcmk__sched_mark_t mark;
+
+    pcmk__sched_phase_start(&mark);
+    busy_wait();
+    pcmk__sched_phase_end(scheduler, pcmk__sched_phase_unpack, &mark);
+    assert_true(scheduler->priv->usage[pcmk__sched_phase_unpack].cpu_s > 0.0);
+
+    pcmk_reset_scheduler(scheduler);
+    for (int phase = 0; phase < pcmk__sched_phase_max; phase++) {
+        assert_true(scheduler->priv->usage[phase].wall_s == 0.0);
+        assert_true(scheduler->priv->usage[phase].cpu_s == 0.0);
+        assert_int_equal(scheduler->priv->usage[phase].max_rss_kb, 0);
+    }
+
+    pcmk_free_scheduler(scheduler);
+}
+
+PCMK__UNIT_TEST(NULL, NULL,
+                cmocka_unit_test(null_args),
+                cmocka_unit_test(records_one_phase),
+                cmocka_unit_test(accumulates_times),
+                cmocka_unit_test(reset_clears_usage))
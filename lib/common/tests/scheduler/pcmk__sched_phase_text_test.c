@@ -0,0 +1,41 @@
+/*
+ * Copyright 2026 the Pacemaker project contributors
+ *
+ * The version control history for this file may have further details.
+ *
+ * This source code is licensed under the GNU General Public License version 2
+ * or later (GPLv2+) WITHOUT ANY WARRANTY.
+ */
+
+#include <crm_internal.h>
+
+#include <crm/common/scheduler.h>
+#include <crm/common/unittest_internal.h>
+
+static void
+known_phases(void **state)
+{
+    assert_string_equal(pcmk__sched_phase_text(pcmk__sched_phase_unpack),
+                        "unpack");
+    assert_string_equal(pcmk__sched_phase_text(pcmk__sched_phase_node_criteria),
+                        "node-criteria");
+    assert_string_equal(pcmk__sched_phase_text(pcmk__sched_phase_assign),
+                        "assign");
+    assert_string_equal(pcmk__sched_phase_text(pcmk__sched_phase_actions),
+                        "actions");
+    assert_string_equal(pcmk__sched_phase_text(pcmk__sched_phase_orderings),
+                        "orderings");
+    assert_string_equal(pcmk__sched_phase_text(pcmk__sched_phase_graph),
+                        "graph");
+}
+
+static void
+unknown_phase(void **state)
+{
+    assert_string_equal(pcmk__sched_phase_text(pcmk__sched_phase_max),
+                        "unknown");
+}
+
+PCMK__UNIT_TEST(NULL, NULL,
+                cmocka_unit_test(known_phases),
+                cmocka_unit_test(unknown_phase))
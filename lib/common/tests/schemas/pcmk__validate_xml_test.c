@@ -0,0 +1,162 @@
+/*
+ * Copyright 2026 the Pacemaker project contributors
+ *
+ * The version control history for this file may have further details.
+ *
+ * This source code is licensed under the GNU General Public License version 2
+ * or later (GPLv2+) WITHOUT ANY WARRANTY.
+ */
+
+#include <crm_internal.h>
+
+#include <crm/common/xml.h>
+#include <crm/common/unittest_internal.h>
+#include "crmcommon_private.h"
+
+#define CIB_XML                                                             \
+    "<" PCMK_XE_CIB " " PCMK_XA_VALIDATE_WITH "='pacemaker-3.0' "           \
+        PCMK_XA_ADMIN_EPOCH "='0' " PCMK_XA_EPOCH "='1' "                   \
+        PCMK_XA_NUM_UPDATES "='0'>"                                         \
+      "<" PCMK_XE_CONFIGURATION ">"                                         \
+        "<" PCMK_XE_CRM_CONFIG "/>"                                         \
+        "<" PCMK_XE_NODES "/>"                                              \
+        "<" PCMK_XE_RESOURCES "/>"                                          \
+        "<" PCMK_XE_CONSTRAINTS "/>"                                        \
+      "</" PCMK_XE_CONFIGURATION ">"                                        \
+      "<" PCMK_XE_STATUS "/>"                                               \
+    "</" PCMK_XE_CIB ">"
+
+static int
+setup(void **state)
+{
+    setenv("PCMK_schema_directory", PCMK__TEST_SCHEMA_DIR, 1);
+    pcmk__xml_test_setup_group(state);
+    return 0;
+}
+
+static int
+teardown(void **state)
+{
+    pcmk__xml_test_teardown_group(state);
+    unsetenv("PCMK_schema_directory");
+    return 0;
+}
+
+static void
+ignore_errors(void *ctx, const char *fmt, ...)
+{
+}
+
+static bool
+validates(xmlNode *xml)
+{
+    return pcmk__validate_xml(xml, (xmlRelaxNGValidityErrorFunc) ignore_errors,
+                              NULL);
+}
+
+static pcmk__schema_t *
+get_schema(const char *name)
+{
+    GList *entry = pcmk__get_schema(name);
+
+    assert_non_null(entry);
+    return entry->data;
+}
+
+static void
+status_changes_keep_digest(void **state)
+{
+    xmlNode *cib = pcmk__xml_parse(CIB_XML);
+    pcmk__schema_t *schema = get_schema("pacemaker-3.0");
+    char *digest = NULL;
+
+    assert_true(validates(cib));
+    assert_non_null(schema->valid_digest);
+    digest = pcmk__str_copy(schema->valid_digest);
+
+    // Anything goes in the status section, and versions may change
+    pcmk__xe_create(pcmk__xe_first_child(cib, PCMK_XE_STATUS, NULL, NULL),
+                    "anything");
+    pcmk__xe_set(cib, PCMK_XA_EPOCH, "2");
+    pcmk__xe_set(cib, PCMK_XA_NUM_UPDATES, "15");
+
+    assert_true(validates(cib));
+    assert_string_equal(schema->valid_digest, digest);
+
+    free(digest);
+    pcmk__xml_free(cib);
+}
+
+static void
+config_changes_are_validated(void **state)
+{
+    xmlNode *cib = pcmk__xml_parse(CIB_XML);
+    xmlNode *config = pcmk__xe_first_child(cib, PCMK_XE_CONFIGURATION, NULL,
+                                           NULL);
+    xmlNode *invalid = NULL;
+
+    assert_true(validates(cib));
+
+    invalid = pcmk__xe_create(config, "not-a-section");
+    assert_false(validates(cib));
+
+    pcmk__xml_free(invalid);
+    assert_true(validates(cib));
+
+    pcmk__xml_free(cib);
+}
+
+static void
+bad_version_is_validated(void **state)
+{
+    xmlNode *cib = pcmk__xml_parse(CIB_XML);
+
+    assert_true(validates(cib));
+
+    pcmk__xe_set(cib, PCMK_XA_EPOCH, "-1");
+    assert_false(validates(cib));
+
+    pcmk__xe_set(cib, PCMK_XA_EPOCH, "one");
+    assert_false(validates(cib));
+
+    pcmk__xe_set(cib, PCMK_XA_EPOCH, "3");
+    assert_true(validates(cib));
+
+    pcmk__xml_free(cib);
+}
+
+static void
+root_attribute_changes_are_validated(void **state)
+{
+    xmlNode *cib = pcmk__xml_parse(CIB_XML);
+
+    assert_true(validates(cib));
+
+    pcmk__xe_set(cib, PCMK_XA_HAVE_QUORUM, "maybe");
+    assert_false(validates(cib));
+
+    pcmk__xe_set(cib, PCMK_XA_HAVE_QUORUM, "true");
+    assert_true(validates(cib));
+
+    pcmk__xml_free(cib);
+}
+
+static void
+non_cib_not_cached(void **state)
+{
+    xmlNode *xml = pcmk__xe_create(NULL, "not-a-cib");
+    pcmk__schema_t *schema = get_schema("pacemaker-2.0");
+
+    pcmk__xe_set(xml, PCMK_XA_VALIDATE_WITH, "pacemaker-2.0");
+    assert_false(validates(xml));
+    assert_null(schema->valid_digest);
+
+    pcmk__xml_free(xml);
+}
+
+PCMK__UNIT_TEST(setup, teardown,
+                cmocka_unit_test(status_changes_keep_digest),
+                cmocka_unit_test(config_changes_are_validated),
+                cmocka_unit_test(bad_version_is_validated),
+                cmocka_unit_test(root_attribute_changes_are_validated),
+                cmocka_unit_test(non_cib_not_cached))
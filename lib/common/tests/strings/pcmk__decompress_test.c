@@ -0,0 +1,80 @@
+/*
+ * Copyright 2026 the Pacemaker project contributors
+ *
+ * The version control history for this file may have further details.
+ *
+ * This source code is licensed under the GNU General Public License version 2
+ * or later (GPLv2+) WITHOUT ANY WARRANTY.
+ */
+
+#include <crm_internal.h>
+
+#include <string.h>                 // strlen
+
+#include <crm/common/unittest_internal.h>
+
+#define SIMPLE_DATA "AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA"
+
+static void
+null_args(void **state)
+{
+    char buffer[64];
+    size_t len = sizeof(buffer);
+
+    pcmk__assert_asserts(pcmk__decompress(NULL, 0, buffer, &len));
+    pcmk__assert_asserts(pcmk__decompress(SIMPLE_DATA, 4, NULL, &len));
+    pcmk__assert_asserts(pcmk__decompress(SIMPLE_DATA, 4, buffer, NULL));
+}
+
+static void
+not_compressed(void **state)
+{
+    char buffer[64];
+    size_t len = sizeof(buffer);
+
+    assert_int_equal(pcmk__decompress(SIMPLE_DATA, strlen(SIMPLE_DATA), buffer,
+                                      &len),
+                     pcmk_rc_bad_input);
+}
+
+static void
+bzip2_round_trip(void **state)
+{
+    char *compressed = NULL;
+    size_t compressed_len = 0;
+    char buffer[64] = { 0, };
+    size_t len = sizeof(buffer);
+
+    assert_int_equal(pcmk__compress(SIMPLE_DATA, sizeof(SIMPLE_DATA),
+                                    &compressed, &compressed_len),
+                     pcmk_rc_ok);
+    assert_int_equal(pcmk__decompress(compressed, compressed_len, buffer,
+                                      &len),
+                     pcmk_rc_ok);
+    assert_int_equal(len, sizeof(SIMPLE_DATA));
+    assert_string_equal(buffer, SIMPLE_DATA);
+    free(compressed);
+}
+
+static void
+output_too_small(void **state)
+{
+    char *compressed = NULL;
+    size_t compressed_len = 0;
+    char buffer[8];
+    size_t len = sizeof(buffer);
+
+    assert_int_equal(pcmk__compress(SIMPLE_DATA, sizeof(SIMPLE_DATA),
+                                    &compressed, &compressed_len),
+                     pcmk_rc_ok);
+    assert_int_not_equal(pcmk__decompress(compressed, compressed_len, buffer,
+                                          &len),
+                         pcmk_rc_ok);
+    free(compressed);
+}
+
+PCMK__UNIT_TEST(NULL, NULL,
+                cmocka_unit_test(null_args),
+                cmocka_unit_test(not_compressed),
+                cmocka_unit_test(bzip2_round_trip),
+                cmocka_unit_test(output_too_small))
@@ -0,0 +1,210 @@
+/*
+ * Copyright 2026 the Pacemaker project contributors
+ *
+ * The version control history for this file may have further details.
+ *
+ * This source code is licensed under the GNU General Public License version 2
+ * or later (GPLv2+) WITHOUT ANY WARRANTY.
+ */
+
+#include <crm_internal.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <glib.h>
+
+#include <crm/common/unittest_internal.h>
+
+#include "crmcommon_private.h"
+
+static char *dir = NULL;
+static char *path = NULL;
+
+static int
+setup(void **state)
+{
+    dir = g_dir_make_tmp("pcmk__xml_read_test.XXXXXX", NULL);
+    assert_non_null(dir);
+    path = pcmk__assert_asprintf("%s/input.xml.zst", dir);
+    return 0;
+}
+
+static int
+teardown(void **state)
+{
+    unlink(path);
+    rmdir(dir);
+    g_clear_pointer(&path, free);
+    g_clear_pointer(&dir, g_free);
+    return 0;
+}
+
+/*!
+ * \internal
+ * \brief Create XML with a given number of distinct child elements
+ *
+ * \param[in] children  Number of children to create
+ *
+ * \return Newly created XML
+ */
+static xmlNode *
+create_xml(int children)
+{
+    xmlNode *xml = pcmk__xe_create(NULL, PCMK_XE_CIB);
+
+    for (int i = 0; i < children; i++) {
+        xmlNode *child = pcmk__xe_create(xml, PCMK_XE_PRIMITIVE);
+
+        pcmk__xe_set_id(child, "rsc%d", i);
+        pcmk__xe_set_int(child, PCMK_XA_VALUE, (i * 7919) % 10007);
+    }
+    return xml;
+}
+
+static off_t
+file_size(void)
+{
+    struct stat sb;
+
+    assert_int_equal(stat(path, &sb), 0);
+    return sb.st_size;
+}
+
+/*!
+ * \internal
+ * \brief Check that reading the test file gets back the expected XML
+ *
+ * \param[in] xml  Expected XML
+ */
+static void
+assert_file_has(const xmlNode *xml)
+{
+    xmlNode *parsed = pcmk__xml_read(path);
+    GString *expected = g_string_sized_new(1024);
+    GString *actual = g_string_sized_new(1024);
+
+    assert_non_null(parsed);
+
+    pcmk__xml_string(xml, 0, expected, 0);
+    pcmk__xml_string(parsed, 0, actual, 0);
+    assert_string_equal(actual->str, expected->str);
+
+    pcmk__xml_free(parsed);
+    g_string_free(expected, TRUE);
+    g_string_free(actual, TRUE);
+}
+
+/*!
+ * \internal
+ * \brief Write XML compressed to the test file, then check reading it back
+ *
+ * \param[in] xml  XML to write
+ */
+static void
+assert_round_trip(const xmlNode *xml)
+{
+    assert_int_equal(pcmk__xml_write_file(xml, path, true), pcmk_rc_ok);
+    assert_file_has(xml);
+}
+
+/*!
+ * \internal
+ * \brief Pad the test file to a multiple of the read buffer size
+ *
+ * This appends a \c zstd skippable frame, which decompressors must ignore.
+ */
+static void
+pad_to_buffer_size(void)
+{
+    off_t size = file_size();
+    size_t padding = PCMK__BUFFER_SIZE - (size % PCMK__BUFFER_SIZE);
+    uint8_t *frame = NULL;
+    FILE *fp = NULL;
+
+    // A skippable frame is at least 8 bytes (magic number and length)
+    if (padding < 8) {
+        padding += PCMK__BUFFER_SIZE;
+    }
+
+    frame = pcmk__assert_alloc(padding, sizeof(uint8_t));
+    frame[0] = 0x50;
+    frame[1] = 0x2A;
+    frame[2] = 0x4D;
+    frame[3] = 0x18;
+    frame[4] = (padding - 8) & 0xFF;
+    frame[5] = ((padding - 8) >> 8) & 0xFF;
+
+    fp = fopen(path, "a");
+    assert_non_null(fp);
+    assert_int_equal(fwrite(frame, sizeof(uint8_t), padding, fp), padding);
+    fclose(fp);
+    free(frame);
+
+    assert_int_equal(file_size() % PCMK__BUFFER_SIZE, 0);
+}
+
+static void
+zstd_round_trip(void **state)
+{
+    xmlNode *xml = NULL;
+
+    if (!HAVE_ZSTD) {
+        skip();
+    }
+
+    xml = create_xml(1);
+    assert_round_trip(xml);
+    pcmk__xml_free(xml);
+
+    // Larger than the read buffer
+    xml = create_xml(2000);
+    assert_round_trip(xml);
+    assert_true(file_size() > PCMK__BUFFER_SIZE);
+    pcmk__xml_free(xml);
+}
+
+static void
+zstd_size_multiple_of_buffer(void **state)
+{
+    if (!HAVE_ZSTD) {
+        skip();
+    }
+
+    // Files of one buffer and of several buffers
+    for (int children = 1; children <= 2000; children *= 40) {
+        xmlNode *xml = create_xml(children);
+
+        assert_round_trip(xml);
+        pad_to_buffer_size();
+        assert_file_has(xml);
+        pcmk__xml_free(xml);
+    }
+}
+
+static void
+zstd_truncated(void **state)
+{
+    xmlNode *xml = NULL;
+
+    if (!HAVE_ZSTD) {
+        skip();
+    }
+
+    xml = create_xml(2000);
+    assert_round_trip(xml);
+    pcmk__xml_free(xml);
+
+    assert_int_equal(truncate(path, file_size() - 1), 0);
+    assert_null(pcmk__xml_read(path));
+}
+
+PCMK__UNIT_TEST(pcmk__xml_test_setup_group, pcmk__xml_test_teardown_group,
+                cmocka_unit_test_setup_teardown(zstd_round_trip, setup,
+                                                teardown),
+                cmocka_unit_test_setup_teardown(zstd_size_multiple_of_buffer,
+                                                setup, teardown),
+                cmocka_unit_test_setup_teardown(zstd_truncated, setup,
+                                                teardown))
@@ -56,6 +56,7 @@ pcmk_common_cleanup(void)
     // @TODO This isn't really everything, move all cleanup here
     mainloop_cleanup();
     pcmk__schema_cleanup();
+    pcmk__acl_cleanup();
     crm_log_deinit();
 
     // Clean up external library global state
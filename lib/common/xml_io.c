@@ -9,6 +9,7 @@
 
 #include <crm_internal.h>
 
+#include <limits.h>                     // UINT_MAX
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -21,6 +22,10 @@
 #include <libxml/xmlIO.h>               // xmlOutputBuffer*
 #include <libxml/xmlstring.h>           // xmlChar
 
+#if HAVE_ZSTD
+#include <zstd.h>
+#endif
+
 #include <crm/crm.h>
 #include <crm/common/xml.h>
 #include <crm/common/xml_io.h>
@@ -38,7 +43,7 @@
  * \note The caller is responsible for freeing the return value using \c free().
  */
 static char *
-decompress_file(const char *filename)
+decompress_bzip2_file(const char *filename)
 {
     char *buffer = NULL;
     int rc = pcmk_rc_ok;
@@ -89,13 +94,178 @@ done:
     return buffer;
 }
 
+#if HAVE_ZSTD
+/*!
+ * \internal
+ * \brief Decompress a <tt>zstd</tt>-compressed file into a string buffer
+ *
+ * \param[in] filename  Name of file to decompress
+ *
+ * \return Newly allocated string with the decompressed contents of \p filename,
+ *         or \c NULL on error.
+ *
+ * \note The caller is responsible for freeing the return value using \c free().
+ */
+static char *
+decompress_zstd_file(const char *filename)
+{
+    char *buffer = NULL;
+    char *input = NULL;
+    size_t length = 0;
+    size_t read_len = 0;
+    bool frame_done = false;
+    ZSTD_DStream *zstream = NULL;
+    ZSTD_inBuffer in = { NULL, 0, 0 };
+    FILE *stream = fopen(filename, "r");
+
+    if (stream == NULL) {
+        pcmk__err("Could not open %s for reading: %s", filename,
+                  strerror(errno));
+        return NULL;
+    }
+
+    zstream = ZSTD_createDStream();
+    if (zstream == NULL) {
+        pcmk__err("Could not prepare to read compressed %s", filename);
+        goto done;
+    }
+
+    input = pcmk__assert_alloc(PCMK__BUFFER_SIZE, sizeof(char));
+    in.src = input;
+
+    /* Frames written by other tools (such as the zstd command-line tool reading
+     * from a pipe) may not record the content size, so decompress as a stream
+     * rather than sizing the output from the frame header.
+     *
+     * The file has been read successfully once all of it has been consumed and
+     * the last frame is complete and fully flushed. The end of the file may not
+     * be detected until a read after the last frame was completed (for example,
+     * if the file's size is a multiple of the buffer size), so remember
+     * whether the last call completed a frame rather than calling the
+     * decompressor again with no input.
+     */
+    while (true) {
+        ZSTD_outBuffer out = { NULL, PCMK__BUFFER_SIZE, 0 };
+        size_t zrc = 0;
+
+        if ((in.pos == in.size) && !feof(stream)) {
+            read_len = fread(input, sizeof(char), PCMK__BUFFER_SIZE, stream);
+            if (ferror(stream)) {
+                pcmk__err("Could not read compressed %s: %s", filename,
+                          strerror(errno));
+                g_clear_pointer(&buffer, free);
+                goto done;
+            }
+            in.size = read_len;
+            in.pos = 0;
+        }
+
+        if ((in.pos == in.size) && feof(stream) && frame_done) {
+            break;
+        }
+
+        buffer = pcmk__realloc(buffer, length + PCMK__BUFFER_SIZE + 1);
+        out.dst = buffer + length;
+
+        zrc = ZSTD_decompressStream(zstream, &out, &in);
+        if (ZSTD_isError(zrc)) {
+            pcmk__err("Could not read compressed %s: %s", filename,
+                      ZSTD_getErrorName(zrc));
+            g_clear_pointer(&buffer, free);
+            goto done;
+        }
+        length += out.pos;
+        frame_done = (zrc == 0);
+
+        /* With no input left, a call that didn't complete a frame and didn't
+         * fill the output buffer means the last frame is incomplete
+         */
+        if ((in.pos == in.size) && feof(stream) && !frame_done
+            && (out.pos < out.size)) {
+            pcmk__err("Could not read compressed %s: file is truncated",
+                      filename);
+            g_clear_pointer(&buffer, free);
+            goto done;
+        }
+    }
+
+    pcmk__trace("Read %zu bytes from file", length);
+    buffer[length] = '\0';
+
+done:
+    free(input);
+    ZSTD_freeDStream(zstream);
+    fclose(stream);
+    return buffer;
+}
+#endif // HAVE_ZSTD
+
+/*!
+ * \internal
+ * \brief Decompress a file into a string buffer
+ *
+ * \param[in] filename  Name of file to decompress
+ * \param[in] codec     Compression format of \p filename
+ *
+ * \return Newly allocated string with the decompressed contents of \p filename,
+ *         or \c NULL on error.
+ *
+ * \note The caller is responsible for freeing the return value using \c free().
+ */
+static char *
+decompress_file(const char *filename, enum pcmk__compression codec)
+{
+    switch (codec) {
+        case pcmk__compression_bzip2:
+            return decompress_bzip2_file(filename);
+
+        case pcmk__compression_zstd:
+#if HAVE_ZSTD
+            return decompress_zstd_file(filename);
+#else
+            pcmk__err("Could not read %s: this build does not support zstd "
+                      "compression", filename);
+            return NULL;
+#endif
+
+        default:
+            return NULL;
+    }
+}
+
+/*!
+ * \internal
+ * \brief Detect the compression format of a file from its contents
+ *
+ * \param[in] filename  Name of file to check
+ *
+ * \return Compression format of \p filename (\c pcmk__compression_none if it
+ *         is not compressed in a recognized format or can't be read)
+ */
+static enum pcmk__compression
+detect_file_compression(const char *filename)
+{
+    unsigned char magic[4] = { 0, };
+    size_t length = 0;
+    FILE *input = fopen(filename, "r");
+
+    if (input == NULL) {
+        // Let the caller's attempt to parse the file report the error
+        return pcmk__compression_none;
+    }
+    length = fread(magic, sizeof(unsigned char), sizeof(magic), input);
+    fclose(input);
+    return pcmk__compression_detect(magic, length);
+}
+
 /*!
  * \internal
  * \brief Parse XML from a file
  *
  * \param[in] filename  Name of file containing XML (\c NULL or \c "-" for
- *                      \c stdin); if \p filename ends in \c ".bz2", the file
- *                      will be decompressed using \c bzip2
+ *                      \c stdin); if the file is compressed using \c bzip2 or
+ *                      \c zstd, it will be decompressed (the format is
+ *                      detected from the contents, not the file name)
  *
  * \return XML tree parsed from the given file on success, otherwise \c NULL
  */
@@ -119,17 +289,21 @@ pcmk__xml_read(const char *filename)
         output = xmlCtxtReadFd(ctxt, STDIN_FILENO, NULL, NULL,
                                XML_PARSE_NOBLANKS);
 
-    } else if (g_str_has_suffix(filename, ".bz2")) {
-        char *input = decompress_file(filename);
+    } else {
+        enum pcmk__compression codec = detect_file_compression(filename);
 
-        if (input != NULL) {
-            output = xmlCtxtReadDoc(ctxt, (const xmlChar *) input, NULL, NULL,
-                                    XML_PARSE_NOBLANKS);
-            free(input);
-        }
+        if (codec == pcmk__compression_none) {
+            output = xmlCtxtReadFile(ctxt, filename, NULL, XML_PARSE_NOBLANKS);
 
-    } else {
-        output = xmlCtxtReadFile(ctxt, filename, NULL, XML_PARSE_NOBLANKS);
+        } else {
+            char *input = decompress_file(filename, codec);
+
+            if (input != NULL) {
+                output = xmlCtxtReadDoc(ctxt, (const xmlChar *) input, NULL,
+                                        NULL, XML_PARSE_NOBLANKS);
+                free(input);
+            }
+        }
     }
 
     if (output != NULL) {
@@ -222,18 +396,23 @@ dump_xa_if_not_filterable(const xmlAttr *attr, void *user_data)
     return true;
 }
 
+static void dump_xml(const xmlNode *data, uint32_t options, GString *buffer,
+                     int depth, pcmk__xml_flush_fn flush, void *user_data);
+
 /*!
  * \internal
  * \brief Append a string representation of an XML element to a buffer
  *
- * \param[in]     data     XML whose representation to append
- * \param[in]     options  Group of \p pcmk__xml_fmt_options flags
- * \param[in,out] buffer   Where to append the content (must not be \p NULL)
- * \param[in]     depth    Current indentation level
+ * \param[in]     data       XML whose representation to append
+ * \param[in]     options    Group of \p pcmk__xml_fmt_options flags
+ * \param[in,out] buffer     Where to append the content (must not be \p NULL)
+ * \param[in]     depth      Current indentation level
+ * \param[in]     flush      If not \c NULL, call this after each child
+ * \param[in,out] user_data  Argument for \p flush
  */
 static void
 dump_xml_element(const xmlNode *data, uint32_t options, GString *buffer,
-                 int depth)
+                 int depth, pcmk__xml_flush_fn flush, void *user_data)
 {
     const bool pretty = pcmk__is_set(options, pcmk__xml_fmt_pretty);
     const bool filtered = pcmk__is_set(options, pcmk__xml_fmt_filtered);
@@ -266,7 +445,10 @@ dump_xml_element(const xmlNode *data, uint32_t options, GString *buffer,
     if (data->children) {
         for (const xmlNode *child = data->children; child != NULL;
              child = child->next) {
-            pcmk__xml_string(child, options, buffer, depth + 1);
+            dump_xml(child, options, buffer, depth + 1, flush, user_data);
+            if (flush != NULL) {
+                flush(buffer, user_data);
+            }
         }
 
         for (int lpc = 0; lpc < spaces; lpc++) {
@@ -366,6 +548,44 @@ dump_xml_comment(const xmlNode *data, uint32_t options, GString *buffer,
     }
 }
 
+/*!
+ * \internal
+ * \brief Append a string representation of an XML object to a buffer
+ *
+ * \param[in]     data       XML to convert
+ * \param[in]     options    Group of \p pcmk__xml_fmt_options flags
+ * \param[in,out] buffer     Where to append the text (must not be \p NULL)
+ * \param[in]     depth      Current indentation level
+ * \param[in]     flush      If not \c NULL, call this after each child of an
+ *                           element has been appended
+ * \param[in,out] user_data  Argument for \p flush
+ */
+static void
+dump_xml(const xmlNode *data, uint32_t options, GString *buffer, int depth,
+         pcmk__xml_flush_fn flush, void *user_data)
+{
+    switch(data->type) {
+        case XML_ELEMENT_NODE:
+            dump_xml_element(data, options, buffer, depth, flush, user_data);
+            break;
+        case XML_TEXT_NODE:
+            if (pcmk__is_set(options, pcmk__xml_fmt_text)) {
+                dump_xml_text(data, options, buffer, depth);
+            }
+            break;
+        case XML_COMMENT_NODE:
+            dump_xml_comment(data, options, buffer, depth);
+            break;
+        case XML_CDATA_SECTION_NODE:
+            dump_xml_cdata(data, options, buffer, depth);
+            break;
+        default:
+            pcmk__warn("Cannot convert XML %s node to text " QB_XS " type=%d",
+                       pcmk__xml_element_type_text(data->type), data->type);
+            break;
+    }
+}
+
 /*!
  * \internal
  * \brief Create a string representation of an XML object
@@ -393,27 +613,41 @@ pcmk__xml_string(const xmlNode *data, uint32_t options, GString *buffer,
     pcmk__assert(buffer != NULL);
     CRM_CHECK(depth >= 0, depth = 0);
 
-    switch(data->type) {
-        case XML_ELEMENT_NODE:
-            /* Handle below */
-            dump_xml_element(data, options, buffer, depth);
-            break;
-        case XML_TEXT_NODE:
-            if (pcmk__is_set(options, pcmk__xml_fmt_text)) {
-                dump_xml_text(data, options, buffer, depth);
-            }
-            break;
-        case XML_COMMENT_NODE:
-            dump_xml_comment(data, options, buffer, depth);
-            break;
-        case XML_CDATA_SECTION_NODE:
-            dump_xml_cdata(data, options, buffer, depth);
-            break;
-        default:
-            pcmk__warn("Cannot convert XML %s node to text " QB_XS " type=%d",
-                       pcmk__xml_element_type_text(data->type), data->type);
-            break;
+    dump_xml(data, options, buffer, depth, NULL, NULL);
+}
+
+/*!
+ * \internal
+ * \brief Serialize XML in pieces, passing each piece to a callback
+ *
+ * This produces exactly the same text as \c pcmk__xml_string(), but \p flush
+ * is called after each child of each element has been appended to
+ * \p buffer. \p flush may consume and truncate the buffer, so that large XML
+ * can be processed (for example, hashed) without ever holding its full text.
+ *
+ * \param[in]     data       XML to convert
+ * \param[in]     options    Group of \p pcmk__xml_fmt_options flags
+ * \param[in,out] buffer     Where to append the text (must not be \p NULL)
+ * \param[in]     flush      Called with \p buffer and \p user_data after each
+ *                           child (must not be \c NULL)
+ * \param[in,out] user_data  Argument for \p flush
+ *
+ * \note \p flush is not called for the end of \p data itself, so the caller
+ *       must handle any text left in \p buffer afterward.
+ */
+void
+pcmk__xml_string_chunked(const xmlNode *data, uint32_t options,
+                         GString *buffer, pcmk__xml_flush_fn flush,
+                         void *user_data)
+{
+    if (data == NULL) {
+        pcmk__trace("Nothing to dump");
+        return;
     }
+
+    pcmk__assert((buffer != NULL) && (flush != NULL));
+
+    dump_xml(data, options, buffer, 0, flush, user_data);
 }
 
 /*!
@@ -428,8 +662,8 @@ pcmk__xml_string(const xmlNode *data, uint32_t options, GString *buffer,
  * \return Standard Pacemaker return code
  */
 static int
-write_compressed_stream(char *text, const char *filename, FILE *stream,
-                        unsigned int *bytes_out)
+write_bzip2_stream(char *text, const char *filename, FILE *stream,
+                   unsigned int *bytes_out)
 {
     unsigned int bytes_in = 0;
     int rc = pcmk_rc_ok;
@@ -474,6 +708,94 @@ done:
     return rc;
 }
 
+#if HAVE_ZSTD
+/*!
+ * \internal
+ * \brief Write a string to a file stream, compressed using \c zstd
+ *
+ * \param[in]     text       String to write
+ * \param[in]     filename   Name of file being written (for logging only)
+ * \param[in,out] stream     Open file stream to write to
+ * \param[out]    bytes_out  Number of bytes written (valid only on success)
+ *
+ * \return Standard Pacemaker return code
+ */
+static int
+write_zstd_stream(const char *text, const char *filename, FILE *stream,
+                  unsigned int *bytes_out)
+{
+    size_t bytes_in = strlen(text);
+    size_t max = ZSTD_compressBound(bytes_in);
+    char *compressed = pcmk__assert_alloc(max, sizeof(char));
+    int rc = pcmk_rc_ok;
+
+    // Level 3 is zstd's default, which is both faster and smaller than bzip2
+    size_t zrc = ZSTD_compress(compressed, max, text, bytes_in, 3);
+
+    if (ZSTD_isError(zrc)) {
+        rc = pcmk_rc_compression;
+        pcmk__warn("Not compressing %s: could not compress data: %s",
+                   filename, ZSTD_getErrorName(zrc));
+        goto done;
+    }
+    if (zrc > UINT_MAX) {
+        rc = EFBIG;
+        pcmk__warn("Not compressing %s: compressed size %zu is too large",
+                   filename, zrc);
+        goto done;
+    }
+
+    if (fwrite(compressed, sizeof(char), zrc, stream) != zrc) {
+        rc = errno;
+        pcmk__warn("Not compressing %s: could not write compressed data: %s",
+                   filename, strerror(rc));
+        goto done;
+    }
+
+    *bytes_out = (unsigned int) zrc;
+    pcmk__trace("Compressed XML for %s from %zu bytes to %zu", filename,
+                bytes_in, zrc);
+
+done:
+    free(compressed);
+    return rc;
+}
+#endif // HAVE_ZSTD
+
+/*!
+ * \internal
+ * \brief Write a string to a file stream, compressed
+ *
+ * \param[in]     text       String to write
+ * \param[in]     filename   Name of file being written (for logging only)
+ * \param[in,out] stream     Open file stream to write to
+ * \param[in]     codec      Compression format to use
+ * \param[out]    bytes_out  Number of bytes written (valid only on success)
+ *
+ * \return Standard Pacemaker return code
+ */
+static int
+write_compressed_stream(char *text, const char *filename, FILE *stream,
+                        enum pcmk__compression codec, unsigned int *bytes_out)
+{
+    switch (codec) {
+        case pcmk__compression_bzip2:
+            return write_bzip2_stream(text, filename, stream, bytes_out);
+
+        case pcmk__compression_zstd:
+#if HAVE_ZSTD
+            return write_zstd_stream(text, filename, stream, bytes_out);
+#else
+            pcmk__warn("Not compressing %s: this build does not support zstd "
+                       "compression", filename);
+            return ENOTSUP;
+#endif
+
+        default:
+            return EINVAL;
+    }
+}
+
 /*!
  * \internal
  * \brief Write XML to a file stream
@@ -482,13 +804,13 @@ done:
  * \param[in]     filename  Name of file being written (for logging only)
  * \param[in,out] stream    Open file stream corresponding to filename (closed
  *                          when this function returns)
- * \param[in]     compress  Whether to compress XML before writing
+ * \param[in]     codec     Compression format to use
  *
  * \return Standard Pacemaker return code
  */
 static int
 write_xml_stream(const xmlNode *xml, const char *filename, FILE *stream,
-                 bool compress)
+                 enum pcmk__compression codec)
 {
     GString *buffer = g_string_sized_new(1024);
     unsigned int bytes_out = 0;
@@ -502,8 +824,8 @@ write_xml_stream(const xmlNode *xml, const char *filename, FILE *stream,
 
     pcmk__log_xml_trace(xml, "writing");
 
-    if (compress
-        && (write_compressed_stream(buffer->str, filename, stream,
+    if ((codec != pcmk__compression_none)
+        && (write_compressed_stream(buffer->str, filename, stream, codec,
                                     &bytes_out) == pcmk_rc_ok)) {
         goto done;
     }
@@ -558,7 +880,7 @@ pcmk__xml_write_fd(const xmlNode *xml, const char *filename, int fd)
     }
 
     return write_xml_stream(xml, pcmk__s(filename, "unnamed file"), stream,
-                            false);
+                            pcmk__compression_none);
 }
 
 /*!
@@ -567,7 +889,9 @@ pcmk__xml_write_fd(const xmlNode *xml, const char *filename, int fd)
  *
  * \param[in]  xml       XML to write
  * \param[in]  filename  Name of file to write
- * \param[in]  compress  If \c true, compress XML before writing
+ * \param[in]  compress  If \c true, compress XML before writing (using the
+ *                       format implied by the extension of \p filename if
+ *                       any, otherwise the configured format)
  *
  * \return Standard Pacemaker return code
  */
@@ -575,6 +899,7 @@ int
 pcmk__xml_write_file(const xmlNode *xml, const char *filename, bool compress)
 {
     FILE *stream = NULL;
+    enum pcmk__compression codec = pcmk__compression_none;
 
     CRM_CHECK((xml != NULL) && (filename != NULL), return EINVAL);
     stream = fopen(filename, "w");
@@ -582,7 +907,13 @@ pcmk__xml_write_file(const xmlNode *xml, const char *filename, bool compress)
         return errno;
     }
 
-    return write_xml_stream(xml, filename, stream, compress);
+    if (compress) {
+        codec = pcmk__compression_from_filename(filename);
+        if (codec == pcmk__compression_none) {
+            codec = pcmk__compression_configured();
+        }
+    }
+    return write_xml_stream(xml, filename, stream, codec);
 }
 
 /*!
@@ -69,6 +69,8 @@ void
 pcmk__free_graph(pcmk__graph_t *graph)
 {
     if (graph != NULL) {
+        g_clear_pointer(&graph->dependents, g_hash_table_destroy);
+        g_clear_pointer(&graph->ready, g_sequence_free);
         g_list_free_full(graph->synapses, free_graph_synapse);
         free(graph->source);
         free(graph->failed_stop_offset);
@@ -84,48 +86,59 @@ pcmk__free_graph(pcmk__graph_t *graph)
 
 /*!
  * \internal
- * \brief Update synapse after completed prerequisite
+ * \brief Compare two synapses by their position in a transition graph
  *
- * A synapse is ready to be executed once all its prerequisite actions (inputs)
- * complete. Given a completed action, check whether it is an input for a given
- * synapse, and if so, mark the input as confirmed, and mark the synapse as
- * ready if appropriate.
+ * \param[in] a          First synapse to compare
+ * \param[in] b          Second synapse to compare
+ * \param[in] user_data  Ignored
  *
- * \param[in,out] synapse    Transition graph synapse to update
- * \param[in]     action_id  ID of an action that completed
+ * \return Negative, zero, or positive integer if \p a comes before, at the
+ *         same position as, or after \p b, respectively
+ */
+static gint
+compare_synapse_position(gconstpointer a, gconstpointer b, gpointer user_data)
+{
+    const pcmk__graph_synapse_t *synapse_a = a;
+    const pcmk__graph_synapse_t *synapse_b = b;
+
+    return synapse_a->position - synapse_b->position;
+}
+
+/*!
+ * \internal
+ * \brief Confirm a synapse input after its action completed
  *
- * \note The only substantial effect here is confirming synapse inputs.
- *       should_fire_synapse() will recalculate pcmk__synapse_ready, so the only
- *       thing that uses the pcmk__synapse_ready from here is
- *       synapse_state_str().
+ * A synapse is ready to be executed once all its prerequisite actions (inputs)
+ * complete. Mark a given input as confirmed, and if it was the synapse's last
+ * pending input, mark the synapse as ready and add it to the graph's ready
+ * queue.
+ *
+ * \param[in,out] graph  Transition graph that input's synapse is part of
+ * \param[in,out] input  Synapse input whose action completed
  */
 static void
-update_synapse_ready(pcmk__graph_synapse_t *synapse, int action_id)
+confirm_input(pcmk__graph_t *graph, pcmk__graph_action_t *input)
 {
-    if (pcmk__is_set(synapse->flags, pcmk__synapse_ready)) {
-        return; // All inputs have already been confirmed
-    }
+    pcmk__graph_synapse_t *synapse = input->synapse;
 
-    // Presume ready until proven otherwise
-    pcmk__set_synapse_flags(synapse, pcmk__synapse_ready);
+    if (pcmk__is_set(input->flags, pcmk__graph_action_confirmed)) {
+        return;
+    }
 
-    for (GList *lpc = synapse->inputs; lpc != NULL; lpc = lpc->next) {
-        pcmk__graph_action_t *prereq = (pcmk__graph_action_t *) lpc->data;
+    pcmk__trace("Confirming input %d of synapse %d", input->id, synapse->id);
+    pcmk__set_graph_action_flags(input, pcmk__graph_action_confirmed);
 
-        if (prereq->id == action_id) {
-            pcmk__trace("Confirming input %d of synapse %d", action_id,
-                        synapse->id);
-            pcmk__set_graph_action_flags(prereq, pcmk__graph_action_confirmed);
-
-        } else if (!pcmk__is_set(prereq->flags, pcmk__graph_action_confirmed)) {
-            pcmk__clear_synapse_flags(synapse, pcmk__synapse_ready);
-            pcmk__trace("Synapse %d still not ready after action %d",
-                        synapse->id, action_id);
-        }
-    }
-    if (pcmk__is_set(synapse->flags, pcmk__synapse_ready)) {
-        pcmk__trace("Synapse %d is now ready to execute", synapse->id);
+    if (--synapse->pending_inputs > 0) {
+        pcmk__trace("Synapse %d still not ready after action %d "
+                    "(%d inputs pending)",
+                    synapse->id, input->id, synapse->pending_inputs);
+        return;
     }
+
+    pcmk__trace("Synapse %d is now ready to execute", synapse->id);
+    pcmk__set_synapse_flags(synapse, pcmk__synapse_ready);
+    g_sequence_insert_sorted(graph->ready, synapse, compare_synapse_position,
+                             NULL);
 }
 
 /*!
@@ -170,23 +183,40 @@ update_synapse_confirmed(pcmk__graph_synapse_t *synapse, int action_id)
  *
  * \param[in,out] graph   Transition graph to update
  * \param[in]     action  Action that completed
+ *
+ * \note This looks only at the action's own synapse and at the synapses that
+ *       have the action as an input, so its cost does not depend on the size
+ *       of the graph.
  */
 void
 pcmk__update_graph(pcmk__graph_t *graph, const pcmk__graph_action_t *action)
 {
-    for (GList *lpc = graph->synapses; lpc != NULL; lpc = lpc->next) {
-        pcmk__graph_synapse_t *synapse = (pcmk__graph_synapse_t *) lpc->data;
+    pcmk__graph_synapse_t *synapse = action->synapse;
+    GList *inputs = g_hash_table_lookup(graph->dependents,
+                                        GINT_TO_POINTER(action->id));
 
-        if (pcmk__any_flags_set(synapse->flags,
-                                pcmk__synapse_confirmed|pcmk__synapse_failed)) {
-            continue; // This synapse already completed
+    if ((synapse != NULL)
+        && !pcmk__any_flags_set(synapse->flags,
+                                pcmk__synapse_confirmed|pcmk__synapse_failed)
+        && pcmk__is_set(synapse->flags, pcmk__synapse_executed)) {
 
-        } else if (pcmk__is_set(synapse->flags, pcmk__synapse_executed)) {
-            update_synapse_confirmed(synapse, action->id);
+        update_synapse_confirmed(synapse, action->id);
+    }
+
+    for (GList *iter = inputs; iter != NULL; iter = iter->next) {
+        pcmk__graph_action_t *input = iter->data;
+
+        synapse = input->synapse;
+
+        if (pcmk__any_flags_set(synapse->flags,
+                                pcmk__synapse_confirmed
+                                |pcmk__synapse_failed
+                                |pcmk__synapse_executed)) {
+            continue; // This synapse already completed or started
 
         } else if (!pcmk__is_set(action->flags, pcmk__graph_action_failed)
                    || (synapse->priority == PCMK_SCORE_INFINITY)) {
-            update_synapse_ready(synapse, action->id);
+            confirm_input(graph, input);
         }
     }
 }
@@ -230,32 +260,17 @@ pcmk__set_graph_functions(pcmk__graph_functions_t *fns)
 static bool
 should_fire_synapse(pcmk__graph_t *graph, pcmk__graph_synapse_t *synapse)
 {
-    GList *lpc = NULL;
-
-    pcmk__set_synapse_flags(synapse, pcmk__synapse_ready);
-    for (lpc = synapse->inputs; lpc != NULL; lpc = lpc->next) {
-        pcmk__graph_action_t *prereq = (pcmk__graph_action_t *) lpc->data;
-
-        if (!(pcmk__is_set(prereq->flags, pcmk__graph_action_confirmed))) {
-            pcmk__trace("Input %d for synapse %d not yet confirmed", prereq->id,
-                        synapse->id);
-            pcmk__clear_synapse_flags(synapse, pcmk__synapse_ready);
-            break;
-
-        } else if (pcmk__is_set(prereq->flags, pcmk__graph_action_failed)) {
-            pcmk__trace("Input %d for synapse %d confirmed but failed",
-                        prereq->id, synapse->id);
-            pcmk__clear_synapse_flags(synapse, pcmk__synapse_ready);
-            break;
-        }
-    }
-    if (pcmk__is_set(synapse->flags, pcmk__synapse_ready)) {
-        pcmk__trace("Synapse %d is ready to execute", synapse->id);
-    } else {
+    if (synapse->pending_inputs > 0) {
+        pcmk__trace("Synapse %d has %d inputs not yet confirmed", synapse->id,
+                    synapse->pending_inputs);
+        pcmk__clear_synapse_flags(synapse, pcmk__synapse_ready);
         return false;
     }
 
-    for (lpc = synapse->actions; lpc != NULL; lpc = lpc->next) {
+    pcmk__set_synapse_flags(synapse, pcmk__synapse_ready);
+    pcmk__trace("Synapse %d is ready to execute", synapse->id);
+
+    for (GList *lpc = synapse->actions; lpc != NULL; lpc = lpc->next) {
         pcmk__graph_action_t *a = (pcmk__graph_action_t *) lpc->data;
 
         if (a->type == pcmk__pseudo_graph_action) {
@@ -413,6 +428,8 @@ enum pcmk__graph_status
 pcmk__execute_graph(pcmk__graph_t *graph)
 {
     GList *lpc = NULL;
+    GSequenceIter *iter = NULL;
+    int waiting = 0;
     int log_level = LOG_DEBUG;
     enum pcmk__graph_status pass_result = pcmk__graph_active;
     const char *status = "In progress";
@@ -430,25 +447,35 @@ pcmk__execute_graph(pcmk__graph_t *graph)
     graph->completed = 0;
     graph->incomplete = 0;
 
-    // Count completed and in-flight synapses
+    // Count completed, in-flight, failed, and not yet executed synapses
     for (lpc = graph->synapses; lpc != NULL; lpc = lpc->next) {
         pcmk__graph_synapse_t *synapse = (pcmk__graph_synapse_t *) lpc->data;
 
         if (pcmk__is_set(synapse->flags, pcmk__synapse_confirmed)) {
             graph->completed++;
 
-        } else if (!pcmk__is_set(synapse->flags, pcmk__synapse_failed)
-                   && pcmk__is_set(synapse->flags, pcmk__synapse_executed)) {
+        } else if (pcmk__is_set(synapse->flags, pcmk__synapse_failed)) {
+            graph->skipped++;
+
+        } else if (pcmk__is_set(synapse->flags, pcmk__synapse_executed)) {
             graph->pending++;
+
+        } else {
+            waiting++;
         }
     }
     pcmk__trace("Executing graph %d (%d synapses already completed, %d "
                 "pending)",
                 graph->id, graph->completed, graph->pending);
 
-    // Execute any synapses that are ready
-    for (lpc = graph->synapses; lpc != NULL; lpc = lpc->next) {
-        pcmk__graph_synapse_t *synapse = (pcmk__graph_synapse_t *) lpc->data;
+    /* Execute any synapses that are ready, in graph order. Synapses whose
+     * inputs were all confirmed are queued by pcmk__update_graph(), so there is
+     * no need to look at the others.
+     */
+    iter = g_sequence_get_begin_iter(graph->ready);
+
+    while (!g_sequence_iter_is_end(iter)) {
+        pcmk__graph_synapse_t *synapse = g_sequence_get(iter);
 
         if ((graph->batch_limit > 0)
             && (graph->pending >= graph->batch_limit)) {
@@ -457,35 +484,50 @@ pcmk__execute_graph(pcmk__graph_t *graph)
                         graph->batch_limit);
             break;
 
-        } else if (pcmk__is_set(synapse->flags, pcmk__synapse_failed)) {
-            graph->skipped++;
-            continue;
-
         } else if (pcmk__any_flags_set(synapse->flags,
                                        pcmk__synapse_confirmed
+                                       |pcmk__synapse_failed
                                        |pcmk__synapse_executed)) {
-            continue; // Already handled
-
-        } else if (should_fire_synapse(graph, synapse)) {
-            graph->fired++;
-            if (fire_synapse(graph, synapse) != pcmk_rc_ok) {
-                pcmk__err("Synapse %d failed to fire", synapse->id);
-                log_level = LOG_ERR;
-                graph->abort_priority = PCMK_SCORE_INFINITY;
-                graph->incomplete++;
-                graph->fired--;
-            }
+            // Already handled (and counted above), so stop tracking it
+            GSequenceIter *next = g_sequence_iter_next(iter);
 
-            if (!(pcmk__is_set(synapse->flags, pcmk__synapse_confirmed))) {
-                graph->pending++;
-            }
+            g_sequence_remove(iter);
+            iter = next;
+            continue;
 
-        } else {
+        } else if (!should_fire_synapse(graph, synapse)) {
             pcmk__trace("Synapse %d cannot fire", synapse->id);
-            graph->incomplete++;
+            iter = g_sequence_iter_next(iter);
+            continue;
         }
+
+        g_sequence_remove(iter);
+        graph->fired++;
+        if (fire_synapse(graph, synapse) != pcmk_rc_ok) {
+            pcmk__err("Synapse %d failed to fire", synapse->id);
+            log_level = LOG_ERR;
+            graph->abort_priority = PCMK_SCORE_INFINITY;
+            graph->fired--;
+        }
+
+        if (!(pcmk__is_set(synapse->flags, pcmk__synapse_confirmed))) {
+            graph->pending++;
+        }
+
+        /* Firing may have completed actions immediately (for example,
+         * pseudo-actions), making more synapses ready. Continue with the ones
+         * after this synapse. Any before it will be tried in the next pass.
+         */
+        iter = g_sequence_search(graph->ready, synapse,
+                                 compare_synapse_position, NULL);
     }
 
+    /* Any synapse that wasn't executed before this pass and wasn't fired during
+     * it is incomplete (including those that failed to fire, and those skipped
+     * because of the abort priority, which also count as skipped)
+     */
+    graph->incomplete = waiting - graph->fired;
+
     if ((graph->pending == 0) && (graph->fired == 0)) {
         graph->complete = true;
 
@@ -606,6 +648,24 @@ unpack_action(pcmk__graph_synapse_t *parent, xmlNode *xml_action)
     return action;
 }
 
+/*!
+ * \internal
+ * \brief Index a synapse input by the ID of the action it waits for
+ *
+ * \param[in,out] graph  Transition graph that input's synapse is part of
+ * \param[in]     input  Synapse input to index
+ */
+static void
+index_input(pcmk__graph_t *graph, pcmk__graph_action_t *input)
+{
+    gpointer key = GINT_TO_POINTER(input->id);
+    GList *inputs = g_hash_table_lookup(graph->dependents, key);
+
+    // Steal the old list so that replacing it doesn't free it
+    g_hash_table_steal(graph->dependents, key);
+    g_hash_table_insert(graph->dependents, key, g_list_prepend(inputs, input));
+}
+
 /*!
  * \internal
  * \brief Unpack transition graph synapse from XML
@@ -637,7 +697,7 @@ unpack_synapse(pcmk__graph_t *new_graph, const xmlNode *xml_synapse)
     CRM_CHECK(new_synapse->id >= 0,
               free_graph_synapse((void *) new_synapse); return NULL);
 
-    new_graph->num_synapses++;
+    new_synapse->position = new_graph->num_synapses++;
 
     pcmk__trace("Unpacking synapse %s action sets",
                 pcmk__xe_get(xml_synapse, PCMK_XA_ID));
@@ -693,6 +753,8 @@ unpack_synapse(pcmk__graph_t *new_graph, const xmlNode *xml_synapse)
 
                 new_synapse->inputs = g_list_append(new_synapse->inputs,
                                                     new_input);
+                new_synapse->pending_inputs++;
+                index_input(new_graph, new_input);
             }
         }
     }
@@ -742,6 +804,9 @@ pcmk__unpack_graph(const xmlNode *xml_graph, const char *reference)
     }
 
     new_graph->completion_action = pcmk__graph_done;
+    new_graph->dependents = g_hash_table_new_full(NULL, NULL, NULL,
+                                                  (GDestroyNotify) g_list_free);
+    new_graph->ready = g_sequence_new(NULL);
 
     // Parse top-level attributes from PCMK__XE_TRANSITION_GRAPH
     if (xml_graph != NULL) {
@@ -792,11 +857,19 @@ pcmk__unpack_graph(const xmlNode *xml_graph, const char *reference)
         pcmk__graph_synapse_t *new_synapse = unpack_synapse(new_graph,
                                                             synapse_xml);
 
-        if (new_synapse != NULL) {
-            new_graph->synapses = g_list_append(new_graph->synapses,
-                                                new_synapse);
+        if (new_synapse == NULL) {
+            continue;
+        }
+
+        // Prepend for efficiency, then reverse after the loop
+        new_graph->synapses = g_list_prepend(new_graph->synapses, new_synapse);
+
+        // Synapses without inputs are ready immediately
+        if (new_synapse->pending_inputs == 0) {
+            g_sequence_append(new_graph->ready, new_synapse);
         }
     }
+    new_graph->synapses = g_list_reverse(new_graph->synapses);
 
     pcmk__debug("Unpacked transition %d from %s: %d actions in %d synapses",
                 new_graph->id, new_graph->source, new_graph->num_actions,
@@ -762,34 +762,44 @@ should_add_input_to_graph(const pcmk_action_t *action,
 
 /*!
  * \internal
- * \brief Check whether an ordering creates an ordering loop
+ * \brief Check whether an action's input can reach a given action
  *
- * \param[in]     init_action  "First" action in ordering
- * \param[in]     action       Callers should always set this the same as
- *                             \p init_action (this function may use a different
- *                             value for recursive calls)
- * \param[in,out] input        Action wrapper for "then" action in ordering
+ * \param[in]     init_action  Action to look for
+ * \param[in]     action       Action that \p input is an input of
+ * \param[in,out] input        Action wrapper for input to check
+ * \param[in,out] visited      List of actions already checked (each with the
+ *                             \c pcmk__action_detect_loop flag set)
  *
- * \return true if the ordering creates a loop, otherwise false
+ * \return true if \p init_action is \p input or one of its inputs (directly
+ *         or indirectly), otherwise false
  */
-bool
-pcmk__graph_has_loop(const pcmk_action_t *init_action,
-                     const pcmk_action_t *action, pcmk__related_action_t *input)
+static bool
+input_leads_to_action(const pcmk_action_t *init_action,
+                      const pcmk_action_t *action,
+                      pcmk__related_action_t *input, GList **visited)
 {
-    bool has_loop = false;
+    /* Don't need to check inputs that won't be used.
+     *
+     * This may disable the ordering (by clearing input->flags), so it is done
+     * before checking whether input->action was already visited. That way,
+     * every ordering that the search reaches is evaluated (and possibly
+     * disabled), even if its input was already reached by another path.
+     */
+    if (!should_add_input_to_graph(action, input)) {
+        return false;
+    }
 
+    /* An action is flagged once its inputs have been (or are being) checked.
+     * The flag stays set until the whole search is done, so that each action
+     * is checked at most once no matter how many paths lead to it.
+     */
     if (pcmk__is_set(input->action->flags, pcmk__action_detect_loop)) {
-        pcmk__trace("Breaking tracking loop: %s@%s -> %s@%s (%#.6x)",
+        pcmk__trace("Already checked %s@%s (input of %s@%s, %#.6x)",
                     input->action->uuid, pcmk__node_name(input->action->node),
                     action->uuid, pcmk__node_name(action->node), input->flags);
         return false;
     }
 
-    // Don't need to check inputs that won't be used
-    if (!should_add_input_to_graph(action, input)) {
-        return false;
-    }
-
     if (input->action == init_action) {
         pcmk__debug("Input loop found in %s@%s ->...-> %s@%s",
                     action->uuid, pcmk__node_name(action->node),
@@ -798,6 +808,7 @@ pcmk__graph_has_loop(const pcmk_action_t *init_action,
     }
 
     pcmk__set_action_flags(input->action, pcmk__action_detect_loop);
+    *visited = g_list_prepend(*visited, input->action);
 
     pcmk__trace("Checking inputs of action %s@%s input %s@%s (%#.6x) for graph "
                 "loop with %s@%s", action->uuid, pcmk__node_name(action->node),
@@ -805,19 +816,43 @@ pcmk__graph_has_loop(const pcmk_action_t *init_action,
                 input->flags, init_action->uuid,
                 pcmk__node_name(init_action->node));
 
-    // Recursively check input itself for loops
     for (GList *iter = input->action->actions_before;
          iter != NULL; iter = iter->next) {
 
-        if (pcmk__graph_has_loop(init_action, input->action,
-                                 (pcmk__related_action_t *) iter->data)) {
+        if (input_leads_to_action(init_action, input->action,
+                                  (pcmk__related_action_t *) iter->data,
+                                  visited)) {
             // Recursive call already logged a debug message
-            has_loop = true;
-            break;
+            return true;
         }
     }
+    return false;
+}
+
+/*!
+ * \internal
+ * \brief Check whether an ordering creates an ordering loop
+ *
+ * \param[in]     init_action  "First" action in ordering
+ * \param[in]     action       Callers should always set this the same as
+ *                             \p init_action
+ * \param[in,out] input        Action wrapper for "then" action in ordering
+ *
+ * \return true if the ordering creates a loop, otherwise false
+ */
+bool
+pcmk__graph_has_loop(const pcmk_action_t *init_action,
+                     const pcmk_action_t *action, pcmk__related_action_t *input)
+{
+    GList *visited = NULL;
+    bool has_loop = input_leads_to_action(init_action, action, input, &visited);
 
-    pcmk__clear_action_flags(input->action, pcmk__action_detect_loop);
+    for (GList *iter = visited; iter != NULL; iter = iter->next) {
+        pcmk_action_t *checked = iter->data;
+
+        pcmk__clear_action_flags(checked, pcmk__action_detect_loop);
+    }
+    g_list_free(visited);
 
     if (!has_loop) {
         pcmk__trace("No input loop found in %s@%s -> %s@%s (%#.6x)",
@@ -853,25 +853,43 @@ pacemakerd_health_xml(pcmk__output_t *out, va_list args)
     return pcmk_rc_ok;
 }
 
-PCMK__OUTPUT_ARGS("profile", "const char *", "clock_t", "clock_t")
+PCMK__OUTPUT_ARGS("profile", "const char *", "clock_t", "clock_t",
+                  "const pcmk__sched_usage_t *")
 static int
 profile_default(pcmk__output_t *out, va_list args) {
     const char *xml_file = va_arg(args, const char *);
     clock_t start = va_arg(args, clock_t);
     clock_t end = va_arg(args, clock_t);
+    const pcmk__sched_usage_t *usage = va_arg(args,
+                                              const pcmk__sched_usage_t *);
 
     out->list_item(out, NULL, "Testing %s ... %.2f secs", xml_file,
                    (end - start) / (float) CLOCKS_PER_SEC);
 
+    if (usage == NULL) {
+        return pcmk_rc_ok;
+    }
+
+    out->begin_list(out, NULL, NULL, "Phases");
+    for (int phase = 0; phase < pcmk__sched_phase_max; phase++) {
+        out->list_item(out, NULL, "%s: %.3f secs (%.3f secs CPU, "
+                       "peak RSS %ld KiB)",
+                       pcmk__sched_phase_text(phase), usage[phase].wall_s,
+                       usage[phase].cpu_s, usage[phase].max_rss_kb);
+    }
+    out->end_list(out);
     return pcmk_rc_ok;
 }
 
-PCMK__OUTPUT_ARGS("profile", "const char *", "clock_t", "clock_t")
+PCMK__OUTPUT_ARGS("profile", "const char *", "clock_t", "clock_t",
+                  "const pcmk__sched_usage_t *")
 static int
 profile_xml(pcmk__output_t *out, va_list args) {
     const char *xml_file = va_arg(args, const char *);
     clock_t start = va_arg(args, clock_t);
     clock_t end = va_arg(args, clock_t);
+    const pcmk__sched_usage_t *usage = va_arg(args,
+                                              const pcmk__sched_usage_t *);
 
     xmlNode *xml = NULL;
     char *duration = pcmk__ftoa((end - start) / (float) CLOCKS_PER_SEC);
@@ -879,8 +897,27 @@ profile_xml(pcmk__output_t *out, va_list args) {
     xml = pcmk__output_create_xml_node(out, PCMK_XE_TIMING);
     pcmk__xe_set(xml, PCMK_XA_FILE, xml_file);
     pcmk__xe_set(xml, PCMK_XA_DURATION, duration);
-
     free(duration);
+
+    if (usage == NULL) {
+        return pcmk_rc_ok;
+    }
+
+    for (int phase = 0; phase < pcmk__sched_phase_max; phase++) {
+        xmlNode *phase_xml = pcmk__xe_create(xml, PCMK_XE_PHASE);
+
+        pcmk__xe_set(phase_xml, PCMK_XA_NAME, pcmk__sched_phase_text(phase));
+
+        duration = pcmk__ftoa(usage[phase].wall_s);
+        pcmk__xe_set(phase_xml, PCMK_XA_DURATION, duration);
+        free(duration);
+
+        duration = pcmk__ftoa(usage[phase].cpu_s);
+        pcmk__xe_set(phase_xml, PCMK_XA_CPU_DURATION, duration);
+        free(duration);
+
+        pcmk__xe_set_ll(phase_xml, PCMK_XA_MAX_RSS, usage[phase].max_rss_kb);
+    }
     return pcmk_rc_ok;
 }
 
@@ -1259,7 +1296,8 @@ rsc_action_default(pcmk__output_t *out, va_list args)
             pcmk_action_t *stop_op = NULL;
 
             reason_op = start;
-            possible_matches = find_actions(rsc->priv->actions, key, node);
+            possible_matches = pe__resource_actions_by_key(rsc, key, node,
+                                                           false);
             if (possible_matches) {
                 stop_op = possible_matches->data;
                 g_list_free(possible_matches);
@@ -191,7 +191,7 @@ action_for_ordering(pcmk_action_t *action)
         && (action->uuid != NULL)) {
         char *uuid = action_uuid_for_ordering(action->uuid, rsc);
 
-        result = find_first_action(rsc->priv->actions, uuid, NULL, NULL);
+        result = pe__find_resource_action(rsc, uuid, NULL);
         if (result == NULL) {
             pcmk__warn("Not remapping %s to %s because %s does not have "
                        "remapped action",
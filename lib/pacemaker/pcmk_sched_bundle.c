@@ -974,8 +974,8 @@ create_replica_probes(pcmk__bundle_replica_t *replica, void *user_data)
                                         PCMK_ACTION_MONITOR, 0);
         pcmk_action_t *probe = NULL;
 
-        probe = find_first_action(replica->remote->priv->actions, probe_uuid,
-                                  NULL, probe_data->node);
+        probe = pe__find_resource_action(replica->remote, probe_uuid,
+                                         probe_data->node);
         free(probe_uuid);
         if (probe != NULL) {
             probe_data->any_created = true;
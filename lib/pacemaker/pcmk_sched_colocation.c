@@ -1515,25 +1515,69 @@ pcmk__apply_coloc_to_priority(pcmk_resource_t *dependent,
     return priority_delta;
 }
 
+// Best allowed node scores for each value of a colocation node attribute
+struct best_attr_scores {
+    GHashTable *by_value;   // Key = attribute value, value = best score
+    bool have_unset;        // Whether any available node lacks the attribute
+    int unset_score;        // Best score of available nodes lacking attribute
+};
+
+/*!
+ * \internal
+ * \brief Record an allowed node's score if best for its attribute value
+ *
+ * \param[in,out] best   Best scores found so far
+ * \param[in]     value  Node's colocation attribute value
+ * \param[in]     score  Node's score
+ */
+static void
+update_best_attr_score(struct best_attr_scores *best, const char *value,
+                       int score)
+{
+    void *old_score = NULL;
+
+    if (value == NULL) {
+        if (!best->have_unset || (score > best->unset_score)) {
+            best->have_unset = true;
+            best->unset_score = score;
+        }
+        return;
+    }
+
+    if (!g_hash_table_lookup_extended(best->by_value, value, NULL, &old_score)
+        || (score > GPOINTER_TO_INT(old_score))) {
+        g_hash_table_insert(best->by_value, (void *) value,
+                            GINT_TO_POINTER(score));
+    }
+}
+
 /*!
  * \internal
- * \brief Find score of highest-scored node that matches colocation attribute
+ * \brief Find best allowed node scores for each value of colocation attribute
+ *
+ * Applying a colocation's attribute matching to a table of nodes requires,
+ * for each node, the highest score of any of a resource's allowed nodes with
+ * the same attribute value. Gather those scores in one pass over the allowed
+ * nodes, so that each node's lookup doesn't need to scan them again.
  *
  * \param[in]     colocation  Colocation constraint being applied
  * \param[in,out] rsc         Resource whose allowed nodes should be searched
  * \param[in]     attr        Colocation attribute name (must not be NULL)
- * \param[in]     value       Colocation attribute value to require
+ * \param[out]    best        Where to store best scores (caller is responsible
+ *                            for destroying \p best->by_value)
  */
-static int
-best_node_score_matching_attr(const pcmk__colocation_t *colocation,
-                              pcmk_resource_t *rsc, const char *attr,
-                              const char *value)
+static void
+best_node_scores_by_attr(const pcmk__colocation_t *colocation,
+                         pcmk_resource_t *rsc, const char *attr,
+                         struct best_attr_scores *best)
 {
     GHashTable *allowed_nodes_orig = NULL;
     GHashTableIter iter;
     pcmk_node_t *node = NULL;
-    int best_score = -PCMK_SCORE_INFINITY;
-    const char *best_node = NULL;
+
+    best->by_value = pcmk__strikey_table(NULL, NULL);
+    best->have_unset = false;
+    best->unset_score = -PCMK_SCORE_INFINITY;
 
     if ((colocation != NULL) && (rsc == colocation->dependent)
         && pcmk__is_set(colocation->flags, pcmk__coloc_explicit)
@@ -1563,35 +1607,66 @@ best_node_score_matching_attr(const pcmk__colocation_t *colocation,
         }
     }
 
-    // Find best allowed node with matching attribute
+    // Find best available allowed node for each attribute value
     g_hash_table_iter_init(&iter, rsc->priv->allowed_nodes);
     while (g_hash_table_iter_next(&iter, NULL, (void **) &node)) {
 
-        if ((node->assign->score > best_score)
-            && pcmk__node_available(node, false, false)
-            && pcmk__str_eq(value, pcmk__colocation_node_attr(node, attr, rsc),
-                            pcmk__str_casei)) {
+        if ((node->assign->score > -PCMK_SCORE_INFINITY)
+            && pcmk__node_available(node, false, false)) {
 
-            best_score = node->assign->score;
-            best_node = node->priv->name;
+            update_best_attr_score(best,
+                                   pcmk__colocation_node_attr(node, attr, rsc),
+                                   node->assign->score);
         }
     }
 
+    if (allowed_nodes_orig != NULL) {
+        g_hash_table_destroy(rsc->priv->allowed_nodes);
+        rsc->priv->allowed_nodes = allowed_nodes_orig;
+    }
+}
+
+/*!
+ * \internal
+ * \brief Get best allowed node score for a colocation attribute value
+ *
+ * \param[in] best   Best scores (from \c best_node_scores_by_attr())
+ * \param[in] rsc    Resource whose allowed nodes were searched (for logging)
+ * \param[in] attr   Colocation attribute name (for logging)
+ * \param[in] value  Colocation attribute value to require
+ *
+ * \return Score of highest-scored available allowed node with \p value for
+ *         colocation attribute, or \c -PCMK_SCORE_INFINITY if none
+ */
+static int
+best_node_score_matching_attr(const struct best_attr_scores *best,
+                              const pcmk_resource_t *rsc, const char *attr,
+                              const char *value)
+{
+    int best_score = -PCMK_SCORE_INFINITY;
+    bool found = false;
+    void *score = NULL;
+
+    if (value == NULL) {
+        found = best->have_unset;
+        best_score = best->unset_score;
+
+    } else if (g_hash_table_lookup_extended(best->by_value, value, NULL,
+                                            &score)) {
+        found = true;
+        best_score = GPOINTER_TO_INT(score);
+    }
+
     if (!pcmk__str_eq(attr, CRM_ATTR_UNAME, pcmk__str_none)) {
-        if (best_node == NULL) {
+        if (!found) {
             pcmk__info("No allowed node for %s matches node attribute %s=%s",
                        rsc->id, attr, value);
         } else {
-            pcmk__info("Allowed node %s for %s had best score (%d) of those "
-                       "matching node attribute %s=%s",
-                       best_node, rsc->id, best_score, attr, value);
+            pcmk__info("Best score of allowed nodes for %s matching node "
+                       "attribute %s=%s is %d",
+                       rsc->id, attr, value, best_score);
         }
     }
-
-    if (allowed_nodes_orig != NULL) {
-        g_hash_table_destroy(rsc->priv->allowed_nodes);
-        rsc->priv->allowed_nodes = allowed_nodes_orig;
-    }
     return best_score;
 }
 
@@ -1650,6 +1725,9 @@ add_node_scores_matching_attr(GHashTable *nodes,
     GHashTableIter iter;
     pcmk_node_t *node = NULL;
     const char *attr = colocation->node_attribute;
+    struct best_attr_scores best;
+
+    best_node_scores_by_attr(colocation, source_rsc, attr, &best);
 
     // Iterate through each node
     g_hash_table_iter_init(&iter, nodes);
@@ -1660,7 +1738,7 @@ add_node_scores_matching_attr(GHashTable *nodes,
         int new_score = 0;
         const char *value = pcmk__colocation_node_attr(node, attr, target_rsc);
 
-        score = best_node_score_matching_attr(colocation, source_rsc, attr, value);
+        score = best_node_score_matching_attr(&best, source_rsc, attr, value);
 
         if ((factor < 0) && (score < 0)) {
             /* If the dependent is anti-colocated, we generally don't want the
@@ -1753,6 +1831,8 @@ add_node_scores_matching_attr(GHashTable *nodes,
                     node->assign->score, factor, score, new_score);
         node->assign->score = new_score;
     }
+
+    g_hash_table_destroy(best.by_value);
 }
 
 /*!
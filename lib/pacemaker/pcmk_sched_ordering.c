@@ -1190,7 +1190,7 @@ static GList *
 find_actions_by_task(const pcmk_resource_t *rsc, const char *original_key)
 {
     // Search under given task key directly
-    GList *list = find_actions(rsc->priv->actions, original_key, NULL);
+    GList *list = pe__resource_actions_by_key(rsc, original_key, NULL, false);
 
     if (list == NULL) {
         // Search again using this resource's ID
@@ -1201,7 +1201,7 @@ find_actions_by_task(const pcmk_resource_t *rsc, const char *original_key)
         CRM_CHECK(parse_op_key(original_key, NULL, &task, &interval_ms),
                   return NULL);
         key = pcmk__op_key(rsc->id, task, interval_ms);
-        list = find_actions(rsc->priv->actions, key, NULL);
+        list = pe__resource_actions_by_key(rsc, key, NULL, false);
         free(key);
         free(task);
     }
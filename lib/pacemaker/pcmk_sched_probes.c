@@ -437,8 +437,9 @@ add_probe_orderings_for_stops(pcmk_scheduler_t *scheduler)
             then_actions = g_list_prepend(NULL, then);
 
         } else if (order->rsc2 != NULL) {
-            then_actions = find_actions(order->rsc2->priv->actions,
-                                        order->task2, NULL);
+            then_actions = pe__resource_actions_by_key(order->rsc2,
+                                                       order->task2, NULL,
+                                                       false);
             if (then_actions == NULL) { // There aren't any
                 g_list_free(probes);
                 continue;
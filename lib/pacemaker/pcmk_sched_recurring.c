@@ -214,7 +214,7 @@ active_recurring_should_be_optional(const pcmk_resource_t *rsc,
         return false;
     }
 
-    possible_matches = find_actions_exact(rsc->priv->actions, key, node);
+    possible_matches = pe__resource_actions_by_key(rsc, key, node, true);
     if (possible_matches == NULL) {
         pcmk__rsc_trace(rsc,
                         "%s will be mandatory because it is not active on %s",
@@ -389,8 +389,8 @@ static void
 cancel_if_running(pcmk_resource_t *rsc, const pcmk_node_t *node,
                   const char *key, const char *name, unsigned int interval_ms)
 {
-    GList *possible_matches = find_actions_exact(rsc->priv->actions, key,
-                                                 node);
+    GList *possible_matches = pe__resource_actions_by_key(rsc, key, node,
+                                                          true);
     pcmk_action_t *cancel_op = NULL;
 
     if (possible_matches == NULL) {
@@ -534,8 +534,8 @@ recurring_op_for_inactive(pcmk_resource_t *rsc, const pcmk_node_t *node,
         }
 
         // Recurring action on this node is optional if it's already active here
-        possible_matches = find_actions_exact(rsc->priv->actions, op->key,
-                                              stop_node);
+        possible_matches = pe__resource_actions_by_key(rsc, op->key,
+                                                       stop_node, true);
         is_optional = (possible_matches != NULL);
         g_list_free(possible_matches);
 
@@ -728,6 +728,33 @@ log_unrunnable_actions(const pcmk_scheduler_t *scheduler)
     }
 }
 
+/*!
+ * \internal
+ * \brief Log the resource usage of each phase of the last scheduler run
+ *
+ * \param[in] scheduler  Scheduler data
+ */
+void
+pcmk__log_scheduler_usage(const pcmk_scheduler_t *scheduler)
+{
+    GString *phases = g_string_sized_new(256);
+    long max_rss_kb = 0;
+
+    for (int phase = 0; phase < pcmk__sched_phase_max; phase++) {
+        const pcmk__sched_usage_t *usage = &(scheduler->priv->usage[phase]);
+
+        g_string_append_printf(phases, "%s%s %.3fs (%.3fs CPU)",
+                               ((phase == 0)? "" : ", "),
+                               pcmk__sched_phase_text(phase),
+                               usage->wall_s, usage->cpu_s);
+        max_rss_kb = QB_MAX(max_rss_kb, usage->max_rss_kb);
+    }
+
+    pcmk__info("Scheduler phase times: %s; peak RSS %ld KiB",
+               phases->str, max_rss_kb);
+    g_string_free(phases, TRUE);
+}
+
 /*!
  * \internal
  * \brief Run the scheduler for a given CIB
@@ -737,28 +764,39 @@ log_unrunnable_actions(const pcmk_scheduler_t *scheduler)
 void
 pcmk__schedule_actions(pcmk_scheduler_t *scheduler)
 {
+    pcmk__sched_mark_t start;
+
+    pcmk__sched_phase_start(&start);
     cluster_status(scheduler);
     pcmk__set_assignment_methods(scheduler);
     pcmk__apply_node_health(scheduler);
     pcmk__unpack_constraints(scheduler);
+    pcmk__sched_phase_end(scheduler, pcmk__sched_phase_unpack, &start);
+
     if (pcmk__is_set(scheduler->flags, pcmk__sched_validate_only)) {
         return;
     }
 
+    pcmk__sched_phase_start(&start);
     if (!pcmk__is_set(scheduler->flags, pcmk__sched_location_only)
         && pcmk__is_daemon) {
         log_resource_details(scheduler);
     }
 
     apply_node_criteria(scheduler);
+    pcmk__sched_phase_end(scheduler, pcmk__sched_phase_node_criteria, &start);
 
     if (pcmk__is_set(scheduler->flags, pcmk__sched_location_only)) {
         return;
     }
 
+    pcmk__sched_phase_start(&start);
     pcmk__create_internal_constraints(scheduler);
     pcmk__handle_rsc_config_changes(scheduler);
     assign_resources(scheduler);
+    pcmk__sched_phase_end(scheduler, pcmk__sched_phase_assign, &start);
+
+    pcmk__sched_phase_start(&start);
     schedule_resource_actions(scheduler);
 
     /* Remote ordering constraints need to happen prior to calculating fencing
@@ -767,9 +805,17 @@ pcmk__schedule_actions(pcmk_scheduler_t *scheduler)
     pcmk__order_remote_connection_actions(scheduler);
 
     schedule_fencing_and_shutdowns(scheduler);
+    pcmk__sched_phase_end(scheduler, pcmk__sched_phase_actions, &start);
+
+    pcmk__sched_phase_start(&start);
     pcmk__apply_orderings(scheduler);
+    pcmk__sched_phase_end(scheduler, pcmk__sched_phase_orderings, &start);
+
     log_all_actions(scheduler);
+
+    pcmk__sched_phase_start(&start);
     pcmk__create_graph(scheduler);
+    pcmk__sched_phase_end(scheduler, pcmk__sched_phase_graph, &start);
 
     if (get_crm_log_level() == LOG_TRACE) {
         log_unrunnable_actions(scheduler);
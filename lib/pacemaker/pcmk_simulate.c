@@ -390,6 +390,7 @@ profile_file(const char *xml_file, unsigned int repeat,
     xmlNode *cib_object = NULL;
     clock_t start = 0;
     clock_t end;
+    pcmk__sched_usage_t usage[pcmk__sched_phase_max] = { { 0, }, };
 
     pcmk__assert(out != NULL);
 
@@ -415,11 +416,13 @@ profile_file(const char *xml_file, unsigned int repeat,
         pcmk__set_scheduler_flags(scheduler, flags);
         set_effective_date(scheduler, false, use_date);
         pcmk__schedule_actions(scheduler);
+
+        pcmk__add_sched_usage(usage, scheduler->priv->usage);
     }
 
     pcmk_reset_scheduler(scheduler);
     end = clock();
-    out->message(out, "profile", xml_file, start, end);
+    out->message(out, "profile", xml_file, start, end, usage);
 
 done:
     pcmk__xml_free(cib_object);
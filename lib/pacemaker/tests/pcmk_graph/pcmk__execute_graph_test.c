@@ -0,0 +1,221 @@
+/*
+ * Copyright 2026 the Pacemaker project contributors
+ *
+ * The version control history for this file may have further details.
+ *
+ * This source code is licensed under the GNU General Public License version 2
+ * or later (GPLv2+) WITHOUT ANY WARRANTY.
+ */
+
+#include <crm_internal.h>
+
+#include <crm/common/unittest_internal.h>
+#include <crm/common/xml.h>
+
+#include <pacemaker-internal.h>
+
+#define GRAPH_START(batch_limit)                                            \
+    "<transition_graph transition_id='1' cluster-delay='60s' "              \
+                      "batch-limit='" batch_limit "'>"
+
+#define GRAPH_END "</transition_graph>"
+
+#define PSEUDO(id)                                                          \
+    "<pseudo_event id='" id "' operation='x' operation_key='x_" id "'/>"
+
+#define RSC_OP(id)                                                          \
+    "<rsc_op id='" id "' operation='x' operation_key='x_" id "'/>"
+
+#define SYNAPSE(id, priority, action, inputs)                               \
+    "<synapse id='" id "' priority='" priority "'>"                         \
+      "<action_set>" action "</action_set>"                                 \
+      "<inputs>" inputs "</inputs>"                                         \
+    "</synapse>"
+
+#define TRIGGER(id) "<trigger>" PSEUDO(id) "</trigger>"
+
+// IDs of initiated actions, in order
+static GString *initiated = NULL;
+
+// ID of an action to fail when initiated
+static int fail_id = 0;
+
+static int
+complete_action(pcmk__graph_t *graph, pcmk__graph_action_t *action)
+{
+    g_string_append_printf(initiated, "%d ", action->id);
+
+    if (action->id == fail_id) {
+        pcmk__set_graph_action_flags(action, pcmk__graph_action_failed);
+    }
+    pcmk__set_graph_action_flags(action, pcmk__graph_action_confirmed);
+    pcmk__update_graph(graph, action);
+    return pcmk_rc_ok;
+}
+
+static int
+start_action(pcmk__graph_t *graph, pcmk__graph_action_t *action)
+{
+    g_string_append_printf(initiated, "%d ", action->id);
+    return pcmk_rc_ok;
+}
+
+static pcmk__graph_functions_t fns = {
+    complete_action,
+    start_action,
+    complete_action,
+    complete_action,
+    NULL,
+};
+
+static int
+setup(void **state)
+{
+    pcmk__set_graph_functions(&fns);
+    return 0;
+}
+
+static int
+setup_test(void **state)
+{
+    initiated = g_string_sized_new(64);
+    fail_id = 0;
+    return 0;
+}
+
+static int
+teardown_test(void **state)
+{
+    g_string_free(initiated, TRUE);
+    initiated = NULL;
+    return 0;
+}
+
+static pcmk__graph_t *
+unpack(const char *text)
+{
+    xmlNode *xml = pcmk__xml_parse(text);
+    pcmk__graph_t *graph = NULL;
+
+    assert_non_null(xml);
+    graph = pcmk__unpack_graph(xml, "test");
+    assert_non_null(graph);
+
+    pcmk__xml_free(xml);
+    return graph;
+}
+
+static void
+chain_in_order(void **state)
+{
+    pcmk__graph_t *graph = unpack(GRAPH_START("0")
+                                  SYNAPSE("0", "0", PSEUDO("1"), "")
+                                  SYNAPSE("1", "0", PSEUDO("2"), TRIGGER("1"))
+                                  SYNAPSE("2", "0", PSEUDO("3"), TRIGGER("2"))
+                                  SYNAPSE("3", "0", PSEUDO("4"),
+                                          TRIGGER("1") TRIGGER("3"))
+                                  GRAPH_END);
+
+    // Each synapse becomes ready after the ones before it, so all fire at once
+    assert_int_equal(pcmk__execute_graph(graph), pcmk__graph_active);
+    assert_string_equal(initiated->str, "1 2 3 4 ");
+    assert_int_equal(graph->fired, 4);
+
+    assert_int_equal(pcmk__execute_graph(graph), pcmk__graph_complete);
+    assert_int_equal(graph->completed, 4);
+    assert_true(graph->complete);
+
+    pcmk__free_graph(graph);
+}
+
+static void
+earlier_synapse_waits(void **state)
+{
+    pcmk__graph_t *graph = unpack(GRAPH_START("0")
+                                  SYNAPSE("0", "0", PSEUDO("2"), TRIGGER("1"))
+                                  SYNAPSE("1", "0", PSEUDO("1"), "")
+                                  GRAPH_END);
+
+    // Synapse 0 becomes ready only after the pass has moved past it
+    assert_int_equal(pcmk__execute_graph(graph), pcmk__graph_active);
+    assert_string_equal(initiated->str, "1 ");
+    assert_int_equal(graph->incomplete, 1);
+
+    assert_int_equal(pcmk__execute_graph(graph), pcmk__graph_active);
+    assert_string_equal(initiated->str, "1 2 ");
+
+    assert_int_equal(pcmk__execute_graph(graph), pcmk__graph_complete);
+
+    pcmk__free_graph(graph);
+}
+
+static void
+batch_limit(void **state)
+{
+    pcmk__graph_t *graph = unpack(GRAPH_START("2")
+                                  SYNAPSE("0", "0", RSC_OP("1"), "")
+                                  SYNAPSE("1", "0", RSC_OP("2"), "")
+                                  SYNAPSE("2", "0", RSC_OP("3"), "")
+                                  SYNAPSE("3", "0", PSEUDO("4"), TRIGGER("1"))
+                                  GRAPH_END);
+    pcmk__graph_synapse_t *synapse = graph->synapses->data;
+    pcmk__graph_action_t *action = synapse->actions->data;
+
+    assert_int_equal(pcmk__execute_graph(graph), pcmk__graph_active);
+    assert_string_equal(initiated->str, "1 2 ");
+    assert_int_equal(graph->pending, 2);
+
+    // Nothing more can be done until an action completes
+    assert_int_equal(pcmk__execute_graph(graph), pcmk__graph_pending);
+    assert_string_equal(initiated->str, "1 2 ");
+
+    pcmk__set_graph_action_flags(action, pcmk__graph_action_confirmed);
+    pcmk__update_graph(graph, action);
+    assert_true(pcmk__is_set(synapse->flags, pcmk__synapse_confirmed));
+
+    // Action 3 fills the batch again before action 4 (now ready) is reached
+    assert_int_equal(pcmk__execute_graph(graph), pcmk__graph_active);
+    assert_string_equal(initiated->str, "1 2 3 ");
+    assert_int_equal(graph->pending, 2);
+
+    synapse = graph->synapses->next->data;
+    action = synapse->actions->data;
+    pcmk__set_graph_action_flags(action, pcmk__graph_action_confirmed);
+    pcmk__update_graph(graph, action);
+
+    assert_int_equal(pcmk__execute_graph(graph), pcmk__graph_active);
+    assert_string_equal(initiated->str, "1 2 3 4 ");
+
+    pcmk__free_graph(graph);
+}
+
+static void
+failed_input(void **state)
+{
+    pcmk__graph_t *graph = unpack(GRAPH_START("0")
+                                  SYNAPSE("0", "0", PSEUDO("1"), "")
+                                  SYNAPSE("1", "0", PSEUDO("2"), TRIGGER("1"))
+                                  SYNAPSE("2", "1000000", PSEUDO("3"),
+                                          TRIGGER("1"))
+                                  GRAPH_END);
+
+    // Only a synapse with infinite priority may run after a failed input
+    fail_id = 1;
+    assert_int_equal(pcmk__execute_graph(graph), pcmk__graph_active);
+    assert_string_equal(initiated->str, "1 3 ");
+
+    assert_int_equal(pcmk__execute_graph(graph), pcmk__graph_terminated);
+    assert_int_equal(graph->incomplete, 1);
+
+    pcmk__free_graph(graph);
+}
+
+PCMK__UNIT_TEST(setup, NULL,
+                cmocka_unit_test_setup_teardown(chain_in_order, setup_test,
+                                                teardown_test),
+                cmocka_unit_test_setup_teardown(earlier_synapse_waits,
+                                                setup_test, teardown_test),
+                cmocka_unit_test_setup_teardown(batch_limit, setup_test,
+                                                teardown_test),
+                cmocka_unit_test_setup_teardown(failed_input, setup_test,
+                                                teardown_test))
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2026 the Pacemaker project contributors
+ *
+ * The version control history for this file may have further details.
+ *
+ * This source code is licensed under the GNU General Public License version 2
+ * or later (GPLv2+) WITHOUT ANY WARRANTY.
+ */
+
+#include <crm_internal.h>
+
+#include <stdlib.h>         // getenv()
+
+#include <crm/common/unittest_internal.h>
+#include <crm/common/xml.h>
+
+#include <pacemaker-internal.h>
+
+static xmlNode *input = NULL;
+
+static int
+setup(void **state)
+{
+    char *path = NULL;
+
+    pcmk__xml_test_setup_group(state);
+
+    path = pcmk__assert_asprintf("%s/crm_mon.xml", getenv("PCMK_CTS_CLI_DIR"));
+    input = pcmk__xml_read(path);
+    free(path);
+
+    return (input == NULL)? 1 : 0;
+}
+
+static int
+teardown(void **state)
+{
+    pcmk__xml_free(input);
+    pcmk__xml_test_teardown_group(state);
+    return 0;
+}
+
+/*!
+ * \internal
+ * \brief Run the scheduler and check which phases recorded resource usage
+ *
+ * \param[in] flags  Scheduler flags to set
+ * \param[in] last   Last phase expected to be recorded
+ */
+static void
+assert_phases(uint64_t flags, enum pcmk__sched_phase last)
+{
+    pcmk_scheduler_t *scheduler = pcmk_new_scheduler();
+
+    scheduler->input = pcmk__xml_copy(NULL, input);
+    pcmk__set_scheduler_flags(scheduler, pcmk__sched_no_counts|flags);
+    pcmk__schedule_actions(scheduler);
+
+    for (int phase = 0; phase < pcmk__sched_phase_max; phase++) {
+        const pcmk__sched_usage_t *usage = &(scheduler->priv->usage[phase]);
+
+        if (phase <= last) {
+            assert_true(usage->max_rss_kb > 0);
+            assert_true(usage->wall_s >= 0.0);
+            assert_true(usage->cpu_s >= 0.0);
+        } else {
+            assert_int_equal(usage->max_rss_kb, 0);
+            assert_true(usage->wall_s == 0.0);
+            assert_true(usage->cpu_s == 0.0);
+        }
+    }
+
+    // Times are for the latest run only
+    pcmk_reset_scheduler(scheduler);
+    for (int phase = 0; phase < pcmk__sched_phase_max; phase++) {
+        assert_int_equal(scheduler->priv->usage[phase].max_rss_kb, 0);
+    }
+
+    pcmk_free_scheduler(scheduler);
+}
+
+static void
+validate_only(void **state)
+{
+    assert_phases(pcmk__sched_validate_only, pcmk__sched_phase_unpack);
+}
+
+static void
+location_only(void **state)
+{
+    assert_phases(pcmk__sched_location_only, pcmk__sched_phase_node_criteria);
+}
+
+static void
+all_phases(void **state)
+{
+    assert_phases(0, pcmk__sched_phase_graph);
+}
+
+PCMK__UNIT_TEST(setup, teardown,
+                cmocka_unit_test(validate_only),
+                cmocka_unit_test(location_only),
+                cmocka_unit_test(all_phases))
@@ -64,6 +64,115 @@ lookup_singleton(pcmk_scheduler_t *scheduler, const char *action_uuid)
     return g_hash_table_lookup(scheduler->priv->singletons, action_uuid);
 }
 
+/*!
+ * \internal
+ * \brief Add a new action to the scheduler's index of actions by key
+ *
+ * \param[in,out] scheduler  Scheduler data
+ * \param[in]     action     Action to index
+ */
+static void
+index_action(pcmk_scheduler_t *scheduler, pcmk_action_t *action)
+{
+    GQueue *actions = NULL;
+
+    if (scheduler->priv->action_index == NULL) {
+        scheduler->priv->action_index =
+            pcmk__strikey_table(NULL, (GDestroyNotify) g_queue_free);
+    }
+
+    actions = g_hash_table_lookup(scheduler->priv->action_index, action->uuid);
+    if (actions == NULL) {
+        actions = g_queue_new();
+        g_hash_table_insert(scheduler->priv->action_index, action->uuid,
+                            actions);
+    }
+    g_queue_push_tail(actions, action);
+}
+
+/*!
+ * \internal
+ * \brief Get all indexed actions with a given key
+ *
+ * \param[in] scheduler  Scheduler data
+ * \param[in] key        Action key to search for
+ *
+ * \return Queue of actions with \p key in order of creation (or \c NULL if
+ *         none)
+ */
+static GQueue *
+indexed_actions(const pcmk_scheduler_t *scheduler, const char *key)
+{
+    if ((scheduler == NULL) || (scheduler->priv->action_index == NULL)) {
+        return NULL;
+    }
+    return g_hash_table_lookup(scheduler->priv->action_index, key);
+}
+
+/*!
+ * \internal
+ * \brief Find actions with a given key, optionally limited by resource and node
+ *
+ * \param[in] scheduler     Scheduler data
+ * \param[in] rsc           If not \c NULL, match only actions for this resource
+ * \param[in] key           Action key to search for
+ * \param[in] on_node       If not \c NULL, match only actions on this node
+ * \param[in] require_node  If \c false, also match actions without a node
+ *                          (and assign \p on_node to them)
+ *
+ * \return List of matching actions in order of creation (or \c NULL if none)
+ * \note The caller is responsible for freeing the result with \c g_list_free().
+ */
+static GList *
+find_indexed_actions(const pcmk_scheduler_t *scheduler,
+                     const pcmk_resource_t *rsc, const char *key,
+                     const pcmk_node_t *on_node, bool require_node)
+{
+    GList *result = NULL;
+    GQueue *actions = NULL;
+
+    CRM_CHECK(key != NULL, return NULL);
+
+    if (require_node && (on_node == NULL)) {
+        return NULL;
+    }
+
+    actions = indexed_actions(scheduler, key);
+    if (actions == NULL) {
+        return NULL;
+    }
+
+    // Search newest first and prepend, so result is in order of creation
+    for (GList *iter = actions->tail; iter != NULL; iter = iter->prev) {
+        pcmk_action_t *action = iter->data;
+
+        if ((rsc != NULL) && (action->rsc != rsc)) {
+            continue;
+
+        } else if (on_node == NULL) {
+            pcmk__trace("Action %s matches (ignoring node)", key);
+            result = g_list_prepend(result, action);
+
+        } else if (action->node == NULL) {
+            if (require_node) {
+                continue;
+            }
+            pcmk__trace("Action %s matches (unallocated, assigning to %s)", key,
+                        pcmk__node_name(on_node));
+
+            action->node = pe__copy_node(on_node);
+            result = g_list_prepend(result, action);
+
+        } else if (pcmk__same_node(on_node, action->node)) {
+            pcmk__trace("Action %s on %s matches", key,
+                        pcmk__node_name(on_node));
+            result = g_list_prepend(result, action);
+        }
+    }
+
+    return result;
+}
+
 /*!
  * \internal
  * \brief Find an existing action that matches arguments
@@ -80,11 +189,10 @@ find_existing_action(const char *key, const pcmk_resource_t *rsc,
                      const pcmk_node_t *node, const pcmk_scheduler_t *scheduler)
 {
     /* When rsc is NULL, it would be quicker to check
-     * scheduler->priv->singletons, but checking all scheduler->priv->actions
+     * scheduler->priv->singletons, but checking all actions with the key
      * takes the node into account.
      */
-    GList *actions = (rsc == NULL)? scheduler->priv->actions : rsc->priv->actions;
-    GList *matches = find_actions(actions, key, node);
+    GList *matches = find_indexed_actions(scheduler, rsc, key, node, false);
     pcmk_action_t *action = NULL;
 
     if (matches == NULL) {
@@ -245,6 +353,7 @@ new_action(char *key, const char *task, pcmk_resource_t *rsc,
     action->id = scheduler->priv->next_action_id++;
 
     scheduler->priv->actions = g_list_prepend(scheduler->priv->actions, action);
+    index_action(scheduler, action);
     if (rsc == NULL) {
         add_singleton(scheduler, action);
     } else {
@@ -1118,7 +1227,7 @@ custom_action(pcmk_resource_t *rsc, char *key, const char *task,
 
     if (rsc != NULL) {
         /* An action can be initially created with a NULL node, and later have
-         * the node added via find_existing_action() (above) -> find_actions().
+         * the node added via find_existing_action() (above).
          * That is why the extra parameters are unpacked here rather than in
          * new_action().
          */
@@ -1426,65 +1535,66 @@ find_first_action(const GList *input, const char *uuid, const char *task,
     return NULL;
 }
 
-GList *
-find_actions(GList *input, const char *key, const pcmk_node_t *on_node)
+/*!
+ * \internal
+ * \brief Find the newest action for a resource with a given key
+ *
+ * \param[in] rsc      Resource to search
+ * \param[in] key      Action key to search for
+ * \param[in] on_node  If not \c NULL, action must be on this node
+ *
+ * \return Most recently created matching action, or \c NULL if none
+ */
+pcmk_action_t *
+pe__find_resource_action(const pcmk_resource_t *rsc, const char *key,
+                         const pcmk_node_t *on_node)
 {
-    GList *result = NULL;
+    GQueue *actions = NULL;
 
-    CRM_CHECK(key != NULL, return NULL);
+    CRM_CHECK((rsc != NULL) && (key != NULL), return NULL);
 
-    for (GList *iter = input; iter != NULL; iter = iter->next) {
+    actions = indexed_actions(rsc->priv->scheduler, key);
+    if (actions == NULL) {
+        return NULL;
+    }
+
+    for (GList *iter = actions->tail; iter != NULL; iter = iter->prev) {
         pcmk_action_t *action = iter->data;
 
-        if (!pcmk__str_eq(key, action->uuid, pcmk__str_casei)) {
+        if ((action->rsc != rsc)
+            || ((on_node != NULL)
+                && ((action->node == NULL)
+                    || !pcmk__same_node(on_node, action->node)))) {
             continue;
-
-        } else if (on_node == NULL) {
-            pcmk__trace("Action %s matches (ignoring node)", key);
-            result = g_list_prepend(result, action);
-
-        } else if (action->node == NULL) {
-            pcmk__trace("Action %s matches (unallocated, assigning to %s)", key,
-                        pcmk__node_name(on_node));
-
-            action->node = pe__copy_node(on_node);
-            result = g_list_prepend(result, action);
-
-        } else if (pcmk__same_node(on_node, action->node)) {
-            pcmk__trace("Action %s on %s matches", key,
-                        pcmk__node_name(on_node));
-            result = g_list_prepend(result, action);
         }
+        return action;
     }
-
-    return result;
+    return NULL;
 }
 
+/*!
+ * \internal
+ * \brief Find all actions for a resource with a given key
+ *
+ * \param[in] rsc           Resource to search
+ * \param[in] key           Action key to search for
+ * \param[in] node          If not \c NULL, find only actions on this node
+ * \param[in] require_node  If \c true, \c NULL node or action node will not
+ *                          match
+ *
+ * \return List of actions found (or \c NULL if none)
+ * \note If \p node is not \c NULL and \p require_node is \c false, matching
+ *       actions without a node will be assigned to \p node.
+ * \note The caller is responsible for freeing the result with \c g_list_free().
+ */
 GList *
-find_actions_exact(GList *input, const char *key, const pcmk_node_t *on_node)
+pe__resource_actions_by_key(const pcmk_resource_t *rsc, const char *key,
+                            const pcmk_node_t *node, bool require_node)
 {
-    GList *result = NULL;
-
-    CRM_CHECK(key != NULL, return NULL);
+    CRM_CHECK(rsc != NULL, return NULL);
 
-    if (on_node == NULL) {
-        return NULL;
-    }
-
-    for (GList *iter = input; iter != NULL; iter = iter->next) {
-        pcmk_action_t *action = iter->data;
-
-        if ((action->node != NULL)
-            && pcmk__str_eq(key, action->uuid, pcmk__str_casei)
-            && pcmk__same_node(on_node, action->node)) {
-
-            pcmk__trace("Action %s on %s matches", key,
-                        pcmk__node_name(on_node));
-            result = g_list_prepend(result, action);
-        }
-    }
-
-    return result;
+    return find_indexed_actions(rsc->priv->scheduler, rsc, key, node,
+                                require_node);
 }
 
 /*!
@@ -1503,14 +1613,9 @@ GList *
 pe__resource_actions(const pcmk_resource_t *rsc, const pcmk_node_t *node,
                      const char *task, bool require_node)
 {
-    GList *result = NULL;
     char *key = pcmk__op_key(rsc->id, task, 0);
+    GList *result = pe__resource_actions_by_key(rsc, key, node, require_node);
 
-    if (require_node) {
-        result = find_actions_exact(rsc->priv->actions, key, node);
-    } else {
-        result = find_actions(rsc->priv->actions, key, node);
-    }
     free(key);
     return result;
 }
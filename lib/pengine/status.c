@@ -68,9 +68,8 @@ check_for_deprecated_rules(pcmk_scheduler_t *scheduler)
  *
  * @TODO Currently this function can modify scheduler->input by creating
  * primitive elements for guest nodes. Commit 5dbc819 aimed to make this
- * function idempotent. It seems to be idempotent now, except that if
- * scheduler->input is reused, it may gain duplicate primitive elements for
- * guest nodes each time.
+ * function idempotent, and reusing scheduler->input no longer adds duplicate
+ * primitive elements for guest nodes.
  *
  * Investigate whether we can leave scheduler->input unmodified without a lot of
  * unnecessary XML copying. Otherwise, just document that scheduler->input may
@@ -304,6 +303,14 @@ cleanup_calculations(pcmk_scheduler_t *scheduler)
         g_hash_table_destroy(scheduler->priv->singletons);
     }
 
+    if (scheduler->priv->action_index != NULL) {
+        g_hash_table_destroy(scheduler->priv->action_index);
+    }
+
+    if (scheduler->priv->history_index != NULL) {
+        g_hash_table_destroy(scheduler->priv->history_index);
+    }
+
     if (scheduler->priv->ticket_constraints != NULL) {
         g_hash_table_destroy(scheduler->priv->ticket_constraints);
     }
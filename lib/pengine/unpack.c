@@ -603,6 +603,14 @@ expand_remote_rsc_meta(xmlNode *xml_obj, xmlNode *parent, pcmk_scheduler_t *data
         return NULL;
     }
 
+    /* If the input was unpacked before (for example, by the scheduler daemon
+     * when the CIB hasn't changed), the connection resource is already there
+     */
+    if (pcmk__xe_first_child(parent, PCMK_XE_PRIMITIVE, PCMK_XA_ID,
+                             remote_name) != NULL) {
+        return remote_name;
+    }
+
     pe_create_remote_xml(parent, remote_name, container_id,
                          remote_allow_migrate, is_managed,
                          connect_timeout, remote_server, remote_port);
@@ -1321,30 +1329,31 @@ unpack_node_state(const xmlNode *state, pcmk_scheduler_t *scheduler)
     }
 }
 
+// A node state entry whose resource history has not yet been unpacked
+struct pending_history {
+    const xmlNode *state;   // Node's PCMK__XE_NODE_STATE entry
+    pcmk_node_t *node;      // Node that entry is for (if known yet)
+};
+
 /*!
  * \internal
- * \brief Unpack nodes' resource history as much as possible
+ * \brief Get a list of all node state entries with history to unpack
  *
- * Unpack as many nodes' resource history as possible in one pass through the
- * status. We need to process Pacemaker Remote nodes' connections/containers
- * before unpacking their history; the connection/container history will be
- * in another node's history, so it might take multiple passes to unpack
- * everything.
+ * Unpacking history can take several passes through the status section, so
+ * resolve each entry's node once rather than in every pass.
  *
  * \param[in]     status     CIB XML status section
- * \param[in]     fence      If true, treat any not-yet-unpacked nodes as unseen
  * \param[in,out] scheduler  Scheduler data
  *
- * \return Standard Pacemaker return code (specifically pcmk_rc_ok if done,
- *         or EAGAIN if more unpacking remains to be done)
+ * \return List of new struct pending_history objects, in document order
+ * \note The caller is responsible for freeing the result with
+ *       \c g_list_free_full() and \c free().
  */
-static int
-unpack_node_history(const xmlNode *status, bool fence,
-                    pcmk_scheduler_t *scheduler)
+static GList *
+pending_node_histories(const xmlNode *status, pcmk_scheduler_t *scheduler)
 {
-    int rc = pcmk_rc_ok;
+    GList *pending = NULL;
 
-    // Loop through all PCMK__XE_NODE_STATE entries in CIB status
     for (const xmlNode *state = pcmk__xe_first_child(status,
                                                      PCMK__XE_NODE_STATE, NULL,
                                                      NULL);
@@ -1352,7 +1361,7 @@ unpack_node_history(const xmlNode *status, bool fence,
 
         const char *id = pcmk__xe_id(state);
         const char *uname = pcmk__xe_get(state, PCMK_XA_UNAME);
-        pcmk_node_t *this_node = NULL;
+        struct pending_history *history = NULL;
 
         if ((id == NULL) || (uname == NULL)) {
             // Warning already logged in first pass through status section
@@ -1361,19 +1370,68 @@ unpack_node_history(const xmlNode *status, bool fence,
             continue;
         }
 
-        this_node = pe_find_node_any(scheduler->nodes, id, uname);
+        history = pcmk__assert_alloc(1, sizeof(struct pending_history));
+        history->state = state;
+        history->node = pe_find_node_any(scheduler->nodes, id, uname);
+        pending = g_list_prepend(pending, history);
+    }
+    return g_list_reverse(pending);
+}
+
+/*!
+ * \internal
+ * \brief Unpack nodes' resource history as much as possible
+ *
+ * Unpack as many nodes' resource history as possible in one pass through the
+ * status. We need to process Pacemaker Remote nodes' connections/containers
+ * before unpacking their history; the connection/container history will be
+ * in another node's history, so it might take multiple passes to unpack
+ * everything.
+ *
+ * \param[in,out] pending    List of struct pending_history (entries that are
+ *                           unpacked or will never be unpacked are removed)
+ * \param[in]     fence      If true, treat any not-yet-unpacked nodes as unseen
+ * \param[in,out] scheduler  Scheduler data
+ *
+ * \return Standard Pacemaker return code (specifically pcmk_rc_ok if done,
+ *         or EAGAIN if more unpacking remains to be done)
+ */
+static int
+unpack_node_history(GList **pending, bool fence, pcmk_scheduler_t *scheduler)
+{
+    int rc = pcmk_rc_ok;
+    GList *next = NULL;
+
+    for (GList *iter = *pending; iter != NULL; iter = next) {
+        struct pending_history *history = iter->data;
+        const xmlNode *state = history->state;
+        const char *id = pcmk__xe_id(state);
+        pcmk_node_t *this_node = history->node;
+
+        next = iter->next;
+
         if (this_node == NULL) {
-            // Warning already logged in first pass through status section
-            pcmk__trace("Not unpacking resource history for node %s because "
-                        "no longer in configuration",
-                        id);
-            continue;
+            /* Removed remote connections found while unpacking history can
+             * create nodes, so check again on each pass.
+             */
+            this_node = pe_find_node_any(scheduler->nodes, id,
+                                         pcmk__xe_get(state, PCMK_XA_UNAME));
+            if (this_node == NULL) {
+                // Warning already logged in first pass through status section
+                pcmk__trace("Not unpacking resource history for node %s "
+                            "because no longer in configuration",
+                            id);
+                continue;
+            }
+            history->node = this_node;
         }
 
         if (pcmk__is_set(this_node->priv->flags, pcmk__node_unpacked)) {
             pcmk__trace("Not unpacking resource history for node %s because "
                         "already unpacked",
                         id);
+            *pending = g_list_delete_link(*pending, iter);
+            free(history);
             continue;
         }
 
@@ -1440,6 +1498,9 @@ unpack_node_history(const xmlNode *status, bool fence,
         pcmk__set_node_flags(this_node, pcmk__node_unpacked);
         unpack_node_lrm(this_node, state, scheduler);
 
+        *pending = g_list_delete_link(*pending, iter);
+        free(history);
+
         rc = EAGAIN; // Other node histories might depend on this one
     }
     return rc;
@@ -1452,6 +1513,7 @@ gboolean
 unpack_status(xmlNode *status, pcmk_scheduler_t *scheduler)
 {
     xmlNode *state = NULL;
+    GList *pending = NULL;
 
     pcmk__trace("Beginning unpack");
 
@@ -1472,15 +1534,18 @@ unpack_status(xmlNode *status, pcmk_scheduler_t *scheduler)
         }
     }
 
-    while (unpack_node_history(status, FALSE, scheduler) == EAGAIN) {
+    pending = pending_node_histories(status, scheduler);
+
+    while (unpack_node_history(&pending, false, scheduler) == EAGAIN) {
         pcmk__trace("Another pass through node resource histories is needed");
     }
 
     // Now catch any nodes we didn't see
-    unpack_node_history(status,
+    unpack_node_history(&pending,
                         pcmk__is_set(scheduler->flags,
                                      pcmk__sched_fencing_enabled),
                         scheduler);
+    g_list_free_full(pending, free);
 
     /* Now that we know where resources are, we can schedule stops of containers
      * with failed bundle connections
@@ -3014,47 +3079,186 @@ set_node_score(void *key, void *value, void *user_data)
     node->assign->score = *score;
 }
 
-#define XPATH_NODE_STATE "/" PCMK_XE_CIB "/" PCMK_XE_STATUS \
-                         "/" PCMK__XE_NODE_STATE
-#define SUB_XPATH_LRM_RESOURCE "/" PCMK__XE_LRM             \
-                               "/" PCMK__XE_LRM_RESOURCES   \
-                               "/" PCMK__XE_LRM_RESOURCE
-#define SUB_XPATH_LRM_RSC_OP "/" PCMK__XE_LRM_RSC_OP
+/*!
+ * \internal
+ * \brief Add a node's resource history elements to a history index
+ *
+ * \param[in,out] node_history  Index of \p node_state's resource history
+ * \param[in]     node_state    Node state XML to index
+ */
+static void
+index_node_history(GHashTable *node_history, const xmlNode *node_state)
+{
+    for (const xmlNode *lrm = pcmk__xe_first_child(node_state, PCMK__XE_LRM,
+                                                   NULL, NULL);
+         lrm != NULL; lrm = pcmk__xe_next(lrm, PCMK__XE_LRM)) {
+
+        for (const xmlNode *rscs = pcmk__xe_first_child(lrm,
+                                                        PCMK__XE_LRM_RESOURCES,
+                                                        NULL, NULL);
+             rscs != NULL; rscs = pcmk__xe_next(rscs, PCMK__XE_LRM_RESOURCES)) {
+
+            for (xmlNode *entry = pcmk__xe_first_child(rscs,
+                                                       PCMK__XE_LRM_RESOURCE,
+                                                       NULL, NULL);
+                 entry != NULL;
+                 entry = pcmk__xe_next(entry, PCMK__XE_LRM_RESOURCE)) {
+
+                const char *rsc_id = pcmk__xe_id(entry);
+                GList *entries = NULL;
+
+                if (rsc_id == NULL) {
+                    continue;
+                }
+
+                /* A valid CIB has at most one entry per resource per node, but
+                 * keep any duplicates so that lookups can detect them
+                 */
+                entries = g_hash_table_lookup(node_history, rsc_id);
+                if (entries == NULL) {
+                    g_hash_table_insert(node_history, (gpointer) rsc_id,
+                                        g_list_prepend(NULL, entry));
+                } else {
+                    entries = g_list_append(entries, entry);
+                }
+            }
+        }
+    }
+}
+
+/*!
+ * \internal
+ * \brief Index all resource history elements in the CIB status section
+ *
+ * Migration handling looks up resource history for specific node and resource
+ * combinations many times, so rather than search the entire status section
+ * each time, index the relevant elements once per scheduler run.
+ *
+ * \param[in,out] scheduler  Scheduler data
+ */
+static void
+index_resource_history(pcmk_scheduler_t *scheduler)
+{
+    xmlNode *status = pcmk__xe_first_child(scheduler->input, PCMK_XE_STATUS,
+                                           NULL, NULL);
+
+    scheduler->priv->history_index =
+        pcmk__strkey_table(NULL, (GDestroyNotify) g_hash_table_destroy);
+
+    for (xmlNode *node_state = pcmk__xe_first_child(status,
+                                                    PCMK__XE_NODE_STATE, NULL,
+                                                    NULL);
+         node_state != NULL;
+         node_state = pcmk__xe_next(node_state, PCMK__XE_NODE_STATE)) {
+
+        const char *node_name = pcmk__xe_get(node_state, PCMK_XA_UNAME);
+        GHashTable *node_history = NULL;
+
+        if (node_name == NULL) {
+            continue;
+        }
+
+        node_history = g_hash_table_lookup(scheduler->priv->history_index,
+                                           node_name);
+        if (node_history == NULL) {
+            node_history = pcmk__strkey_table(NULL,
+                                              (GDestroyNotify) g_list_free);
+            g_hash_table_insert(scheduler->priv->history_index,
+                                (gpointer) node_name, node_history);
+        }
+        index_node_history(node_history, node_state);
+    }
+}
+
+/*!
+ * \internal
+ * \brief Get all history elements for a resource on a node
+ *
+ * \param[in]     rsc_id     ID of resource to check
+ * \param[in]     node_name  Name of node to check
+ * \param[in,out] scheduler  Scheduler data
+ *
+ * \return List of \c PCMK__XE_LRM_RESOURCE elements for \p rsc_id on
+ *         \p node_name (normally at most one)
+ */
+static const GList *
+lrm_resource_entries(const char *rsc_id, const char *node_name,
+                     pcmk_scheduler_t *scheduler)
+{
+    GHashTable *node_history = NULL;
+
+    if (scheduler->priv->history_index == NULL) {
+        index_resource_history(scheduler);
+    }
+
+    node_history = g_hash_table_lookup(scheduler->priv->history_index,
+                                       node_name);
+    if (node_history == NULL) {
+        return NULL;
+    }
+    return g_hash_table_lookup(node_history, rsc_id);
+}
+
+/*!
+ * \internal
+ * \brief Check whether a history entry matches an operation search
+ *
+ * \param[in] xml_op  History entry to check
+ * \param[in] op      Operation name to match
+ * \param[in] source  If not \c NULL, migration node to match (see
+ *                    \c find_lrm_op())
+ *
+ * \return true if \p xml_op matches, otherwise false
+ */
+static bool
+lrm_op_matches(const xmlNode *xml_op, const char *op, const char *source)
+{
+    if (!pcmk__str_eq(pcmk__xe_get(xml_op, PCMK_XA_OPERATION), op,
+                      pcmk__str_none)) {
+        return false;
+    }
+
+    /* Need to check against transition_magic too? */
+    if ((source != NULL) && (strcmp(op, PCMK_ACTION_MIGRATE_TO) == 0)) {
+        return pcmk__str_eq(pcmk__xe_get(xml_op, PCMK__META_MIGRATE_TARGET),
+                            source, pcmk__str_none);
+    }
+    if ((source != NULL) && (strcmp(op, PCMK_ACTION_MIGRATE_FROM) == 0)) {
+        return pcmk__str_eq(pcmk__xe_get(xml_op, PCMK__META_MIGRATE_SOURCE),
+                            source, pcmk__str_none);
+    }
+    return true;
+}
 
 static xmlNode *
 find_lrm_op(const char *resource, const char *op, const char *node, const char *source,
             int target_rc, pcmk_scheduler_t *scheduler)
 {
-    GString *xpath = NULL;
     xmlNode *xml = NULL;
 
     CRM_CHECK((resource != NULL) && (op != NULL) && (node != NULL),
               return NULL);
 
-    xpath = g_string_sized_new(256);
-    pcmk__g_strcat(xpath,
-                   XPATH_NODE_STATE "[@" PCMK_XA_UNAME "='", node, "']"
-                   SUB_XPATH_LRM_RESOURCE "[@" PCMK_XA_ID "='", resource, "']"
-                   SUB_XPATH_LRM_RSC_OP "[@" PCMK_XA_OPERATION "='", op, "'",
-                   NULL);
+    for (const GList *iter = lrm_resource_entries(resource, node, scheduler);
+         iter != NULL; iter = iter->next) {
 
-    /* Need to check against transition_magic too? */
-    if ((source != NULL) && (strcmp(op, PCMK_ACTION_MIGRATE_TO) == 0)) {
-        pcmk__g_strcat(xpath,
-                       " and @" PCMK__META_MIGRATE_TARGET "='", source, "']",
-                       NULL);
-
-    } else if ((source != NULL)
-               && (strcmp(op, PCMK_ACTION_MIGRATE_FROM) == 0)) {
-        pcmk__g_strcat(xpath,
-                       " and @" PCMK__META_MIGRATE_SOURCE "='", source, "']",
-                       NULL);
-    } else {
-        g_string_append_c(xpath, ']');
-    }
+        for (xmlNode *xml_op = pcmk__xe_first_child(iter->data,
+                                                    PCMK__XE_LRM_RSC_OP, NULL,
+                                                    NULL);
+             xml_op != NULL;
+             xml_op = pcmk__xe_next(xml_op, PCMK__XE_LRM_RSC_OP)) {
 
-    xml = pcmk__xpath_find_one(scheduler->input->doc, xpath->str, LOG_DEBUG);
-    g_string_free(xpath, TRUE);
+            if (!lrm_op_matches(xml_op, op, source)) {
+                continue;
+            }
+            if (xml != NULL) {
+                pcmk__debug("Multiple %s history entries for %s on %s",
+                            op, resource, node);
+                return NULL;
+            }
+            xml = xml_op;
+        }
+    }
 
     if (xml && target_rc >= 0) {
         int rc = PCMK_OCF_UNKNOWN_ERROR;
@@ -3073,21 +3277,20 @@ static xmlNode *
 find_lrm_resource(const char *rsc_id, const char *node_name,
                   pcmk_scheduler_t *scheduler)
 {
-    GString *xpath = NULL;
-    xmlNode *xml = NULL;
+    const GList *entries = NULL;
 
     CRM_CHECK((rsc_id != NULL) && (node_name != NULL), return NULL);
 
-    xpath = g_string_sized_new(256);
-    pcmk__g_strcat(xpath,
-                   XPATH_NODE_STATE "[@" PCMK_XA_UNAME "='", node_name, "']"
-                   SUB_XPATH_LRM_RESOURCE "[@" PCMK_XA_ID "='", rsc_id, "']",
-                   NULL);
-
-    xml = pcmk__xpath_find_one(scheduler->input->doc, xpath->str, LOG_DEBUG);
-
-    g_string_free(xpath, TRUE);
-    return xml;
+    entries = lrm_resource_entries(rsc_id, node_name, scheduler);
+    if (entries == NULL) {
+        return NULL;
+    }
+    if (entries->next != NULL) {
+        pcmk__debug("Multiple history entries for %s on %s",
+                    rsc_id, node_name);
+        return NULL;
+    }
+    return entries->data;
 }
 
 /*!
@@ -3102,22 +3305,29 @@ find_lrm_resource(const char *rsc_id, const char *node_name,
 static bool
 unknown_on_node(pcmk_resource_t *rsc, const char *node_name)
 {
-    bool result = false;
-    xmlXPathObject *search;
-    char *xpath = NULL;
-
-    xpath = pcmk__assert_asprintf(XPATH_NODE_STATE "[@" PCMK_XA_UNAME "='%s']"
-                                  SUB_XPATH_LRM_RESOURCE
-                                  "[@" PCMK_XA_ID "='%s']"
-                                  SUB_XPATH_LRM_RSC_OP
-                                  "[@" PCMK__XA_RC_CODE "!='%d']",
-                                  node_name, rsc->id, PCMK_OCF_UNKNOWN);
-
-    search = pcmk__xpath_search(rsc->priv->scheduler->input->doc, xpath);
-    result = (pcmk__xpath_num_results(search) == 0);
-    xmlXPathFreeObject(search);
-    free(xpath);
-    return result;
+    for (const GList *iter = lrm_resource_entries(rsc->id, node_name,
+                                                  rsc->priv->scheduler);
+         iter != NULL; iter = iter->next) {
+
+        for (xmlNode *xml_op = pcmk__xe_first_child(iter->data,
+                                                    PCMK__XE_LRM_RSC_OP, NULL,
+                                                    NULL);
+             xml_op != NULL;
+             xml_op = pcmk__xe_next(xml_op, PCMK__XE_LRM_RSC_OP)) {
+
+            int rc = PCMK_OCF_UNKNOWN;
+
+            if (pcmk__xe_get(xml_op, PCMK__XA_RC_CODE) == NULL) {
+                continue;
+            }
+            if ((pcmk__xe_get_int(xml_op, PCMK__XA_RC_CODE,
+                                  &rc) != pcmk_rc_ok)
+                || (rc != PCMK_OCF_UNKNOWN)) {
+                return false;
+            }
+        }
+    }
+    return true;
 }
 
 /*!
@@ -140,21 +140,20 @@ pe_can_fence(const pcmk_scheduler_t *scheduler, const pcmk_node_t *node)
 pcmk_node_t *
 pe__copy_node(const pcmk_node_t *this_node)
 {
-    pcmk_node_t *new_node = NULL;
+    pcmk__node_copy_t *copy = NULL;
 
     pcmk__assert(this_node != NULL);
 
-    new_node = pcmk__assert_alloc(1, sizeof(pcmk_node_t));
-    new_node->assign = pcmk__assert_alloc(1,
-                                          sizeof(struct pcmk__node_assignment));
+    copy = pcmk__assert_alloc(1, sizeof(pcmk__node_copy_t));
 
-    new_node->assign->probe_mode = this_node->assign->probe_mode;
-    new_node->assign->score = this_node->assign->score;
-    new_node->assign->count = this_node->assign->count;
-    new_node->details = this_node->details;
-    new_node->priv = this_node->priv;
+    copy->assign.probe_mode = this_node->assign->probe_mode;
+    copy->assign.score = this_node->assign->score;
+    copy->assign.count = this_node->assign->count;
+    copy->node.assign = &(copy->assign);
+    copy->node.details = this_node->details;
+    copy->node.priv = this_node->priv;
 
-    return new_node;
+    return &(copy->node);
 }
 
 /*!